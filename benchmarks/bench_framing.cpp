@@ -0,0 +1,219 @@
+// This program measures the per-packet cost of decoding WebSocket Streaming Protocol packets for
+// each protocol variant (WebSocket framing with little-endian headers, and the legacy direct TCP
+// protocol with big-endian headers). It reports two figures for each variant:
+//
+//   - header decode: the cost of decoding packet headers alone, comparing the batch scanner used
+//     by the peer's receive loops with one-at-a-time decoding using the byte-order-specific
+//     decoder and the decoder that selects the byte order at run time;
+//
+//   - receive path: the cost of receiving packets through a detail::peer object over a connected
+//     socket pair, including framing, header decoding and raising the on_data_received signal.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/endian/conversion.hpp>
+
+#include <ws-streaming/detail/framing.hpp>
+#include <ws-streaming/detail/peer.hpp>
+#include <ws-streaming/detail/streaming_protocol.hpp>
+#include <ws-streaming/detail/websocket_protocol.hpp>
+
+using namespace wss::detail;
+
+// The header decode benchmark repeatedly decodes a stream small enough to stay in cache, so that
+// it measures decoding rather than memory bandwidth.
+constexpr std::size_t DECODE_PACKET_COUNT = 16 * 1024;
+constexpr std::size_t DECODE_REPETITIONS = 256;
+
+constexpr std::size_t RECEIVE_PACKET_COUNT = 4 * 1000 * 1000;
+
+// Builds a byte stream containing small data packets, framed as the specified protocol variant
+// would frame them.
+template <typename Framing>
+std::vector<std::uint8_t> build_stream(std::size_t packet_count, bool with_websocket_frames)
+{
+    std::vector<std::uint8_t> stream;
+    std::array<std::uint8_t, 8 * sizeof(double)> payload { };
+
+    for (std::size_t i = 0; i < packet_count; ++i)
+    {
+        std::size_t payload_size = 8 * (1 + i % 8);
+
+        std::array<std::uint8_t, streaming_protocol::MAX_HEADER_SIZE> header;
+        std::size_t header_size = streaming_protocol::generate_header<Framing::byte_order>(
+            header.data(), 1 + i % 16, streaming_protocol::packet_type::DATA, payload_size);
+
+        if (with_websocket_frames && Framing::is_websocket)
+        {
+            std::array<std::uint8_t, websocket_protocol::MAX_HEADER_SIZE> ws_header;
+            std::size_t ws_header_size = websocket_protocol::generate_header(
+                ws_header.data(),
+                websocket_protocol::opcodes::BINARY,
+                websocket_protocol::flags::FIN,
+                header_size + payload_size);
+            stream.insert(stream.end(), ws_header.begin(), ws_header.begin() + ws_header_size);
+        }
+
+        stream.insert(stream.end(), header.begin(), header.begin() + header_size);
+        stream.insert(stream.end(), payload.begin(), payload.begin() + payload_size);
+    }
+
+    return stream;
+}
+
+template <typename Decode>
+double time_header_decode(const std::vector<std::uint8_t>& stream, Decode&& decode)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::size_t packets = 0;
+    unsigned checksum = 0;
+
+    for (std::size_t i = 0; i < DECODE_REPETITIONS; ++i)
+    {
+        std::size_t offset = 0;
+
+        while (true)
+        {
+            auto header = decode(stream.data() + offset, stream.size() - offset);
+            if (!header.header_size)
+                break;
+
+            checksum += header.signo;
+            offset += header.header_size + header.payload_size;
+            ++packets;
+        }
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    if (packets != DECODE_PACKET_COUNT * DECODE_REPETITIONS)
+        std::cerr << "decoded " << packets << " packets (checksum " << checksum << ")" << std::endl;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / packets;
+}
+
+template <boost::endian::order Order>
+double time_header_scan(const std::vector<std::uint8_t>& stream)
+{
+    std::array<streaming_protocol::packet_descriptor, 256> descriptors;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::size_t packets = 0;
+    unsigned checksum = 0;
+
+    for (std::size_t i = 0; i < DECODE_REPETITIONS; ++i)
+    {
+        std::size_t offset = 0;
+
+        while (true)
+        {
+            auto scan = streaming_protocol::scan_packets<Order>(
+                stream.data() + offset,
+                stream.size() - offset,
+                descriptors.data(),
+                descriptors.size());
+            if (!scan.packet_count)
+                break;
+
+            for (std::size_t j = 0; j < scan.packet_count; ++j)
+                checksum += descriptors[j].signo;
+
+            offset += scan.bytes_scanned;
+            packets += scan.packet_count;
+        }
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    if (packets != DECODE_PACKET_COUNT * DECODE_REPETITIONS)
+        std::cerr << "scanned " << packets << " packets (checksum " << checksum << ")" << std::endl;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / packets;
+}
+
+template <typename Framing>
+void bench_header_decode(const char *name)
+{
+    auto stream = build_stream<Framing>(DECODE_PACKET_COUNT, false);
+    bool use_tcp_protocol = !Framing::is_websocket;
+
+    double specialized = time_header_decode(stream, [](const std::uint8_t *data, std::size_t size)
+    {
+        return streaming_protocol::decode_header<Framing::byte_order>(data, size);
+    });
+
+    double runtime = time_header_decode(stream, [&](const std::uint8_t *data, std::size_t size)
+    {
+        return streaming_protocol::decode_header(data, size, use_tcp_protocol);
+    });
+
+    double scanned = time_header_scan<Framing::byte_order>(stream);
+
+    std::cout << name << " header decode: "
+        << scanned << " ns/packet (batch scan), "
+        << specialized << " ns/packet (specialized), "
+        << runtime << " ns/packet (run-time selected)" << std::endl;
+}
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+template <typename Framing>
+void bench_receive_path(const char *name)
+{
+    auto stream = build_stream<Framing>(RECEIVE_PACKET_COUNT, true);
+
+    boost::asio::io_context ioc{1};
+    boost::asio::local::stream_protocol::socket reader{ioc};
+    boost::asio::local::stream_protocol::socket writer{ioc};
+    boost::asio::local::connect_pair(reader, writer);
+
+    auto p = std::make_shared<peer>(
+        std::move(reader),
+        false,
+        !Framing::is_websocket);
+
+    std::size_t packets = 0;
+    p->on_data_received.connect([&](unsigned signo, const std::uint8_t *data, std::size_t size)
+    {
+        if (++packets == RECEIVE_PACKET_COUNT)
+            p->stop();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread writer_thread{[&]
+    {
+        boost::system::error_code ec;
+        boost::asio::write(writer, boost::asio::buffer(stream), ec);
+    }};
+
+    p->run();
+    ioc.run();
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    writer_thread.join();
+
+    std::cout << name << " receive path: "
+        << std::chrono::duration<double, std::nano>(elapsed).count() / packets
+        << " ns/packet" << std::endl;
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    bench_header_decode<websocket_framing>("websocket");
+    bench_header_decode<raw_framing>("tcp");
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    bench_receive_path<websocket_framing>("websocket");
+    bench_receive_path<raw_framing>("tcp");
+#endif
+}
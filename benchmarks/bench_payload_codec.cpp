@@ -0,0 +1,98 @@
+// This program measures the lossless payload encodings (see wss::encodings) on synthetic data
+// resembling typical measurement signals. For each encoding it reports the compression ratio
+// (raw size divided by encoded size) and the encode and decode throughput in terms of raw data:
+//
+//   - timestamps: 64-bit explicit timestamps with a constant period and a little jitter,
+//     encoded as delta-of-delta;
+//
+//   - adc: 32-bit integer samples of a slowly varying waveform with a few bits of noise,
+//     encoded as delta;
+//
+//   - quantized: 64-bit floating-point samples of a slowly varying, quantized waveform,
+//     encoded as XOR.
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/encodings.hpp>
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/detail/payload_codec.hpp>
+
+using namespace wss::detail;
+
+// Each packet is small enough to stay in cache, so that the benchmark measures the codec rather
+// than memory bandwidth.
+constexpr std::size_t SAMPLE_COUNT = 64 * 1024;
+constexpr std::size_t REPETITIONS = 256;
+
+template <typename T>
+static void store(std::vector<std::uint8_t>& data, std::size_t index, T value)
+{
+    std::memcpy(&data[index * sizeof(T)], &value, sizeof(T));
+}
+
+static void bench_codec(
+    const char *name,
+    const char *data_type,
+    const char *encoding,
+    const std::vector<std::uint8_t>& data)
+{
+    payload_codec codec{wss::metadata{
+        wss::metadata_builder{"Value"}
+            .data_type(data_type)
+            .encoding(encoding)
+            .build()}};
+
+    std::vector<std::uint8_t> encoded, decoded;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < REPETITIONS; ++i)
+        codec.encode(data.data(), data.size(), encoded);
+
+    auto encoded_at = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < REPETITIONS; ++i)
+        codec.decode(encoded.data(), encoded.size(), decoded);
+
+    auto decoded_at = std::chrono::steady_clock::now();
+
+    if (decoded != data)
+        std::cerr << name << ": decoded data does not match" << std::endl;
+
+    double megabytes = data.size() * REPETITIONS / 1e6;
+
+    std::cout << name << " (" << encoding << "): "
+        << static_cast<double>(data.size()) / encoded.size() << "x, "
+        << megabytes / std::chrono::duration<double>(encoded_at - start).count()
+        << " MB/s encode, "
+        << megabytes / std::chrono::duration<double>(decoded_at - encoded_at).count()
+        << " MB/s decode" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::uint8_t> timestamps(SAMPLE_COUNT * sizeof(std::uint64_t));
+    std::vector<std::uint8_t> adc(SAMPLE_COUNT * sizeof(std::int32_t));
+    std::vector<std::uint8_t> quantized(SAMPLE_COUNT * sizeof(double));
+
+    for (std::size_t i = 0; i < SAMPLE_COUNT; ++i)
+    {
+        std::uint32_t noise = static_cast<std::uint32_t>(i * 2654435761u) >> 28;
+
+        store<std::uint64_t>(timestamps, i, 1'700'000'000'000'000ull + i * 10'000 + noise % 4);
+        store<std::int32_t>(adc, i, static_cast<std::int32_t>(std::sin(i / 300.0) * 20'000) + noise);
+        store<double>(quantized, i, std::round(std::sin(i / 1000.0) * 1000) / 16);
+    }
+
+    bench_codec("timestamps", wss::data_types::uint64_t, wss::encodings::delta_of_delta, timestamps);
+    bench_codec("adc", wss::data_types::int32_t, wss::encodings::delta, adc);
+    bench_codec("quantized", wss::data_types::real64_t, wss::encodings::xor_float, quantized);
+}
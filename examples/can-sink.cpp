@@ -9,6 +9,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/asio.hpp>
 
@@ -21,6 +22,8 @@ struct signal_state
     wss::connection_ptr connection;
     wss::remote_signal_ptr value_signal;
     wss::remote_signal_ptr domain_signal;
+    wss::struct_layout layout;
+    std::vector<std::uint32_t> message_ids;
     boost::signals2::scoped_connection on_metadata_changed;
     boost::signals2::scoped_connection on_domain_data;
     boost::signals2::scoped_connection on_value_data;
@@ -62,6 +65,13 @@ void on_metadata_changed(std::shared_ptr<signal_state> state)
 
     state->domain_signal = state->connection->find_remote_signal(domain_signal_id);
 
+    // Compute the layout of the CAN message structure once, rather than interpreting the
+    // metadata each time data is received.
+    state->layout = wss::struct_layout{state->value_signal->metadata()};
+    for (const auto& field : state->layout.fields())
+        std::cout << "field " << field.name << " at offset " << field.offset
+            << ": " << field.count << " x " << field.data_type << std::endl;
+
     if (state->domain_signal)
     {
         std::cout << "got domain signal" << std::endl;
@@ -75,12 +85,25 @@ void on_metadata_changed(std::shared_ptr<signal_state> state)
 }
 
 void on_data_received(
+    std::shared_ptr<signal_state> state,
     std::int64_t domain_value,
     std::size_t sample_count,
     const void *data,
     std::size_t size)
 {
     std::cout << "received " << size << " data byte(s), " << sample_count << " sample(s) with domain value " << domain_value << std::endl;
+
+    // Extract the message IDs of all received messages into a contiguous array.
+    auto field = state->layout.find("ArbId");
+    if (field && state->layout.fields()[*field].size == sizeof(std::uint32_t)
+            && size >= sample_count * state->layout.sample_size())
+    {
+        state->message_ids.resize(sample_count);
+        state->layout.extract(*field, data, sample_count, state->message_ids.data());
+
+        for (auto message_id : state->message_ids)
+            std::cout << "  message ID 0x" << std::hex << message_id << std::dec << std::endl;
+    }
 }
 
 void on_available(
@@ -99,7 +122,8 @@ void on_available(
 
         state->on_metadata_changed = signal->on_metadata_changed.connect(
             std::bind(on_metadata_changed, state));
-        state->on_value_data = signal->on_data_received.connect(on_data_received);
+        state->on_value_data = signal->on_data_received.connect(
+            std::bind(on_data_received, state, _1, _2, _3, _4));
         state->on_unavailable = signal->on_unavailable.connect(
             std::bind(on_unavailable, state));
 
@@ -22,35 +22,23 @@ using namespace std::chrono_literals;
 
 int main(int argc, char *argv[])
 {
-    // Declare our explicit-rule domain (time) signal.
-    wss::local_signal time_signal{
+    // Declare our explicit-rule domain (time) signal. The data type is derived from the sample
+    // type, std::uint64_t.
+    wss::typed_local_signal<std::uint64_t> time_signal{
         "/Time",
         wss::metadata_builder{"Time"}
-            .data_type(wss::data_types::uint64_t)
             .unit(wss::unit::nanoseconds)
             .origin(wss::metadata::unix_epoch)
-            .table("/Time")
-            .build()};
+            .table("/Time")};
 
-    // Declare our explicit-rule, struct-valued CAN signal.
-    wss::local_signal can_signal{
+    // Declare our explicit-rule, struct-valued CAN signal. The structure definition is derived
+    // from the wss::sample_traits specialization in can_message.hpp.
+    wss::typed_local_signal<can_message> can_signal{
         "/CAN",
         wss::metadata_builder{"CAN"}
-            .data_type(wss::data_types::struct_t)
-            .struct_field(
-                wss::struct_field_builder("ArbId")
-                    .data_type(wss::data_types::int32_t))
-            .struct_field(
-                wss::struct_field_builder("Length")
-                    .data_type(wss::data_types::int8_t))
-            .struct_field(
-                wss::struct_field_builder("Data")
-                    .data_type(wss::data_types::uint8_t)
-                    .array(64))
             .unit(wss::unit::volts)
             .range(-10, 10)
-            .table(time_signal.id())
-            .build()};
+            .table(time_signal.id())};
 
     // Set up a single-threaded Boost.Asio execution context.
     boost::asio::io_context ioc{1};
@@ -80,6 +68,7 @@ int main(int argc, char *argv[])
         auto when = system_clock::now();
         std::uniform_int_distribution<unsigned> uniform(50, 500);
         can_message message { };
+        wss::publish_group group;
 
         message.message_id = 0x1234;
         message.payload_length = 10;
@@ -91,9 +80,13 @@ int main(int argc, char *argv[])
             when += std::chrono::milliseconds(mss);
             std::this_thread::sleep_until(when);
 
-            auto time = duration_cast<duration<std::uint64_t, std::nano>>(when.time_since_epoch());
-            time_signal.publish_data(&time, sizeof(time));
-            can_signal.publish_data(&message, sizeof(message));
+            // Publish the timestamp and the message together, so that clients receive both in
+            // a single transmission and never observe one without the other.
+            std::uint64_t time = duration_cast<duration<std::uint64_t, std::nano>>(
+                when.time_since_epoch()).count();
+            group.add(time_signal, time);
+            group.add(can_signal, message);
+            group.publish();
         }
     }};
 
@@ -2,6 +2,9 @@
 
 #include <array>
 #include <cstdint>
+#include <tuple>
+
+#include <ws-streaming/sample_traits.hpp>
 
 #pragma pack(push, 1)
 struct can_message
@@ -11,3 +14,13 @@ struct can_message
     std::array<std::uint8_t, 64> payload;
 };
 #pragma pack(pop)
+
+// Describe the layout of can_message so that it can be used with wss::typed_local_signal.
+template <>
+struct wss::sample_traits<can_message>
+{
+    static constexpr auto fields = std::make_tuple(
+        wss::field("ArbId", &can_message::message_id),
+        wss::field("Length", &can_message::payload_length),
+        wss::field("Data", &can_message::payload));
+};
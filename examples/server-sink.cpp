@@ -49,8 +49,7 @@ void on_available(
     wss::remote_signal_ptr signal)
 {
     std::cout << "signal available from "
-        << connection->socket().remote_endpoint().address()
-        << ':' << connection->socket().remote_endpoint().port()
+        << connection->local_stream_id()
         << ": " << signal->id() << std::endl;
 
     // Subscribe to the signal if its ID is "/Value".
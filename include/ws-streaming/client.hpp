@@ -11,8 +11,10 @@
 #include <boost/system/error_code.hpp>
 
 #include <ws-streaming/connection.hpp>
+#include <ws-streaming/detail/deflate_pool.hpp>
 #include <ws-streaming/detail/http_client.hpp>
 #include <ws-streaming/detail/url.hpp>
+#include <ws-streaming/detail/websocket_extensions.hpp>
 
 namespace wss
 {
@@ -43,11 +45,20 @@ namespace wss
              */
             client(boost::asio::any_io_executor executor);
 
+            /**
+             * The URL scheme prefix used to connect to a server listening on a UNIX domain
+             * socket. The remainder of the URL is the filesystem path of the socket; for
+             * example, `ws+unix:///run/ws-streaming.sock`.
+             */
+            static constexpr std::string_view unix_scheme_prefix = "ws+unix://";
+
             /**
              * Asynchronously connects to a remote server. An HTTP GET request is made to
              * establish the WebSocket connection.
              *
-             * @param url The WebSocket URL of the remote server.
+             * @param url The WebSocket URL of the remote server. On platforms that support UNIX
+             *     domain sockets, a URL beginning with unix_scheme_prefix connects to a server
+             *     listening on the specified socket path; see server::add_local_listener().
              * @param handler A completion handler to call when the operation is complete. This
              *     handler receives either a nonzero error code, or a std::shared_ptr holding a
              *     constructed @ref connection object on which connection::run() has been called.
@@ -73,10 +84,49 @@ namespace wss
              */
             void cancel();
 
+            /**
+             * Enables or disables offering block compression (see detail::websocket_extensions)
+             * in future WebSocket connection attempts. Block compression is offered by default,
+             * but only used if the server has enabled it. It is adaptive, so that connections
+             * carrying incompressible data spend almost no time compressing it. It is not
+             * available with the legacy TCP protocol.
+             *
+             * @param enable True to offer block compression, or false not to.
+             */
+            void set_block_compression(bool enable) { _extensions.block_compression = enable; }
+
+            /**
+             * Enables or disables offering per-message deflate (see RFC 7692) in future
+             * WebSocket connection attempts. This allows compression with third-party servers
+             * that do not support block compression. Servers that support both use block
+             * compression for what they transmit. Per-message deflate is not offered by default.
+             *
+             * @param enable True to offer per-message deflate, or false not to.
+             * @param context_takeover True to allow both peers to keep their compression context
+             *     from one message to the next, or false to ask both to compress each message
+             *     independently, which uses less memory.
+             */
+            void set_permessage_deflate(bool enable, bool context_takeover = true)
+            {
+                _extensions.permessage_deflate = enable;
+                _extensions.server_no_context_takeover = !context_takeover;
+                _extensions.client_no_context_takeover = !context_takeover;
+            }
+
         private:
 
+            static detail::http_client::handler_type make_upgrade_handler(
+                const detail::websocket_extensions& offered,
+                std::shared_ptr<detail::deflate_pool> deflate_pool,
+                std::function<
+                    void(
+                        const boost::system::error_code& ec,
+                        wss::connection_ptr connection)
+                > handler);
+
             boost::beast::http::request<boost::beast::http::string_body> create_request(
-                const detail::url& url);
+                const std::string& host,
+                std::string path);
 
             std::string get_random_key();
 
@@ -84,5 +134,7 @@ namespace wss
 
             std::shared_ptr<detail::http_client> _http_client;
             boost::asio::any_io_executor _executor;
+            detail::websocket_extensions _extensions{true};
+            std::shared_ptr<detail::deflate_pool> _deflate_pool = std::make_shared<detail::deflate_pool>();
     };
 }
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
-#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/signals2/connection.hpp>
 #include <boost/signals2/signal.hpp>
 #include <boost/system/error_code.hpp>
@@ -17,12 +21,16 @@
 #include <ws-streaming/metadata.hpp>
 #include <ws-streaming/remote_signal.hpp>
 #include <ws-streaming/detail/command_interface_client.hpp>
+#include <ws-streaming/detail/decimated_signal.hpp>
+#include <ws-streaming/detail/reduced_signal.hpp>
+#include <ws-streaming/detail/deflate_pool.hpp>
 #include <ws-streaming/detail/local_signal_container.hpp>
 #include <ws-streaming/detail/peer.hpp>
 #include <ws-streaming/detail/registered_local_signal.hpp>
 #include <ws-streaming/detail/remote_signal_container.hpp>
 #include <ws-streaming/detail/remote_signal_impl.hpp>
 #include <ws-streaming/detail/semver.hpp>
+#include <ws-streaming/detail/websocket_extensions.hpp>
 
 namespace wss
 {
@@ -37,9 +45,11 @@ namespace wss
         public:
 
             /**
-             * Constructs a connection object from a TCP socket. The socket must already have been
-             * connected to the remote peer, including the HTTP WebSocket upgrade request and
-             * response, if necessary.
+             * Constructs a connection object from a stream socket. The socket must already have
+             * been connected to the remote peer, including the HTTP WebSocket upgrade request and
+             * response, if necessary. Any stream socket type can be used, such as a TCP socket or
+             * a UNIX domain socket; sockets of specific protocols are implicitly converted to
+             * protocol-independent sockets.
              *
              * Do not directly construct a connection object. Connection instances must always be
              * managed by a std::shared_ptr; therefore, std::make_shared() should be used.
@@ -47,7 +57,7 @@ namespace wss
              * After construction, the run() function must be called to register asynchronous
              * operations with the Boost.Asio execution context.
              *
-             * @param socket A connected TCP socket. The constructed object takes ownership of the
+             * @param socket A connected stream socket. The constructed object takes ownership of the
              *     socket. The socket's execution context is used for all asynchronous I/O
              *     operations.
              * @param is_client True if the connection should behave as a client. The WebSocket
@@ -58,11 +68,18 @@ namespace wss
              *     symmetric connections.
              * @param use_tcp_protocol True to use the direct TCP protocol instead of a WebSocket
              *     connection.
+             * @param extensions The WebSocket extensions agreed on in the HTTP upgrade handshake,
+             *     if any.
+             * @param deflate_pool The pool from which to acquire per-message deflate
+             *     compressors, if that extension was agreed on. If null, the connection uses a
+             *     private pool with a single compressor.
              */
             connection(
-                boost::asio::ip::tcp::socket&& socket,
+                boost::asio::generic::stream_protocol::socket&& socket,
                 bool is_client,
-                bool use_tcp_protocol = false);
+                bool use_tcp_protocol = false,
+                const detail::websocket_extensions& extensions = {},
+                std::shared_ptr<detail::deflate_pool> deflate_pool = nullptr);
 
             /**
              * Destroys a connection object.
@@ -160,7 +177,7 @@ namespace wss
              *
              * @return The Boost.Asio socket underlying the connection.
              */
-            const boost::asio::ip::tcp::socket& socket() const noexcept;
+            const boost::asio::generic::stream_protocol::socket& socket() const noexcept;
 
             /**
              * Gets the local stream ID. This is the stream ID that this connection has generated
@@ -244,12 +261,28 @@ namespace wss
             void on_local_signal_metadata_changed(
                 detail::registered_local_signal& signal);
 
+            nlohmann::json transmitted_metadata(
+                detail::registered_local_signal& signal);
+
+            void on_local_signal_data_published_live(
+                const std::shared_ptr<detail::registered_local_signal>& signal,
+                std::int64_t domain_value,
+                std::size_t sample_count,
+                const boost::asio::const_buffer *buffers,
+                std::size_t buffer_count,
+                const std::shared_ptr<const void>& owner);
+
             void on_local_signal_data_published(
-                std::shared_ptr<detail::registered_local_signal> signal,
+                const std::shared_ptr<detail::registered_local_signal>& signal,
                 std::int64_t domain_value,
                 std::size_t sample_count,
-                const void *data,
-                std::size_t size);
+                const boost::asio::const_buffer *buffers,
+                std::size_t buffer_count,
+                const std::shared_ptr<const void>& owner);
+
+            void do_wait_broadcast();
+            void finish_wait_broadcast(const boost::system::error_code& ec);
+            void drain_broadcast_ring(const std::shared_ptr<detail::registered_local_signal>& signal);
 
             void on_signal_subscribe_requested(const std::string& signal_id);
             void on_signal_unsubscribe_requested(const std::string& signal_id);
@@ -275,6 +308,14 @@ namespace wss
             bool subscribe(const std::string& signal_id, bool is_explicit);
             bool unsubscribe(const std::string& signal_id, bool is_explicit);
 
+            std::string subscribe_derived(const nlohmann::json& params);
+            std::string subscribe_decimated(const nlohmann::json& params);
+            std::string subscribe_reduced(const nlohmann::json& params);
+            void remove_decimated_signals(local_signal& source);
+            void remove_reduced_signals(local_signal& source);
+            void remove_derived_signal(const std::string& signal_id);
+            void remove_unused_decimated_domains();
+
         private:
 
             bool _is_client;
@@ -290,8 +331,26 @@ namespace wss
             boost::signals2::scoped_connection _on_peer_closed;
 
             bool _hello_sent = false;
+            bool _peer_supports_encodings = false;
+
+            boost::asio::steady_timer _broadcast_timer;
+            bool _waiting_broadcast = false;
+            std::vector<std::uint8_t> _broadcast_data;
+
+            static constexpr std::chrono::milliseconds BROADCAST_POLL_INTERVAL{1};
+            static constexpr std::int64_t MAX_DECIMATION = 1000000;
+            static constexpr std::size_t ENCODE_BUFFER_SIZE = 64 * 1024;
 
             nlohmann::json _command_interfaces = nlohmann::json::object();
+
+            // Signals created on behalf of the peer by subscribe requests with decimation
+            // parameters, and their linear-rule domain signals, keyed by signal ID.
+            std::map<std::string, std::unique_ptr<detail::decimated_signal>> _decimated_signals;
+            std::map<std::string, std::unique_ptr<local_signal>> _decimated_domains;
+
+            // Reduced-precision signals requested by the peer, keyed by signal ID. These are
+            // shared with other connections requesting the same format of the same source.
+            std::map<std::string, std::shared_ptr<detail::reduced_signal>> _reduced_signals;
     };
 
     /**
@@ -17,6 +17,7 @@ namespace wss
         static constexpr const char *uint16_t = "uint16";   /**< Signals are 16-bit unsigned integers. */
         static constexpr const char *uint32_t = "uint32";   /**< Signals are 32-bit unsigned integers. */
         static constexpr const char *uint64_t = "uint64";   /**< Signals are 64-bit unsigned integers. */
+        static constexpr const char *real16_t = "real16";   /**< Signals are IEEE 754 half-precision floating-point numbers (a library extension). */
         static constexpr const char *real32_t = "real32";   /**< Signals are 32-bit floating-point numbers. */
         static constexpr const char *real64_t = "real64";   /**< Signals are 64-bit floating-point numbers. */
         static constexpr const char *struct_t = "struct";   /**< Signals are structure-valued. */
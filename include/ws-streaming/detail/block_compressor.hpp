@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wss::detail
+{
+    /**
+     * Compresses blocks of outgoing WebSocket frames for connections that have negotiated the
+     * block compression extension (see websocket_extensions). Blocks are compressed with a fast
+     * LZ77 compressor that produces the LZ4 block format, preceded by the uncompressed size as
+     * a 32-bit little-endian integer.
+     *
+     * Compression is adaptive. Each block is only worth transmitting compressed if it saves at
+     * least 1/MIN_SAVINGS_DIVISOR of its size, and at least one byte for every
+     * MAX_NANOSECONDS_PER_SAVED_BYTE nanoseconds spent compressing it. After a block that is not
+     * worth compressing, compression is skipped for a number of subsequent blocks, which doubles
+     * (up to MAX_SKIPPED_BLOCKS) each time the next attempt fails too, so that connections
+     * carrying incompressible data spend almost no time compressing it.
+     */
+    class block_compressor
+    {
+        public:
+
+            /**
+             * The largest uncompressed block size. Senders must not compress larger blocks, and
+             * receivers reject them.
+             */
+            static constexpr std::size_t MAX_BLOCK_SIZE = 256 * 1024;
+
+            /**
+             * The minimum fraction (as a divisor) of a block's size that compression must save.
+             */
+            static constexpr std::size_t MIN_SAVINGS_DIVISOR = 8;
+
+            /**
+             * The maximum CPU time that compression may cost per byte saved. At this rate,
+             * compression saves 20 MB/s; links slower than that benefit from it.
+             */
+            static constexpr std::chrono::nanoseconds MAX_NANOSECONDS_PER_SAVED_BYTE{50};
+
+            /**
+             * The maximum number of blocks skipped after a block that was not worth compressing.
+             */
+            static constexpr unsigned MAX_SKIPPED_BLOCKS = 256;
+
+            /**
+             * Constructs a block compressor.
+             */
+            block_compressor();
+
+            /**
+             * Compresses a block, if it is worth compressing.
+             *
+             * @param data A pointer to the block.
+             * @param size The size of the block in bytes. This must not exceed MAX_BLOCK_SIZE.
+             * @param output The vector in which to store the compressed block. Its previous
+             *     contents are discarded.
+             *
+             * @return True if the block should be transmitted compressed, or false if it should
+             *     be transmitted uncompressed (including if compression was skipped).
+             */
+            bool compress(
+                const std::uint8_t *data,
+                std::size_t size,
+                std::vector<std::uint8_t>& output);
+
+            /**
+             * Decompresses a compressed block.
+             *
+             * @param data A pointer to the compressed block.
+             * @param size The size of the compressed block in bytes.
+             * @param output The vector in which to store the decompressed block. Its previous
+             *     contents are discarded.
+             *
+             * @return True if the block was decompressed, or false if it is malformed or larger
+             *     than MAX_BLOCK_SIZE.
+             */
+            static bool decompress(
+                const std::uint8_t *data,
+                std::size_t size,
+                std::vector<std::uint8_t>& output);
+
+        private:
+
+            std::vector<std::uint32_t> _table;
+            unsigned _skip = 0;
+            unsigned _backoff = 0;
+    };
+}
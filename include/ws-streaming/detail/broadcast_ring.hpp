@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+namespace wss::detail
+{
+    /**
+     * A lock-free, single-producer, multiple-consumer broadcast ring of published data records.
+     * The producer appends each record once, in constant time regardless of the number of
+     * consumers. Each consumer reads from its own cursor, at its own pace. The producer never
+     * waits for consumers: if a consumer falls more than the ring's capacity behind, the records
+     * it has not yet read are overwritten, and the consumer detects the overrun on its next
+     * read.
+     *
+     * Records are stored contiguously, prefixed by a record_header, and padded to a multiple of
+     * eight bytes. A record which does not fit before the end of the ring is preceded by a
+     * padding marker, and stored at the start of the ring instead.
+     *
+     * Consumers copy each record out of the ring, then verify that the producer did not begin
+     * overwriting it during the copy, in the manner of a sequence lock.
+     */
+    class broadcast_ring
+    {
+        public:
+
+            /**
+             * Describes a published data record.
+             */
+            struct record_header
+            {
+                std::uint64_t record_size;              /**< The total size of the record, including this header and padding. */
+                std::int64_t domain_value;              /**< The domain value passed to publish_data(). */
+                std::uint64_t sample_count;             /**< The sample count passed to publish_data(). */
+                std::uint64_t sample_index;             /**< The total sample count of all records preceding this one. */
+                std::uint64_t size;                     /**< The size of the record's data in bytes. */
+            };
+
+            /**
+             * Possible results of a call to read().
+             */
+            enum class read_result
+            {
+                record,                                 /**< A record was read. */
+                empty,                                  /**< The consumer has read every record. */
+                overrun,                                /**< Unread records have been overwritten. */
+            };
+
+            /**
+             * Constructs a ring.
+             *
+             * @param capacity The capacity of the ring in bytes. This is rounded up to a multiple
+             *     of eight bytes. Records larger than the capacity (including their header)
+             *     cannot be appended.
+             */
+            explicit broadcast_ring(std::size_t capacity);
+
+            /**
+             * Appends a record to the ring. Only a single thread may call this function at a
+             * time.
+             *
+             * @param domain_value The domain value associated with the data.
+             * @param sample_count The number of samples contained in the data.
+             * @param buffers A pointer to an array of descriptors of the data.
+             * @param buffer_count The number of descriptors pointed to by @p buffers.
+             *
+             * @return True if the record was appended, or false if it is larger than the ring.
+             */
+            bool append(
+                std::int64_t domain_value,
+                std::size_t sample_count,
+                const boost::asio::const_buffer *buffers,
+                std::size_t buffer_count) noexcept;
+
+            /**
+             * Gets the position at which the next record will be appended. A consumer that
+             * starts reading from this position receives only records appended afterward.
+             *
+             * @return The position at which the next record will be appended.
+             */
+            std::uint64_t head() const noexcept;
+
+            /**
+             * Reads the record at a consumer's cursor. Any number of threads may call this
+             * function concurrently with each other and with append().
+             *
+             * @param cursor The consumer's cursor. If a record is read, the cursor is advanced
+             *     past it. If an overrun is detected, the cursor is moved to the current head,
+             *     skipping every overwritten record.
+             * @param header Populated with the record header if a record is read.
+             * @param data Populated with the record's data if a record is read.
+             *
+             * @return The result of the read.
+             */
+            read_result read(
+                std::uint64_t& cursor,
+                record_header& header,
+                std::vector<std::uint8_t>& data) const;
+
+        private:
+
+            static constexpr std::uint64_t PADDING = ~std::uint64_t{0};
+
+            std::vector<std::uint8_t> _buffer;
+
+            // The position up to which the producer has completely written records.
+            std::atomic<std::uint64_t> _head = 0;
+
+            // The position up to which the producer may be writing. Data at positions below
+            // (_reserved - capacity) may have been overwritten.
+            std::atomic<std::uint64_t> _reserved = 0;
+
+            // Producer-only state.
+            std::uint64_t _sample_index = 0;
+    };
+}
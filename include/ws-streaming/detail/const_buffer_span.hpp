@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+#include <boost/asio/buffer.hpp>
+
+namespace wss::detail
+{
+    /**
+     * A non-owning view of an array of Boost.Asio buffer descriptors, which satisfies the
+     * Boost.Asio requirements for a sequence of immutable buffers. This allows an array passed
+     * through a non-template interface, such as local_signal::on_data_published, to be used with
+     * scatter-gather functions such as peer::send_data().
+     */
+    class const_buffer_span
+    {
+        public:
+
+            using value_type = boost::asio::const_buffer;
+            using const_iterator = const boost::asio::const_buffer *;
+
+            /**
+             * Constructs a view of an array of buffer descriptors.
+             *
+             * @param buffers A pointer to the array of buffer descriptors. The array must remain
+             *     valid for the lifetime of this object.
+             * @param count The number of descriptors pointed to by @p buffers.
+             */
+            const_buffer_span(const boost::asio::const_buffer *buffers, std::size_t count) noexcept
+                : _buffers(buffers)
+                , _count(count)
+            {
+            }
+
+            const_iterator begin() const noexcept
+            {
+                return _buffers;
+            }
+
+            const_iterator end() const noexcept
+            {
+                return _buffers + _count;
+            }
+
+        private:
+
+            const boost::asio::const_buffer *_buffers;
+            std::size_t _count;
+    };
+}
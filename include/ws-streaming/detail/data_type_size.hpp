@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <ws-streaming/data_types.hpp>
+
+namespace wss::detail
+{
+    /**
+     * Gets the size of a sample of a primitive data type.
+     *
+     * @param type The data type string. The wss::data_types namespace contains constants for
+     *     the data types specified by the WebSocket Streaming Protocol specification.
+     *
+     * @return The size in bytes of a sample of the specified type, or zero if @p type is not a
+     *     primitive type with a fixed size.
+     */
+    inline std::size_t data_type_size(const std::string& type)
+    {
+        if (type == data_types::int8_t) return sizeof(std::int8_t);
+        if (type == data_types::int16_t) return sizeof(std::int16_t);
+        if (type == data_types::int32_t) return sizeof(std::int32_t);
+        if (type == data_types::int64_t) return sizeof(std::int64_t);
+        if (type == data_types::uint8_t) return sizeof(std::uint8_t);
+        if (type == data_types::uint16_t) return sizeof(std::uint16_t);
+        if (type == data_types::uint32_t) return sizeof(std::uint32_t);
+        if (type == data_types::uint64_t) return sizeof(std::uint64_t);
+        if (type == data_types::real16_t) return 2;
+        if (type == data_types::real32_t) return 4;
+        if (type == data_types::real64_t) return 8;
+
+        return 0;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+#include <boost/asio/buffer.hpp>
+
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/sample_converter.hpp>
+
+namespace wss::detail
+{
+    /**
+     * Decides which published blocks of a slow-moving signal need to be transmitted. A block
+     * is transmitted if any of its samples differs from the most recently transmitted sample
+     * by more than the deadband, or if no block has been transmitted for the heartbeat
+     * interval. Other blocks are suppressed.
+     *
+     * Evaluating a block never allocates memory.
+     */
+    class deadband_filter
+    {
+        public:
+
+            /**
+             * Constructs a filter.
+             *
+             * @param metadata The metadata of the filtered signal, used to interpret samples.
+             * @param absolute The absolute width of the deadband, in the units of the signal's
+             *     raw (not post-scaled) values.
+             * @param relative The width of the deadband relative to the magnitude of the most
+             *     recently transmitted sample. The larger of the absolute and relative widths
+             *     applies.
+             * @param heartbeat The interval after which a block is transmitted regardless of
+             *     its contents, or zero to disable the heartbeat.
+             */
+            deadband_filter(
+                const metadata& metadata,
+                double absolute,
+                double relative,
+                std::chrono::steady_clock::duration heartbeat);
+
+            /**
+             * Updates the metadata used to interpret samples. The next block is transmitted.
+             *
+             * @param metadata The new metadata of the filtered signal.
+             */
+            void update(const metadata& metadata);
+
+            /**
+             * Evaluates a published block. If the block is to be transmitted, its last sample
+             * becomes the reference for subsequent blocks. Blocks of signals whose data type
+             * cannot be interpreted, and blocks containing no complete samples, are always
+             * transmitted.
+             *
+             * @param buffers A pointer to an array of descriptors of the block's data.
+             * @param buffer_count The number of descriptors pointed to by @p buffers.
+             * @param now The current time.
+             *
+             * @return True if the block should be transmitted, or false if it should be
+             *     suppressed.
+             */
+            bool admit(
+                const boost::asio::const_buffer *buffers,
+                std::size_t buffer_count,
+                std::chrono::steady_clock::time_point now) noexcept;
+
+        private:
+
+            sample_converter _converter;
+            double _absolute;
+            double _relative;
+            std::chrono::steady_clock::duration _heartbeat;
+
+            bool _has_reference = false;
+            double _reference = 0;
+            std::chrono::steady_clock::time_point _last_transmitted;
+    };
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/signals2/connection.hpp>
+
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/sample_converter.hpp>
+#include <ws-streaming/detail/envelope_decimator.hpp>
+
+namespace wss::detail
+{
+    /**
+     * A signal, derived from a local signal with a linear-rule domain, whose samples are
+     * min/max/mean envelopes of fixed-size windows of the source signal's samples. Connections
+     * create decimated signals on behalf of remote peers that request them. The source signal
+     * is only observed while the decimated signal is subscribed.
+     */
+    class decimated_signal
+    {
+        public:
+
+            /**
+             * Constructs a decimated signal.
+             *
+             * @param id The global identifier of the decimated signal.
+             * @param source The source signal. The source must outlive this object.
+             * @param domain_id The global identifier of the decimated signal's domain signal,
+             *     whose linear rule has a delta of @p factor times that of the source's domain.
+             * @param domain_delta The linear-rule delta of the source signal's domain.
+             * @param factor The number of source samples per decimated sample.
+             */
+            decimated_signal(
+                const std::string& id,
+                local_signal& source,
+                const std::string& domain_id,
+                std::int64_t domain_delta,
+                std::size_t factor);
+
+            /**
+             * Gets the decimated signal.
+             *
+             * @return A reference to the decimated signal.
+             */
+            local_signal& signal() noexcept;
+
+            /**
+             * Gets the source signal.
+             *
+             * @return A reference to the source signal.
+             */
+            local_signal& source() noexcept;
+
+            /**
+             * Gets the global identifier of the decimated signal's domain signal.
+             *
+             * @return The global identifier of the decimated signal's domain signal.
+             */
+            const std::string& domain_id() const noexcept;
+
+            /**
+             * Generates the metadata of a decimated signal.
+             *
+             * @param source The metadata of the source signal.
+             * @param domain_id The global identifier of the decimated signal's domain signal.
+             *
+             * @return The metadata of the decimated signal.
+             */
+            static metadata make_metadata(
+                const metadata& source,
+                const std::string& domain_id);
+
+        private:
+
+            void on_subscribed();
+            void on_unsubscribed();
+            void on_source_metadata_changed();
+
+            void on_source_data_published(
+                std::int64_t domain_value,
+                std::size_t sample_count,
+                const boost::asio::const_buffer *buffers,
+                std::size_t buffer_count,
+                const std::shared_ptr<const void>& owner);
+
+        private:
+
+            local_signal& _source;
+            local_signal _signal;
+            std::string _domain_id;
+            std::int64_t _domain_delta;
+            sample_converter _converter;
+            envelope_decimator _decimator;
+
+            std::vector<std::uint8_t> _data;
+            std::vector<double> _values;
+            std::vector<envelope_decimator::envelope> _envelopes;
+
+            local_signal::subscribe_holder _source_holder;
+            boost::signals2::scoped_connection _on_subscribed;
+            boost::signals2::scoped_connection _on_unsubscribed;
+            boost::signals2::scoped_connection _on_source_metadata_changed;
+            boost::signals2::scoped_connection _on_source_data_published;
+    };
+}
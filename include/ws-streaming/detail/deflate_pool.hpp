@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <boost/beast/zlib/deflate_stream.hpp>
+
+namespace wss::detail
+{
+    /**
+     * Bounds the memory used by per-message deflate compressors (see RFC 7692), each of which
+     * needs roughly 2^(window bits + 2) bytes plus its hash tables. Connections whose
+     * compression context persists across messages hold a compressor for as long as they live;
+     * other connections borrow one for each message and return it immediately, so that a single
+     * compressor can serve any number of them. If every compressor is in use, connections
+     * transmit uncompressed messages instead, which RFC 7692 always permits.
+     *
+     * This class is thread-safe. Instances must be managed by a std::shared_ptr.
+     */
+    class deflate_pool : public std::enable_shared_from_this<deflate_pool>
+    {
+        public:
+
+            /**
+             * The default maximum number of compressors.
+             */
+            static constexpr std::size_t DEFAULT_MAX_STREAMS = 64;
+
+            /**
+             * The DEFLATE compression level, from 1 (fastest) to 9 (smallest).
+             */
+            static constexpr int COMPRESSION_LEVEL = 6;
+
+            /**
+             * The zlib memory level, from 1 (least memory) to 9 (fastest). Level 4 uses 4 KiB
+             * per hash table, at little cost in speed or ratio for messages of the size we
+             * transmit.
+             */
+            static constexpr int MEMORY_LEVEL = 4;
+
+            /**
+             * Constructs a pool. No compressors are allocated until acquire() is called.
+             *
+             * @param max_streams The maximum number of compressors.
+             */
+            explicit deflate_pool(std::size_t max_streams = DEFAULT_MAX_STREAMS);
+
+            /**
+             * Acquires a compressor, reset so that it has no compression context.
+             *
+             * @param window_bits The LZ77 window size, as a base-2 logarithm, from 9 to 15.
+             *
+             * @return A pointer to the compressor, which is returned to the pool when the last
+             *     reference to it is released, or nullptr if the maximum number of compressors
+             *     is already in use.
+             */
+            std::shared_ptr<boost::beast::zlib::deflate_stream> acquire(unsigned window_bits);
+
+            /**
+             * Changes the maximum number of compressors. If more are in use, the excess are
+             * freed as they are returned to the pool.
+             *
+             * @param max_streams The maximum number of compressors.
+             */
+            void set_max_streams(std::size_t max_streams);
+
+        private:
+
+            void release(boost::beast::zlib::deflate_stream *stream) noexcept;
+
+            std::mutex _mutex;
+            std::vector<std::unique_ptr<boost::beast::zlib::deflate_stream>> _idle;
+            std::size_t _stream_count = 0;
+            std::size_t _max_streams;
+    };
+}
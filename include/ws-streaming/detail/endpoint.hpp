@@ -0,0 +1,47 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+namespace wss::detail
+{
+    /**
+     * Converts a protocol-independent stream socket endpoint to a TCP endpoint, if it refers to
+     * an IPv4 or IPv6 address.
+     *
+     * @param endpoint The endpoint to convert.
+     *
+     * @return The equivalent TCP endpoint, or std::nullopt if @p endpoint is not an IPv4 or IPv6
+     *     endpoint (for example, if it is a UNIX domain socket endpoint).
+     */
+    std::optional<boost::asio::ip::tcp::endpoint> to_tcp_endpoint(
+        const boost::asio::generic::stream_protocol::endpoint& endpoint);
+
+    /**
+     * Generates a human-readable description of a protocol-independent stream socket endpoint.
+     * IPv4 and IPv6 endpoints are formatted as `address:port`. UNIX domain socket endpoints are
+     * formatted as `unix:path`, where the path may be empty for unnamed sockets.
+     *
+     * @param endpoint The endpoint to describe.
+     *
+     * @return A human-readable description of @p endpoint.
+     */
+    std::string to_string(
+        const boost::asio::generic::stream_protocol::endpoint& endpoint);
+
+    /**
+     * Tests whether a connected stream socket is likely to connect two processes on the same
+     * host. This is the case for UNIX domain sockets, and for TCP sockets whose remote address
+     * is a loopback address or equal to the local address. The result is only a hint, and must
+     * be confirmed by other means before relying on it.
+     *
+     * @param socket The connected socket to test.
+     *
+     * @return True if the remote peer is likely to run on the same host.
+     */
+    bool is_same_host(
+        const boost::asio::generic::stream_protocol::socket& socket) noexcept;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wss::detail
+{
+    /**
+     * Reduces a stream of samples to one min/max/mean envelope per window of a fixed number of
+     * consecutive samples. Windows may span any number of calls to process(), so that the
+     * output does not depend on how the input stream is divided into blocks.
+     */
+    class envelope_decimator
+    {
+        public:
+
+            /**
+             * Describes the samples of one window. This is also the transmitted representation
+             * of each sample of a decimated signal.
+             */
+            struct envelope
+            {
+                double min;     /**< The smallest sample value in the window. */
+                double max;     /**< The largest sample value in the window. */
+                double mean;    /**< The arithmetic mean of the sample values in the window. */
+            };
+
+            /**
+             * Constructs a decimator.
+             *
+             * @param factor The number of samples in each window. A factor of zero is treated
+             *     as one.
+             */
+            explicit envelope_decimator(std::size_t factor);
+
+            /**
+             * Gets the number of samples in each window.
+             *
+             * @return The number of samples in each window.
+             */
+            std::size_t factor() const noexcept;
+
+            /**
+             * Discards the samples of the current partial window.
+             */
+            void reset() noexcept;
+
+            /**
+             * Adds a block of consecutive samples, appending an envelope to @p output for each
+             * window that is completed.
+             *
+             * @param values A pointer to the sample values.
+             * @param count The number of sample values.
+             * @param domain_value The domain value of the first sample in the block.
+             * @param domain_delta The difference between the domain values of consecutive
+             *     samples.
+             * @param output The vector to which completed envelopes are appended.
+             *
+             * @return The domain value of the first sample of the window of the first envelope
+             *     appended to @p output. The return value is unspecified if no envelopes were
+             *     appended.
+             */
+            std::int64_t process(
+                const double *values,
+                std::size_t count,
+                std::int64_t domain_value,
+                std::int64_t domain_delta,
+                std::vector<envelope>& output);
+
+        private:
+
+            std::size_t _factor;
+            std::size_t _count = 0;
+            std::int64_t _start = 0;
+            double _min = 0;
+            double _max = 0;
+            double _sum = 0;
+    };
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/endian/conversion.hpp>
+
+#include <ws-streaming/detail/streaming_protocol.hpp>
+#include <ws-streaming/detail/websocket_protocol.hpp>
+
+namespace wss::detail
+{
+    /**
+     * A framing policy for WebSocket Streaming Protocol packets carried in WebSocket binary
+     * frames. Packet headers and metadata encoding fields are little endian.
+     *
+     * Framing policies are used as template arguments by the peer class, so that the code paths
+     * for sending and receiving packets are specialized for one protocol variant at compile time
+     * and contain no per-packet branches on the variant.
+     */
+    struct websocket_framing
+    {
+        /**
+         * True if packets are carried in WebSocket frames.
+         */
+        static constexpr bool is_websocket = true;
+
+        /**
+         * The byte order of packet headers and metadata encoding fields.
+         */
+        static constexpr boost::endian::order byte_order = boost::endian::order::little;
+
+        /**
+         * Scans a buffer of consecutive WebSocket frames, each carrying a single WebSocket
+         * Streaming Protocol packet, populating an array of packet descriptors in a single pass.
+         * Only unfragmented, unmasked binary frames are described; scanning stops at any other
+         * frame, which the caller must process individually. Otherwise, scanning stops under the
+         * same conditions as streaming_protocol::scan_packets().
+         *
+         * @perfcrit This function is called once for every batch of received packets when using
+         *     the WebSocket protocol.
+         *
+         * @param data A pointer to the data to scan.
+         * @param size The size of the data pointed to by @p data in bytes.
+         * @param descriptors A pointer to an array of descriptors to populate. Descriptor
+         *     offsets are relative to @p data.
+         * @param max_descriptors The number of elements in the array pointed to by
+         *     @p descriptors.
+         *
+         * @return The number of populated descriptors and the number of bytes occupied by the
+         *     frames containing them.
+         */
+        static streaming_protocol::scan_result scan_packets(
+            const std::uint8_t *data,
+            std::size_t size,
+            streaming_protocol::packet_descriptor *descriptors,
+            std::size_t max_descriptors) noexcept
+        {
+            // A frame with a single-byte length field is at most this many bytes.
+            constexpr std::size_t MAX_SHORT_FRAME_SIZE = 2 + 125;
+            constexpr std::uint8_t SIMPLE_BINARY_FRAME =
+                websocket_protocol::flags::FIN | websocket_protocol::opcodes::BINARY;
+
+            std::size_t offset = 0;
+            std::size_t count = 0;
+
+            while (count < max_descriptors)
+            {
+                std::size_t frame_header_size;
+                std::size_t frame_payload_size;
+
+                // Fast path: if enough data remains to hold any short frame, and this is one,
+                // the frame header is two bytes and no truncation checks are needed.
+                if (size - offset >= MAX_SHORT_FRAME_SIZE
+                        && data[offset] == SIMPLE_BINARY_FRAME
+                        && data[offset + 1] < 126)
+                {
+                    frame_header_size = 2;
+                    frame_payload_size = data[offset + 1];
+                }
+
+                else
+                {
+                    auto frame = websocket_protocol::decode_header(data + offset, size - offset);
+
+                    if (!frame.header_size
+                            || frame.is_masked
+                            || frame.flags != websocket_protocol::flags::FIN
+                            || frame.opcode != websocket_protocol::opcodes::BINARY)
+                        break;
+
+                    frame_header_size = frame.header_size;
+                    frame_payload_size = frame.payload_size;
+                }
+
+                auto packet = streaming_protocol::decode_header<byte_order>(
+                    data + offset + frame_header_size,
+                    frame_payload_size);
+
+                if (!packet.header_size)
+                    break;
+
+                descriptors[count++] = {
+                    packet.signo,
+                    packet.type,
+                    offset + frame_header_size + packet.header_size,
+                    packet.payload_size
+                };
+
+                offset += frame_header_size + frame_payload_size;
+
+                if (packet.type == streaming_protocol::packet_type::METADATA)
+                    break;
+            }
+
+            return { count, offset };
+        }
+    };
+
+    /**
+     * A framing policy for the legacy direct TCP protocol, in which WebSocket Streaming Protocol
+     * packets are written directly to the byte stream without WebSocket framing. Packet headers
+     * and metadata encoding fields are big endian.
+     */
+    struct raw_framing
+    {
+        /**
+         * True if packets are carried in WebSocket frames.
+         */
+        static constexpr bool is_websocket = false;
+
+        /**
+         * The byte order of packet headers and metadata encoding fields.
+         */
+        static constexpr boost::endian::order byte_order = boost::endian::order::big;
+
+        /**
+         * Scans a buffer of consecutive WebSocket Streaming Protocol packets, populating an
+         * array of packet descriptors in a single pass. This is equivalent to
+         * streaming_protocol::scan_packets().
+         *
+         * @param data A pointer to the data to scan.
+         * @param size The size of the data pointed to by @p data in bytes.
+         * @param descriptors A pointer to an array of descriptors to populate.
+         * @param max_descriptors The number of elements in the array pointed to by
+         *     @p descriptors.
+         *
+         * @return The number of populated descriptors and the number of bytes they occupy.
+         */
+        static streaming_protocol::scan_result scan_packets(
+            const std::uint8_t *data,
+            std::size_t size,
+            streaming_protocol::packet_descriptor *descriptors,
+            std::size_t max_descriptors) noexcept
+        {
+            return streaming_protocol::scan_packets<byte_order>(
+                data,
+                size,
+                descriptors,
+                max_descriptors);
+        }
+    };
+}
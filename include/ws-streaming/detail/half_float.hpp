@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace wss::detail
+{
+    /**
+     * Converts an IEEE 754 half-precision value to single precision. The conversion is exact.
+     *
+     * @param half The bit pattern of the half-precision value.
+     *
+     * @return The single-precision value.
+     */
+    inline float half_to_float(std::uint16_t half) noexcept
+    {
+        constexpr std::uint32_t shifted_exponent = 0x7c00u << 13;
+
+        std::uint32_t bits = static_cast<std::uint32_t>(half & 0x7fffu) << 13;
+        std::uint32_t exponent = bits & shifted_exponent;
+        bits += (127 - 15) << 23;
+
+        // Infinities and NaNs keep the maximum exponent.
+        if (exponent == shifted_exponent)
+            bits += (128 - 16) << 23;
+
+        // Subnormal values are renormalized by the FPU.
+        else if (!exponent)
+        {
+            float value;
+            bits += 1 << 23;
+            std::memcpy(&value, &bits, sizeof(value));
+            value -= 6.103515625e-05f;  // 2^-14
+            std::memcpy(&bits, &value, sizeof(bits));
+        }
+
+        bits |= static_cast<std::uint32_t>(half & 0x8000u) << 16;
+
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * Converts a single-precision value to IEEE 754 half precision, rounding to the nearest
+     * representable value (ties to even). Values too large for half precision become infinite,
+     * and NaNs remain NaNs. The three possible results are computed unconditionally and then
+     * selected, so that loops calling this function can be vectorized.
+     *
+     * @param value The single-precision value.
+     *
+     * @return The bit pattern of the half-precision value.
+     */
+    inline std::uint16_t float_to_half(float value) noexcept
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        std::uint32_t sign = (bits >> 16) & 0x8000u;
+        bits &= 0x7fffffffu;
+
+        // Normal results: rebias the exponent and round the discarded mantissa bits.
+        std::uint32_t normal = (bits + 0xc8000fffu + ((bits >> 13) & 1)) >> 13;
+
+        // Subnormal results: adding 0.5 shifts the mantissa into place, and the FPU rounds it.
+        float magnitude;
+        std::memcpy(&magnitude, &bits, sizeof(magnitude));
+        magnitude += 0.5f;
+        std::uint32_t subnormal;
+        std::memcpy(&subnormal, &magnitude, sizeof(subnormal));
+        subnormal -= 0x3f000000u;
+
+        // Overflows become infinite, and NaNs become quiet NaNs.
+        std::uint32_t special = 0x7c00u | (static_cast<std::uint32_t>(bits > 0x7f800000u) << 9);
+
+        // The results are selected with masks; GCC does not if-convert the equivalent
+        // conditional expressions.
+        std::uint32_t is_subnormal = 0u - static_cast<std::uint32_t>(bits < 0x38800000u);
+        std::uint32_t is_special = 0u - static_cast<std::uint32_t>(bits >= 0x47800000u);
+
+        std::uint32_t result = (subnormal & is_subnormal) | (normal & ~is_subnormal);
+        result = (special & is_special) | (result & ~is_special);
+
+        return static_cast<std::uint16_t>(result | sign);
+    }
+}
@@ -4,9 +4,10 @@
 #include <functional>
 #include <memory>
 
+#include <boost/asio/generic/stream_protocol.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/basic_stream.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
-#include <boost/beast/core/tcp_stream.hpp>
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/http/string_body.hpp>
 #include <boost/system/error_code.hpp>
@@ -33,6 +34,23 @@ namespace wss::detail
     {
         public:
 
+            /**
+             * The type of the stream passed to completion handlers. The stream is protocol-
+             * independent, so that requests can be made over TCP or UNIX domain sockets.
+             */
+            typedef boost::beast::basic_stream<boost::asio::generic::stream_protocol> stream_type;
+
+            /**
+             * The type of the completion handler passed to async_request().
+             */
+            typedef std::function<
+                void(
+                    const boost::system::error_code& ec,
+                    const boost::beast::http::response<boost::beast::http::string_body>& response,
+                    stream_type& stream,
+                    const boost::beast::flat_buffer& buffer)
+            > handler_type;
+
             /**
              * Constructs an HTTP client object. Asynchronous socket operations will be dispatched
              * using the specified execution context.
@@ -65,13 +83,24 @@ namespace wss::detail
                 const std::string& hostname,
                 const std::string& port,
                 boost::beast::http::request<boost::beast::http::string_body>&& request,
-                std::function<
-                    void(
-                        const boost::system::error_code& ec,
-                        const boost::beast::http::response<boost::beast::http::string_body>& response,
-                        boost::beast::tcp_stream& stream,
-                        const boost::beast::flat_buffer& buffer)
-                > handler);
+                handler_type handler);
+
+            /**
+             * Asynchronously performs a request to a server at a known endpoint, without name
+             * resolution. This overload can be used to make requests over stream sockets that
+             * are not TCP sockets, such as UNIX domain sockets. The same restrictions and
+             * behavior apply as for the other async_request() overload.
+             *
+             * @param endpoint The endpoint of the HTTP server. Endpoints of specific protocols,
+             *     such as boost::asio::local::stream_protocol::endpoint, are implicitly converted.
+             * @param request A populated HTTP request object. The request object should not be
+             *     "prepared"; i.e., do not call prepare_payload().
+             * @param handler A completion handler to call when the operation is complete.
+             */
+            void async_request(
+                const boost::asio::generic::stream_protocol::endpoint& endpoint,
+                boost::beast::http::request<boost::beast::http::string_body>&& request,
+                handler_type handler);
 
             /**
              * Cancels a pending request, if any. The handler passed to async_request() will be
@@ -86,6 +115,10 @@ namespace wss::detail
 
         private:
 
+            void prepare_request(
+                boost::beast::http::request<boost::beast::http::string_body>&& request,
+                handler_type&& handler);
+
             void finish_resolve(
                 const boost::system::error_code& ec,
                 const boost::asio::ip::tcp::resolver::results_type& results);
@@ -104,17 +137,10 @@ namespace wss::detail
         private:
 
             boost::asio::ip::tcp::resolver _resolver;
-            boost::beast::tcp_stream _stream;
+            stream_type _stream;
             boost::beast::http::request<boost::beast::http::string_body> _request;
             boost::beast::flat_buffer _buffer;
             boost::beast::http::response<boost::beast::http::string_body> _response;
-
-            std::function<
-                void(
-                    const boost::system::error_code& ec,
-                    const boost::beast::http::response<boost::beast::http::string_body>& response,
-                    boost::beast::tcp_stream& stream,
-                    const boost::beast::flat_buffer& buffer)
-            > _handler;
+            handler_type _handler;
     };
 }
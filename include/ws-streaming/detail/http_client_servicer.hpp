@@ -3,9 +3,9 @@
 #include <cstddef>
 #include <memory>
 
-#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/beast/core/basic_stream.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
-#include <boost/beast/core/tcp_stream.hpp>
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/http/message_generator.hpp>
 #include <boost/beast/http/status.hpp>
@@ -15,6 +15,8 @@
 
 #include <nlohmann/json.hpp>
 
+#include <ws-streaming/detail/websocket_extensions.hpp>
+
 namespace wss::detail
 {
     /**
@@ -26,14 +28,14 @@ namespace wss::detail
      * on_websocket_upgrade signal is raised. When the connection is closed, or after a WebSocket
      * upgrade request has been handled, the on_closed event is raised.
      *
-     * Servicer objects are constructed with, and take ownership of, a connected Boost.Asio
-     * socket, and must always be managed by a std::shared_ptr, following the normal Boost.Asio
-     * pattern. When run() is called, the servicer object performs asynchronous I/O operations
-     * using the execution context of the provided socket. This execution context must provide
-     * sequential execution, i.e. in the terminology of Boost.Asio, it must be an explicit or
-     * implicit strand. In addition, the caller must ensure no member functions are called
-     * concurrently with each other or with an asynchronous completion handler. More explicitly
-     * stated, this class is not thread-safe.
+     * Servicer objects are constructed with, and take ownership of, a connected Boost.Asio stream
+     * socket (such as a TCP or UNIX domain socket), and must always be managed by a
+     * std::shared_ptr, following the normal Boost.Asio pattern. When run() is called, the
+     * servicer object performs asynchronous I/O operations using the execution context of the
+     * provided socket. This execution context must provide sequential execution, i.e. in the
+     * terminology of Boost.Asio, it must be an explicit or implicit strand. In addition, the
+     * caller must ensure no member functions are called concurrently with each other or with an
+     * asynchronous completion handler. More explicitly stated, this class is not thread-safe.
      */
     class http_client_servicer : public std::enable_shared_from_this<http_client_servicer>
     {
@@ -46,8 +48,12 @@ namespace wss::detail
              *
              * @param socket A socket, which the constructed object takes ownership of. The socket
              *     should be connected to the HTTP client.
+             * @param supported The WebSocket extensions the server supports. Those also offered
+             *     by the client in a WebSocket upgrade request are accepted.
              */
-            http_client_servicer(boost::asio::ip::tcp::socket&& socket);
+            http_client_servicer(
+                boost::asio::generic::stream_protocol::socket&& socket,
+                const websocket_extensions& supported = {});
 
             /**
              * Activates the servicer by starting asynchronous I/O operations using the socket's
@@ -89,8 +95,17 @@ namespace wss::detail
                     const nlohmann::json& params)
             > on_command_interface_request;
 
+            /**
+             * A signal raised when a WebSocket upgrade request has been accepted and the
+             * response has been transmitted. Connected slots should take ownership of the socket.
+             *
+             * @param socket The socket, which is now connected to a WebSocket client.
+             * @param extensions The WebSocket extensions agreed on with the client.
+             */
             boost::signals2::signal<
-                void(boost::asio::ip::tcp::socket&)
+                void(
+                    boost::asio::generic::stream_protocol::socket& socket,
+                    const websocket_extensions& extensions)
             > on_websocket_upgrade;
 
             /**
@@ -146,8 +161,10 @@ namespace wss::detail
 
         private:
 
-            boost::beast::tcp_stream stream;
+            boost::beast::basic_stream<boost::asio::generic::stream_protocol> stream;
             boost::beast::flat_buffer buffer;
             boost::beast::http::request<boost::beast::http::string_body> req;
+            websocket_extensions supported_extensions;
+            websocket_extensions extensions;
     };
 }
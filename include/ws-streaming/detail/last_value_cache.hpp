@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+namespace wss::detail
+{
+    /**
+     * Retains the most recently published block of a local signal, so that streaming endpoints
+     * can send it to remote peers as soon as they subscribe. Blocks are stored by the publishing
+     * thread and loaded by endpoints, which may run on other threads, so access is guarded by a
+     * mutex.
+     *
+     * Blocks published from reference-counted buffers are retained by reference. Other blocks
+     * are copied; the copy's memory is reused for the next block unless an endpoint still holds
+     * a reference to it.
+     *
+     * Each block is stored with a sequence number assigned by the publisher, which increases
+     * with every published block. The lock is only held while a block is stored or loaded, never
+     * while it is transmitted, so an endpoint that starts following the signal before loading
+     * the retained block may also receive that block live. It uses the sequence number to skip
+     * such blocks, and to start reading a broadcast ring right after the retained block.
+     */
+    class last_value_cache
+    {
+        public:
+
+            /**
+             * Describes a retained block.
+             */
+            struct block
+            {
+                std::uint64_t sequence = 0;         /**< The sequence number with which the block was stored. */
+                std::int64_t domain_value = 0;      /**< The domain value with which the block was published. */
+                std::size_t sample_count = 0;       /**< The number of samples with which the block was published. */
+                std::shared_ptr<const void> data;   /**< The block's data. */
+                std::size_t size = 0;               /**< The size of the block's data in bytes. */
+            };
+
+            /**
+             * Enables or disables the cache. Disabling the cache discards the retained block.
+             *
+             * @param enable True to enable the cache, or false to disable it.
+             */
+            void enable(bool enable);
+
+            /**
+             * Determines whether the cache is enabled.
+             *
+             * @return True if the cache is enabled.
+             */
+            bool enabled() const noexcept;
+
+            /**
+             * Retains a published block in place of the previously retained one, if the cache is
+             * enabled.
+             *
+             * @param sequence The sequence number assigned to the block by the publisher. This
+             *     must not be less than the sequence number of any previously stored block.
+             * @param domain_value The domain value with which the block was published.
+             * @param sample_count The number of samples with which the block was published.
+             * @param buffers A pointer to an array of descriptors of the block's data.
+             * @param buffer_count The number of descriptors pointed to by @p buffers.
+             * @param owner A reference-counted pointer that owns the block's data, or null if the
+             *     data must be copied.
+             */
+            void store(
+                std::uint64_t sequence,
+                std::int64_t domain_value,
+                std::size_t sample_count,
+                const boost::asio::const_buffer *buffers,
+                std::size_t buffer_count,
+                const std::shared_ptr<const void>& owner);
+
+            /**
+             * Gets the retained block.
+             *
+             * @return The retained block, or std::nullopt if the cache is disabled or no block
+             *     has been published since it was enabled.
+             */
+            std::optional<block> load() const;
+
+        private:
+
+            std::atomic<bool> _enabled = false;
+
+            mutable std::mutex _mutex;
+            std::optional<block> _block;
+            std::shared_ptr<std::vector<std::uint8_t>> _buffer;
+    };
+}
@@ -19,6 +19,8 @@ namespace wss::detail
 
             std::int64_t driven_value() const noexcept;
 
+            std::int64_t delta() const noexcept;
+
             std::int64_t value_at(std::int64_t index) const noexcept;
 
             void set(std::int64_t index, std::int64_t value) noexcept;
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <ws-streaming/metadata.hpp>
+
+namespace wss::detail
+{
+    /**
+     * Encodes and decodes the data of signals whose metadata declares a lossless payload
+     * encoding (see wss::encodings). The codec is selected once from the signal's metadata.
+     *
+     * Each data packet is encoded independently. An encoded packet begins with a mode byte:
+     * MODE_RAW is followed by the unencoded data, and is used whenever encoding would not make
+     * the packet smaller; MODE_ENCODED is followed by a variable-length (LEB128) sample count
+     * and the encoded samples. Trailing bytes that do not form a complete sample are not
+     * transmitted.
+     *
+     * The integer encodings transmit the first sample (and for delta-of-delta, the first
+     * difference) at full width, and then the first (delta) or second (delta-of-delta)
+     * differences between consecutive samples. Residuals are zigzag-encoded
+     * and bit-packed in groups of GROUP_SIZE, each preceded by a byte giving the bit width of
+     * the group's largest residual. The floating-point encoding transmits the first sample,
+     * and then each sample XORed with its predecessor using the variable-length bit-level
+     * scheme of Facebook's Gorilla time series database.
+     */
+    class payload_codec
+    {
+        public:
+
+            static constexpr std::uint8_t MODE_RAW = 0;         /**< The packet contains unencoded data. */
+            static constexpr std::uint8_t MODE_ENCODED = 1;     /**< The packet contains encoded data. */
+            static constexpr std::size_t GROUP_SIZE = 128;      /**< The number of residuals bit-packed with a common width. */
+
+            /**
+             * The largest unencoded packet size. Senders transmit larger packets as MODE_RAW,
+             * and receivers reject encoded packets that would decode to more than this.
+             */
+            static constexpr std::size_t MAX_DECODED_SIZE = 1024 * 1024;
+
+            /**
+             * Constructs a codec that does not encode data.
+             */
+            payload_codec() noexcept;
+
+            /**
+             * Constructs a codec for the signal described by the specified metadata. The codec
+             * is enabled if the metadata declares a supported encoding for an explicit-rule
+             * signal with a compatible data type.
+             *
+             * @param metadata The signal metadata.
+             */
+            payload_codec(const metadata& metadata);
+
+            /**
+             * Determines whether the codec encodes data.
+             *
+             * @return True if the codec encodes data.
+             */
+            bool enabled() const noexcept
+            {
+                return _encode != nullptr;
+            }
+
+            /**
+             * Determines the number of bytes encode() may use while encoding a packet, so
+             * that an output vector with this capacity is never reallocated. The floating-point
+             * encodings can expand each sample by up to half its size before the packet falls
+             * back to MODE_RAW.
+             *
+             * @param size The number of bytes of unencoded data.
+             *
+             * @return The maximum number of bytes used by the encoded packet.
+             */
+            static constexpr std::size_t max_encoded_size(std::size_t size) noexcept
+            {
+                return 1 + 10 + size + size / 2 + 16;
+            }
+
+            /**
+             * Encodes a packet of signal data.
+             *
+             * @param data A pointer to the data, in the byte order declared by the metadata.
+             * @param size The number of bytes pointed to by @p data.
+             * @param output The vector in which to store the encoded packet. Its previous
+             *     contents are discarded.
+             */
+            void encode(
+                const void *data,
+                std::size_t size,
+                std::vector<std::uint8_t>& output) const;
+
+            /**
+             * Decodes a packet of signal data.
+             *
+             * @param data A pointer to the encoded packet.
+             * @param size The number of bytes pointed to by @p data.
+             * @param output The vector in which to store the decoded data, in the byte order
+             *     declared by the metadata. Its previous contents are discarded.
+             *
+             * @return True if the packet was decoded, or false if it is malformed or would decode
+             *     to more than MAX_DECODED_SIZE bytes.
+             */
+            bool decode(
+                const void *data,
+                std::size_t size,
+                std::vector<std::uint8_t>& output) const;
+
+        private:
+
+            using encode_function = void (*)(
+                const std::uint8_t *, std::size_t, std::vector<std::uint8_t>&);
+
+            using decode_function = bool (*)(
+                const std::uint8_t *, std::size_t, std::size_t, std::uint8_t *);
+
+            encode_function _encode = nullptr;
+            decode_function _decode = nullptr;
+            std::size_t _sample_size = 0;
+    };
+}
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <optional>
 #include <string>
@@ -10,14 +12,20 @@
 #include <vector>
 
 #include <boost/asio/buffer.hpp>
-#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
 #include <boost/beast/core/buffers_cat.hpp>
 #include <boost/beast/core/buffers_suffix.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
 #include <boost/signals2/signal.hpp>
 #include <boost/system/error_code.hpp>
 
 #include <nlohmann/json.hpp>
 
+#include <ws-streaming/detail/block_compressor.hpp>
+#include <ws-streaming/detail/deflate_pool.hpp>
+#include <ws-streaming/detail/framing.hpp>
+#include <ws-streaming/detail/shared_memory_ring.hpp>
 #include <ws-streaming/detail/streaming_protocol.hpp>
 #include <ws-streaming/detail/websocket_protocol.hpp>
 
@@ -31,8 +39,11 @@ namespace wss::detail
      * on_metadata_received signals. The on_closed signal can be used to detect when the
      * connection has been closed, either gracefully or due to an error.
      *
-     * Peer objects are constructed with, and take ownership of, a connected Boost.Asio socket,
-     * and must always be managed by a std::shared_ptr, following the normal Boost.Asio pattern.
+     * Peer objects are constructed with, and take ownership of, a connected Boost.Asio stream
+     * socket, and must always be managed by a std::shared_ptr, following the normal Boost.Asio
+     * pattern. Any stream socket type whose protocol is convertible to
+     * boost::asio::generic::stream_protocol can be used, such as a TCP socket or a UNIX domain
+     * socket (boost::asio::local::stream_protocol::socket).
      * When run() is called, the peer object performs asynchronous I/O operations using the
      * execution context of the provided socket. This execution context must provide sequential
      * execution, i.e. in the terminology of Boost.Asio, it must be an explicit or implicit
@@ -46,15 +57,16 @@ namespace wss::detail
      * The peer is then destroyed when the caller releases all shared-pointer references to it and
      * once all asynchronous completion handlers have been called.
      *
+     * If both peers run on the same host, the byte stream in either direction can be moved off
+     * the socket and into a shared memory ring (see offer_shared_memory()). The same WebSocket
+     * and WebSocket Streaming Protocol framing is used, but packets are parsed in place from the
+     * ring. The socket remains open, and carries only wake-up notifications for that direction.
+     *
      * @todo When acting as a client, outgoing WebSocket frames are not masked, in violation of
      *     section 5.3 of RFC 6455. This will not be compatible with third-party servers that
      *     enforce the masking requirement. Masking has a significant performance cost, in that it
      *     makes zero-copy impossible. Ideally, we should mask by default, but also negotiate with
      *     the server to disable masking if the server allows it.
-     *
-     * @todo This class is coupled with boost::asio::tcp and cannot currently be used with other
-     *     stream socket types such as UNIX domain sockets. It should either be templated or use a
-     *     polymorphic socket adapter so it can work with any stream socket type.
      */
     class peer : public std::enable_shared_from_this<peer>
     {
@@ -65,8 +77,9 @@ namespace wss::detail
              * operations are started until run() is called. Asynchronous socket operations will
              * be dispatched using the socket's execution context.
              *
-             * @param socket A socket, which the constructed object takes ownership of. The socket
-             *     should be connected to the remote peer.
+             * @param socket A stream socket, which the constructed object takes ownership of. The
+             *     socket should be connected to the remote peer. Sockets of specific protocols,
+             *     such as boost::asio::ip::tcp::socket, are implicitly converted.
              * @param is_client True if this object should act as a client. This determines
              *     whether transmitted WebSocket frames are masked according to section 5.3 of RFC
              *     6455. The masking feature is not currently implemented.
@@ -90,7 +103,7 @@ namespace wss::detail
              *     non-blocking mode.
              */
             peer(
-                boost::asio::ip::tcp::socket&& socket,
+                boost::asio::generic::stream_protocol::socket&& socket,
                 bool is_client,
                 bool use_tcp_protocol = false,
                 std::size_t rx_buffer_size = 1024 * 1024,
@@ -128,6 +141,47 @@ namespace wss::detail
              */
             void stop();
 
+            /**
+             * Offers to move the byte stream transmitted by this peer into a shared memory ring.
+             * The offer is sent to the remote peer as metadata containing the name of a newly
+             * created shared memory segment. If the remote peer is able to open the segment,
+             * which is normally only possible if both peers run on the same host, it accepts the
+             * offer, and all subsequent packets are transmitted through the ring. Otherwise,
+             * the offer is rejected or ignored, and the socket continues to be used. The
+             * negotiation is transparent to users of the on_data_received and
+             * on_metadata_received signals.
+             *
+             * The ring is as large as this peer's receive buffer, which normally matches the
+             * remote peer's, so that a connection maps no more memory than it buffers anyway.
+             * Like the socket, the ring carries no frames larger than the remote peer's receive
+             * buffer; the remote peer closes the connection if it receives one.
+             *
+             * This function has no effect if an offer has already been made, or if shared memory
+             * is not supported on this platform.
+             */
+            void offer_shared_memory();
+
+            /**
+             * Allows shared memory offers made by the remote peer to be accepted. This must only
+             * be called if this peer has advertised the
+             * streaming_protocol::SHARED_MEMORY_CAPABILITY capability. Offers received before
+             * this function is called, or over a socket that does not appear to connect two
+             * processes on the same host, are ignored, so that a remote peer cannot make this
+             * process open arbitrary shared memory segments.
+             */
+            void enable_shared_memory() noexcept;
+
+            /**
+             * Determines whether the byte stream transmitted by this peer has been moved into a
+             * shared memory ring.
+             *
+             * @return True if packets are transmitted through a shared memory ring.
+             */
+            bool is_using_shared_memory() const noexcept
+            {
+                return _tx_ring_active;
+            }
+
             /**
              * Asynchronously sends signal data to the remote peer. This function directly
              * supports scatter-gather operations with no additional copy steps.
@@ -143,6 +197,9 @@ namespace wss::detail
                 unsigned signo,
                 const ConstBufferSequence& data)
             {
+                if (_batch_depth && _aggregate_packets && aggregate(signo, data))
+                    return;
+
                 send_packet(
                     signo,
                     detail::streaming_protocol::packet_type::DATA,
@@ -150,6 +207,90 @@ namespace wss::detail
                     std::nullopt);
             }
 
+            /**
+             * Asynchronously sends signal data, held in memory kept alive by a reference-counted
+             * owner, to the remote peer. If the data cannot be sent synchronously, the peer
+             * keeps a reference to @p owner until the data has been sent, instead of copying the
+             * data into its transmit buffer. The memory described by @p data must not be modified
+             * while any reference to @p owner is held.
+             *
+             * @tparam ConstBufferSequence A type that satisfies the Boost.Asio requirements for
+             *     a sequence of immutable buffers.
+             *
+             * @param signo The signal number to which the data applies.
+             * @param data A sequence of Boost.Asio buffer descriptors for the data to send.
+             * @param owner An object which keeps the memory described by @p data alive. If null,
+             *     this function behaves as send_data(unsigned, const ConstBufferSequence&).
+             */
+            template <typename ConstBufferSequence>
+            void send_data(
+                unsigned signo,
+                const ConstBufferSequence& data,
+                const std::shared_ptr<const void>& owner)
+            {
+                if (_batch_depth && _aggregate_packets && aggregate(signo, data))
+                    return;
+
+                send_packet(
+                    signo,
+                    detail::streaming_protocol::packet_type::DATA,
+                    data,
+                    std::nullopt,
+                    owner);
+            }
+
+            /**
+             * Begins a batch of packets. Until the matching call to end_batch(), packets are
+             * buffered rather than transmitted, and are then transmitted together, using as few
+             * system calls as possible. Batches may be nested; packets are transmitted when the
+             * outermost batch ends.
+             */
+            void begin_batch() noexcept;
+
+            /**
+             * Ends a batch of packets begun by begin_batch(). If this ends the outermost batch,
+             * the buffered packets are transmitted.
+             */
+            void end_batch();
+
+            /**
+             * Allows data packets sent within a batch to be combined into aggregate packets. This
+             * must only be called if the remote peer has advertised the
+             * streaming_protocol::AGGREGATE_CAPABILITY capability.
+             */
+            void enable_aggregate_packets() noexcept;
+
+            /**
+             * Enables block compression in both directions. This must only be called if both
+             * peers agreed on the websocket_extensions::BLOCK_COMPRESSION extension in the
+             * WebSocket upgrade handshake. The frames sent within each batch are then collected
+             * and, if a block_compressor finds them worth compressing, transmitted as compressed
+             * blocks. Frames sent outside batches are transmitted uncompressed.
+             */
+            void enable_block_compression();
+
+            /**
+             * Enables per-message deflate (see RFC 7692) in both directions. This must only be
+             * called if both peers agreed on the websocket_extensions::PERMESSAGE_DEFLATE
+             * extension in the WebSocket upgrade handshake. Compressed messages received are
+             * then decompressed. Messages transmitted are compressed, unless block compression
+             * is also enabled (in which case it takes precedence), they are too small to be
+             * worth compressing, no compressor can be acquired, or compression would not make
+             * them smaller.
+             *
+             * @param window_bits The largest LZ77 window size, as a base-2 logarithm, with
+             *     which we may compress. If this is less than
+             *     websocket_extensions::MIN_WINDOW_BITS, messages are transmitted uncompressed.
+             * @param context_takeover True if we may keep our compression context from one
+             *     message to the next. Such a peer holds a compressor for as long as it lives;
+             *     otherwise, it borrows one for each message.
+             * @param pool The pool from which to acquire compressors.
+             */
+            void enable_permessage_deflate(
+                unsigned window_bits,
+                bool context_takeover,
+                std::shared_ptr<detail::deflate_pool> pool);
+
             /**
              * Asynchronously sends JSON-RPC metadata to the remote peer.
              *
@@ -224,7 +365,7 @@ namespace wss::detail
              *
              * @return The underlying socket.
              */
-            boost::asio::ip::tcp::socket& socket()
+            boost::asio::generic::stream_protocol::socket& socket()
             {
                 return _socket;
             }
@@ -237,11 +378,22 @@ namespace wss::detail
             void do_wait_tx();
 
             void finish_wait_rx(const boost::system::error_code& wait_ec);
+            void finish_wait_rx_ring();
             void finish_wait_tx(const boost::system::error_code& wait_ec);
 
             void process_buffer();
-            void process_buffer_tcp();
-            void process_buffer_ws();
+            void process_rx_ring();
+
+            std::size_t process_stream(
+                std::uint8_t *data,
+                std::size_t size,
+                boost::system::error_code& ec);
+
+            template <typename Framing>
+            std::size_t process_stream(
+                std::uint8_t *data,
+                std::size_t size,
+                boost::system::error_code& ec);
 
             void process_websocket_frame(
                 const detail::websocket_protocol::decoded_header& header,
@@ -249,16 +401,103 @@ namespace wss::detail
                 std::size_t size,
                 boost::system::error_code& ec);
 
+            template <typename Framing>
             std::size_t process_packet(const std::uint8_t *data, std::size_t size);
+
+            template <typename Framing>
+            void dispatch_packet(
+                const detail::streaming_protocol::packet_descriptor& packet,
+                const std::uint8_t *data);
+
             void process_data_packet(unsigned signo, const std::uint8_t *data, std::size_t size);
+
+            template <typename Framing>
             void process_metadata_packet(unsigned signo, const std::uint8_t *data, std::size_t size);
 
+            bool handle_shared_memory_metadata(
+                const std::string& method,
+                const nlohmann::json& params);
+
+            void handle_shared_memory_offer(const nlohmann::json& params);
+            void handle_shared_memory_accept(const nlohmann::json& params);
+            void handle_shared_memory_reject(const nlohmann::json& params);
+            void handle_shared_memory_switch(const nlohmann::json& params);
+            void handle_shared_memory_wake(const nlohmann::json& params);
+
+            void ring_doorbell();
+            void wake_ring_writer();
+            void resume_tx_ring();
+            void abandon_shared_memory();
+
+            using tx_gather_array = std::array<boost::asio::const_buffer, 16>;
+
+            std::size_t gather_tx(tx_gather_array& buffers, std::size_t limit) const noexcept;
+
+            void consume_tx(std::size_t size) noexcept;
+            void queue_copy(const void *data, std::size_t size) noexcept;
+
+            void queue_reference(
+                const std::shared_ptr<const void>& owner,
+                const void *data,
+                std::size_t size);
+
+            /**
+             * Appends a small data packet to the pending aggregate packet, if it is small enough.
+             *
+             * @return True if the data was aggregated, or false if it must be sent separately.
+             */
             template <typename ConstBufferSequence>
+            bool aggregate(unsigned signo, const ConstBufferSequence& data)
+            {
+                std::size_t size = boost::asio::buffer_size(data);
+                if (size > MAX_AGGREGATE_ENTRY_SIZE)
+                    return false;
+
+                if (_aggregate_data.size() + size > MAX_AGGREGATE_SIZE)
+                    flush_aggregate();
+
+                std::size_t offset = _aggregate_data.size();
+                _aggregate_data.resize(offset + size);
+                boost::asio::buffer_copy(
+                    boost::asio::buffer(_aggregate_data.data() + offset, size),
+                    data);
+
+                _aggregate_entries.push_back({ signo, size });
+                return true;
+            }
+
+            void flush_aggregate();
+
+            void flush_compressed_block();
+
+            bool deflate_message();
+            bool inflate_message(const std::uint8_t *data, std::size_t size);
+
+            template <typename ConstBufferSequence>
+            void send_packet(
+                unsigned signo,
+                unsigned type,
+                const ConstBufferSequence& payload,
+                const std::optional<std::size_t>& payload_size,
+                const std::shared_ptr<const void>& owner = nullptr)
+            {
+                // Data that was aggregated earlier must be sent before anything that follows it.
+                if (!_aggregate_entries.empty())
+                    flush_aggregate();
+
+                if (_use_tcp_protocol)
+                    send_packet<detail::raw_framing>(signo, type, payload, payload_size, owner);
+                else
+                    send_packet<detail::websocket_framing>(signo, type, payload, payload_size, owner);
+            }
+
+            template <typename Framing, typename ConstBufferSequence>
             void send_packet(
                 unsigned signo,
                 unsigned type,
                 const ConstBufferSequence& payload,
-                const std::optional<std::size_t>& payload_size)
+                const std::optional<std::size_t>& payload_size,
+                const std::shared_ptr<const void>& owner = nullptr)
             {
                 std::array<std::uint8_t, detail::streaming_protocol::MAX_HEADER_SIZE> streaming_header;
 
@@ -267,13 +506,13 @@ namespace wss::detail
                         ? payload_size.value()
                         : boost::asio::buffer_size(payload);
 
-                auto streaming_header_size = detail::streaming_protocol::generate_header(
+                auto streaming_header_size = detail::streaming_protocol::generate_header<Framing::byte_order>(
                     streaming_header.data(),
                     signo,
                     type,
                     calculated_payload_size);
 
-                if (_use_tcp_protocol)
+                if constexpr (!Framing::is_websocket)
                     write(
                         boost::beast::buffers_cat(
                             boost::asio::buffer(
@@ -281,7 +520,9 @@ namespace wss::detail
                                 streaming_header_size),
                             payload),
                         streaming_header_size + calculated_payload_size,
-                        false);
+                        false,
+                        owner,
+                        calculated_payload_size);
                 else
                     send_websocket_frame(
                         detail::websocket_protocol::opcodes::BINARY,
@@ -290,7 +531,10 @@ namespace wss::detail
                                 streaming_header.data(),
                                 streaming_header_size),
                             payload),
-                        streaming_header_size + calculated_payload_size);
+                        streaming_header_size + calculated_payload_size,
+                        false,
+                        owner,
+                        calculated_payload_size);
             }
 
             template <typename ConstBufferSequence>
@@ -298,7 +542,9 @@ namespace wss::detail
                 unsigned opcode,
                 const ConstBufferSequence& payload,
                 const std::optional<std::size_t>& payload_size,
-                bool do_shutdown_after = false)
+                bool do_shutdown_after = false,
+                const std::shared_ptr<const void>& owner = nullptr,
+                std::size_t owned_size = 0)
             {
                 std::array<std::uint8_t, detail::websocket_protocol::MAX_HEADER_SIZE> ws_header;
 
@@ -307,6 +553,37 @@ namespace wss::detail
                         ? payload_size.value()
                         : boost::asio::buffer_size(payload);
 
+                // Data messages may be compressed with per-message deflate, which is pointless
+                // once the byte stream may be moved into a shared memory ring.
+                if (_deflate_pool
+                        && (opcode == detail::websocket_protocol::opcodes::BINARY
+                            || opcode == detail::websocket_protocol::opcodes::TEXT)
+                        && calculated_payload_size >= MIN_DEFLATE_SIZE
+                        && !_block_compressor
+                        && !_tx_ring)
+                {
+                    _deflate_input.resize(calculated_payload_size);
+                    boost::asio::buffer_copy(boost::asio::buffer(_deflate_input), payload);
+
+                    if (deflate_message())
+                    {
+                        auto ws_header_size = detail::websocket_protocol::generate_header(
+                            ws_header.data(),
+                            opcode,
+                            detail::websocket_protocol::flags::FIN | detail::websocket_protocol::flags::RSV1,
+                            _deflate_output.size());
+
+                        return write(
+                            boost::beast::buffers_cat(
+                                boost::asio::buffer(
+                                    ws_header.data(),
+                                    ws_header_size),
+                                boost::asio::buffer(_deflate_output)),
+                            ws_header_size + _deflate_output.size(),
+                            do_shutdown_after);
+                    }
+                }
+
                 auto ws_header_size = detail::websocket_protocol::generate_header(
                     ws_header.data(),
                     opcode,
@@ -320,26 +597,110 @@ namespace wss::detail
                             ws_header_size),
                         payload),
                     ws_header_size + calculated_payload_size,
-                    do_shutdown_after);
+                    do_shutdown_after,
+                    owner,
+                    owned_size);
             }
 
+            /**
+             * Writes data to the socket or shared memory ring, as transmit() does, except that
+             * within a batch on a connection using block compression, the data is collected into
+             * the next compressed block instead.
+             */
             template <typename ConstBufferSequence>
             void write(
                 const ConstBufferSequence& buffers,
                 const std::optional<std::size_t>& size,
-                bool do_shutdown_after)
+                bool do_shutdown_after,
+                const std::shared_ptr<const void>& owner = nullptr,
+                std::size_t owned_size = 0)
             {
                 std::size_t calculated_size
                     = size.has_value()
                         ? size.value()
                         : boost::asio::buffer_size(buffers);
 
+                // Compression is not used once the byte stream may be moved into a shared memory
+                // ring, so that no compressed block can straddle the switch.
+                if (_block_compressor)
+                {
+                    if (_batch_depth
+                            && !do_shutdown_after
+                            && !_tx_ring
+                            && calculated_size <= detail::block_compressor::MAX_BLOCK_SIZE)
+                    {
+                        if (_compress_input.size() + calculated_size > detail::block_compressor::MAX_BLOCK_SIZE)
+                            flush_compressed_block();
+
+                        std::size_t offset = _compress_input.size();
+                        _compress_input.resize(offset + calculated_size);
+                        boost::asio::buffer_copy(
+                            boost::asio::buffer(_compress_input.data() + offset, calculated_size),
+                            buffers);
+                        return;
+                    }
+
+                    // Anything collected earlier must be sent before this data.
+                    if (!_compress_input.empty())
+                        flush_compressed_block();
+                }
+
+                transmit(buffers, calculated_size, do_shutdown_after, owner, owned_size);
+            }
+
+            /**
+             * Writes data to the socket or shared memory ring, buffering whatever cannot be
+             * written synchronously. If @p owner is not null, the last @p owned_size bytes of
+             * @p buffers are kept alive by @p owner, and are referenced rather than copied if
+             * they must be buffered.
+             */
+            template <typename ConstBufferSequence>
+            void transmit(
+                const ConstBufferSequence& buffers,
+                std::size_t calculated_size,
+                bool do_shutdown_after,
+                const std::shared_ptr<const void>& owner = nullptr,
+                std::size_t owned_size = 0)
+            {
                 // If we already have user-space buffered data and are waiting for the socket to
                 // become writeable, we just need to add the additional data to the user-space
                 // buffer; the wait completion handler will see the additional data along with
                 // whatever was previously buffered.
                 if (_waiting_tx)
-                    return enqueue(buffers, calculated_size, do_shutdown_after);
+                    return enqueue(buffers, calculated_size, do_shutdown_after, owner, owned_size);
+
+                // Within a batch, everything is buffered and sent together by end_batch().
+                if (_batch_depth)
+                    return enqueue(buffers, calculated_size, do_shutdown_after, owner, owned_size);
+
+                // If the byte stream has been moved into a shared memory ring, copy as much as
+                // will fit into the ring, and wake the remote peer if it is waiting for data.
+                if (_tx_ring_active)
+                {
+                    auto [bytes_written, must_wake] = _tx_ring->write(buffers);
+
+                    if (must_wake)
+                        ring_doorbell();
+
+                    if (bytes_written == calculated_size)
+                    {
+                        if (do_shutdown_after)
+                            return close();
+                        return;
+                    }
+
+                    if (_tx_ring->corrupt())
+                        return abandon_shared_memory();
+
+                    boost::beast::buffers_suffix suffix{buffers};
+                    suffix.consume(bytes_written);
+                    return enqueue(
+                        suffix,
+                        calculated_size - bytes_written,
+                        do_shutdown_after,
+                        owner,
+                        owned_size);
+                }
 
                 // Otherwise, send as much as we can synchronously.
                 boost::system::error_code send_ec;
@@ -362,30 +723,51 @@ namespace wss::detail
                 // writeable.
                 boost::beast::buffers_suffix suffix{buffers};
                 suffix.consume(bytes_sent);
-                return enqueue(suffix, calculated_size - bytes_sent, do_shutdown_after);
+                return enqueue(
+                    suffix,
+                    calculated_size - bytes_sent,
+                    do_shutdown_after,
+                    owner,
+                    owned_size);
             }
 
             template <typename ConstBufferSequence>
             void enqueue(
                 const ConstBufferSequence& buffers,
                 std::size_t size,
-                bool do_shutdown_after)
+                bool do_shutdown_after,
+                const std::shared_ptr<const void>& owner = nullptr,
+                std::size_t owned_size = 0)
             {
-                std::size_t bytes_buffered = boost::asio::buffer_copy(
-                    boost::asio::mutable_buffer(
-                        _tx_buffer.data() + _tx_buffer_bytes,
-                        _tx_buffer.size() - _tx_buffer_bytes),
-                    buffers);
+                // The backlog is bounded by the size of the transmit buffer, regardless of
+                // whether the queued data is copied or referenced.
+                if (_tx_queue_bytes + size >= _tx_buffer.size())
+                    return close(boost::asio::error::no_buffer_space);
 
-                _tx_buffer_bytes += bytes_buffered;
+                // Leading bytes (such as packet headers) are copied. Trailing bytes that are kept
+                // alive by an owner are referenced instead.
+                std::size_t copy_size = owner ? size - std::min(size, owned_size) : size;
 
-                if (_tx_buffer_bytes == _tx_buffer.size())
-                    return close(boost::asio::error::no_buffer_space);
+                for (auto it = boost::asio::buffer_sequence_begin(buffers);
+                        it != boost::asio::buffer_sequence_end(buffers);
+                        ++it)
+                {
+                    boost::asio::const_buffer buffer = *it;
+
+                    std::size_t bytes_to_copy = std::min(buffer.size(), copy_size);
+                    if (bytes_to_copy)
+                        queue_copy(buffer.data(), bytes_to_copy);
+                    copy_size -= bytes_to_copy;
+                    buffer += bytes_to_copy;
+
+                    if (buffer.size())
+                        queue_reference(owner, buffer.data(), buffer.size());
+                }
 
                 if (do_shutdown_after)
-                    _shutdown_after = _tx_buffer_bytes;
+                    _shutdown_after = _tx_queue_bytes;
 
-                if (!_waiting_tx)
+                if (!_waiting_tx && !_batch_depth)
                     do_wait_tx();
             }
 
@@ -393,7 +775,7 @@ namespace wss::detail
 
         private:
 
-            boost::asio::ip::tcp::socket _socket;
+            boost::asio::generic::stream_protocol::socket _socket;
             bool _use_tcp_protocol = false;
             bool _is_closed = false;
 
@@ -403,9 +785,61 @@ namespace wss::detail
             std::size_t _rx_buffer_bytes = 0;
             std::size_t _tx_buffer_bytes = 0;
 
+            // Data waiting to be transmitted, in order. Each segment either refers to the next
+            // bytes copied into _tx_buffer (if owner is null) or to memory kept alive by owner.
+            struct tx_segment
+            {
+                std::shared_ptr<const void> owner;
+                const std::uint8_t *data;
+                std::size_t size;
+            };
+
+            std::deque<tx_segment> _tx_queue;
+            std::size_t _tx_queue_bytes = 0;
+
             bool _waiting_tx = false;
             std::size_t _shutdown_after = 0;
+            unsigned _batch_depth = 0;
+
+            // Data packets combined into the next aggregate packet.
+            bool _aggregate_packets = false;
+            std::vector<detail::streaming_protocol::aggregate_entry> _aggregate_entries;
+            std::vector<std::uint8_t> _aggregate_data;
+            std::vector<std::uint8_t> _aggregate_table;
+
+            static constexpr std::size_t MAX_AGGREGATE_ENTRY_SIZE = 1024;
+            static constexpr std::size_t MAX_AGGREGATE_SIZE = 64 * 1024;
+
+            // Frames collected for the next compressed block, if block compression is enabled.
+            std::optional<detail::block_compressor> _block_compressor;
+            std::vector<std::uint8_t> _compress_input;
+            std::vector<std::uint8_t> _compress_output;
+            std::vector<std::uint8_t> _decompressed;
+            bool _is_decompressing = false;
+
+            // Per-message deflate state, if enabled. Our compressor is only kept between
+            // messages if context takeover is permitted; the decompressor always is.
+            std::shared_ptr<detail::deflate_pool> _deflate_pool;
+            std::shared_ptr<boost::beast::zlib::deflate_stream> _deflate_stream;
+            std::optional<boost::beast::zlib::inflate_stream> _inflate_stream;
+            unsigned _deflate_window_bits = 0;
+            bool _deflate_context_takeover = false;
+            bool _inflate_enabled = false;
+            std::vector<std::uint8_t> _deflate_input;
+            std::vector<std::uint8_t> _deflate_output;
+            std::vector<std::uint8_t> _inflated;
+
+            static constexpr std::size_t MIN_DEFLATE_SIZE = 32;
 
             boost::system::error_code _close_ec;
+
+            std::unique_ptr<detail::shared_memory_ring> _tx_ring;
+            std::unique_ptr<detail::shared_memory_ring> _rx_ring;
+            bool _shared_memory_enabled = false;
+            bool _tx_ring_active = false;
+            bool _rx_ring_active = false;
+            bool _rx_switch_pending = false;
+            bool _tx_ring_waiting = false;
+            std::size_t _switch_after = 0;
     };
 }
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/sample_converter.hpp>
+
+namespace wss::detail
+{
+    /**
+     * Converts the samples of a numeric signal to one of the reduced-precision transport formats
+     * in the wss::transport_formats namespace, and describes the converted samples with
+     * metadata derived from the source signal's metadata.
+     *
+     * Source samples are first converted to post-scaled floating-point values by a
+     * sample_converter. For the scaledInt16 format, these values are then quantized to 65535
+     * evenly spaced levels spanning the range declared in the source metadata, with values
+     * outside the range clamped to it; the post-scaling of the converted signal maps the levels
+     * back to values.
+     */
+    class precision_reducer
+    {
+        public:
+
+            /**
+             * Constructs an invalid reducer that cannot convert any data.
+             */
+            precision_reducer() noexcept;
+
+            /**
+             * Constructs a reducer.
+             *
+             * @param source The metadata of the source signal.
+             * @param format The transport format string.
+             */
+            precision_reducer(
+                const metadata& source,
+                const std::string& format);
+
+            /**
+             * Determines whether the reducer can convert data. This is false if the format is
+             * unknown, if the source samples cannot be converted to floating-point values, or if
+             * the format is scaledInt16 and the source metadata declares no non-empty range.
+             *
+             * @return True if the reducer can convert data.
+             */
+            bool valid() const noexcept;
+
+            /**
+             * Gets the size in bytes of each source sample.
+             *
+             * @return The size in bytes of each source sample.
+             */
+            std::size_t source_sample_size() const noexcept;
+
+            /**
+             * Gets the size in bytes of each converted sample.
+             *
+             * @return The size in bytes of each converted sample.
+             */
+            std::size_t sample_size() const noexcept;
+
+            /**
+             * Gets the metadata that describes the converted samples. The converted samples are
+             * in native byte order and carry no payload encoding.
+             *
+             * @return The metadata of the converted signal.
+             */
+            const metadata& reduced_metadata() const noexcept;
+
+            /**
+             * Converts source samples.
+             *
+             * @param data A pointer to @p sample_count source samples. No alignment is
+             *     required.
+             * @param sample_count The number of samples to convert.
+             * @param output A pointer to an array of at least @p sample_count converted
+             *     samples, aligned for the converted sample type.
+             *
+             * @return True if the samples were converted, or false if the reducer is not valid.
+             */
+            bool reduce(
+                const void *data,
+                std::size_t sample_count,
+                void *output);
+
+        private:
+
+            enum class format_type { none, real32, real16, scaled_int16 };
+
+            format_type _format = format_type::none;
+            sample_converter _converter;
+            metadata _metadata;
+            double _low = 0;
+            double _inverse_scale = 0;
+
+            std::vector<float> _floats;
+            std::vector<double> _values;
+    };
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/signals2/connection.hpp>
+
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/detail/precision_reducer.hpp>
+
+namespace wss::detail
+{
+    /**
+     * A signal, derived from a local signal, whose samples are the source signal's samples in
+     * one of the reduced-precision transport formats in the wss::transport_formats namespace.
+     * The derived signal uses the source signal's domain signal.
+     *
+     * Reduced signals are shared: connections obtain them with get(), which returns the same
+     * object to every connection requesting the same format of the same source, so that each
+     * published block is converted only once, into memory that every subscribed connection
+     * transmits without copying. The source signal is only observed while the reduced signal
+     * is subscribed.
+     */
+    class reduced_signal
+    {
+        public:
+
+            /**
+             * Constructs a reduced signal. Applications should use get() instead, which shares
+             * reduced signals between connections.
+             *
+             * @param source The source signal. The source must outlive this object.
+             * @param format The transport format string.
+             */
+            reduced_signal(
+                local_signal& source,
+                const std::string& format);
+
+            /**
+             * Gets the reduced signal for the specified format of a source signal, creating it
+             * if no connection currently holds one.
+             *
+             * @param source The source signal. The source must outlive the returned object.
+             * @param format The transport format string.
+             *
+             * @return A pointer to the reduced signal, or null if the source signal cannot be
+             *     converted to the format (see precision_reducer::valid()).
+             */
+            static std::shared_ptr<reduced_signal> get(
+                local_signal& source,
+                const std::string& format);
+
+            /**
+             * Generates the global identifier of a reduced signal.
+             *
+             * @param source_id The global identifier of the source signal.
+             * @param format The transport format string.
+             *
+             * @return The global identifier of the reduced signal.
+             */
+            static std::string make_id(
+                const std::string& source_id,
+                const std::string& format);
+
+            /**
+             * Gets the reduced signal.
+             *
+             * @return A reference to the reduced signal.
+             */
+            local_signal& signal() noexcept;
+
+            /**
+             * Gets the source signal.
+             *
+             * @return A reference to the source signal.
+             */
+            local_signal& source() noexcept;
+
+        private:
+
+            void on_subscribed();
+            void on_unsubscribed();
+            void on_source_metadata_changed();
+
+            void on_source_data_published(
+                std::int64_t domain_value,
+                std::size_t sample_count,
+                const boost::asio::const_buffer *buffers,
+                std::size_t buffer_count,
+                const std::shared_ptr<const void>& owner);
+
+        private:
+
+            local_signal& _source;
+            std::string _format;
+            precision_reducer _reducer;
+            local_signal _signal;
+
+            std::vector<std::uint8_t> _data;
+
+            local_signal::subscribe_holder _source_holder;
+            boost::signals2::scoped_connection _on_subscribed;
+            boost::signals2::scoped_connection _on_unsubscribed;
+            boost::signals2::scoped_connection _on_source_metadata_changed;
+            boost::signals2::scoped_connection _on_source_data_published;
+    };
+}
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <vector>
 
 #include <boost/signals2/connection.hpp>
 
 #include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/detail/broadcast_ring.hpp>
 #include <ws-streaming/detail/linear_table.hpp>
+#include <ws-streaming/detail/payload_codec.hpp>
 
 namespace wss::detail
 {
@@ -24,11 +29,21 @@ namespace wss::detail
         unsigned                                implicit_subscribe_count    = 0;
         boost::signals2::scoped_connection      on_metadata_changed;
         boost::signals2::scoped_connection      on_data_published;
+        boost::signals2::scoped_connection      on_group_begin;
+        boost::signals2::scoped_connection      on_group_end;
         local_signal::subscribe_holder          holder;
-        std::shared_ptr<detail::linear_table>   table;
+        std::optional<detail::linear_table>     table;
         std::int64_t                            value_index                 = 0;
         unsigned                                domain_signo;
-        std::weak_ptr<detail::linear_table>     domain_table;
+        std::optional<detail::linear_table>    *domain_table                = nullptr;
         bool                                    is_explicit                 = false;
+        std::shared_ptr<detail::broadcast_ring> broadcast_ring;
+        std::uint64_t                           broadcast_cursor            = 0;
+        std::optional<std::uint64_t>            broadcast_sample_index;
+        std::uint64_t                           broadcast_overruns          = 0;
+        std::atomic<std::uint64_t>              last_value_sequence         = 0;
+        detail::payload_codec                   codec;
+        std::vector<std::uint8_t>               encode_input;
+        std::vector<std::uint8_t>               encoded;
     };
 }
@@ -6,6 +6,7 @@
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <boost/signals2/signal.hpp>
 
@@ -13,6 +14,7 @@
 
 #include <ws-streaming/remote_signal.hpp>
 #include <ws-streaming/detail/linear_table.hpp>
+#include <ws-streaming/detail/payload_codec.hpp>
 
 namespace wss::detail
 {
@@ -55,8 +57,10 @@ namespace wss::detail
 
             unsigned _subscription_count = 0;
 
-            std::shared_ptr<linear_table> _table;
-            std::weak_ptr<linear_table> _domain_table;
+            std::optional<linear_table> _table;
+
+            // Refers to the domain signal's table, which _domain_signal keeps alive.
+            std::optional<linear_table> *_domain_table = nullptr;
 
             std::shared_ptr<remote_signal_impl> _domain_signal;
 
@@ -64,6 +68,9 @@ namespace wss::detail
             std::size_t _sample_size = 0;
             std::int64_t _value_index = 0;
 
+            payload_codec _codec;
+            std::vector<std::uint8_t> _decoded;
+
             std::uint64_t _tcp_delta = 0;
             std::uint64_t _tcp_time = 0;
     };
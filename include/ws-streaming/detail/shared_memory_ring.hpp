@@ -0,0 +1,289 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <boost/asio/buffer.hpp>
+
+namespace wss::detail
+{
+    /**
+     * Implements a single-producer, single-consumer byte ring buffer in a named POSIX shared
+     * memory segment, allowing two processes on the same host to exchange a byte stream without
+     * copying it through the kernel. One process creates the ring and writes to it; the other
+     * process opens the ring by name and reads from it.
+     *
+     * The data area is mapped twice at consecutive virtual addresses, so that any readable or
+     * writable region of the ring is contiguous in memory even if it wraps around the end of the
+     * buffer. This allows the reader to parse packets in place, without first copying them out
+     * of the ring.
+     *
+     * The ring does not itself provide a wake-up mechanism. Instead, the reader calls
+     * prepare_wait() before going to sleep, and the writer's write() function reports whether
+     * the reader must be woken. Likewise, the writer calls prepare_wait_for_space() when the ring
+     * is full, and the reader's consume() function reports whether the writer must be woken. The
+     * caller is responsible for delivering the wake-ups using some other channel.
+     *
+     * The head and tail indices in the shared segment can be modified by the remote process at
+     * any time. Each side therefore keeps its own copy of the index it owns, and validates the
+     * remote process's index every time it is loaded. If the remote index is inconsistent, the
+     * ring is marked as corrupt, and it reports no readable data and no writable space from then
+     * on.
+     *
+     * Index validation does not make the ring safe to share with an untrusted process. The
+     * segment is a named POSIX shared memory object, so any process running as the same user
+     * can open it while it is still named, and the remote process can shrink it with ftruncate()
+     * at any time, causing the next access to the mapping to raise SIGBUS. Shared memory rings
+     * must therefore only be used between processes that trust each other not to crash one
+     * another, which is the case for processes run by the same user on the same host. The
+     * opening constructor rejects segments too small to hold the header, so that merely naming
+     * an unrelated or empty segment cannot crash the opening process.
+     *
+     * Shared memory rings are only supported on POSIX platforms. On other platforms, the
+     * constructors throw boost::system::system_error.
+     */
+    class shared_memory_ring
+    {
+        public:
+
+            /**
+             * Creates a new shared memory segment with a randomly generated name and cookie and
+             * maps it for writing.
+             *
+             * @param capacity The desired capacity of the ring in bytes. This is rounded up to
+             *     a multiple of the system's page size.
+             *
+             * @throws boost::system::system_error The shared memory segment could not be created
+             *     or mapped.
+             */
+            explicit shared_memory_ring(std::size_t capacity);
+
+            /**
+             * Opens an existing shared memory segment created by another process and maps it for
+             * reading.
+             *
+             * @param name The name of the shared memory segment.
+             * @param cookie The cookie that the creator of the segment generated. If the cookie
+             *     stored in the segment does not match, the segment is rejected. This protects
+             *     against accidentally attaching to an unrelated segment of the same name, for
+             *     example if the remote peer is running on a different host.
+             *
+             * @throws boost::system::system_error The shared memory segment could not be opened
+             *     or mapped, or it is not a valid ring with the specified cookie.
+             */
+            shared_memory_ring(const std::string& name, std::uint64_t cookie);
+
+            shared_memory_ring(const shared_memory_ring&) = delete;
+            shared_memory_ring& operator=(const shared_memory_ring&) = delete;
+
+            /**
+             * Unmaps the shared memory segment. If this object created the segment and unlink()
+             * has not yet been called, the segment's name is also removed.
+             */
+            ~shared_memory_ring();
+
+            /**
+             * Gets the name of the shared memory segment.
+             *
+             * @return The name of the shared memory segment.
+             */
+            const std::string& name() const noexcept { return _name; }
+
+            /**
+             * Gets the cookie stored in the shared memory segment.
+             *
+             * @return The cookie stored in the shared memory segment.
+             */
+            std::uint64_t cookie() const noexcept { return _header->cookie; }
+
+            /**
+             * Gets the capacity of the ring in bytes.
+             *
+             * @return The capacity of the ring in bytes.
+             */
+            std::size_t capacity() const noexcept { return _capacity; }
+
+            /**
+             * Removes the name of the shared memory segment, so that no other process can open
+             * it. Existing mappings, including the remote peer's, remain valid. This should be
+             * called as soon as the remote peer has opened the segment.
+             */
+            void unlink() noexcept;
+
+            /**
+             * Determines whether the remote process has stored an inconsistent head or tail
+             * index in the shared segment. Once this happens, the ring can no longer be used.
+             *
+             * @return True if the ring is corrupt.
+             */
+            bool corrupt() const noexcept { return _is_corrupt; }
+
+            /**
+             * Copies as much of the specified data into the ring as will fit. Called only by the
+             * writer.
+             *
+             * @perfcrit This function is called once for every packet transmitted over a shared
+             *     memory transport.
+             *
+             * @tparam ConstBufferSequence A type that satisfies the Boost.Asio requirements for
+             *     a sequence of immutable buffers.
+             *
+             * @param buffers The data to write.
+             *
+             * @return A pair containing the number of bytes written, which may be less than the
+             *     size of @p buffers if the ring is full or corrupt, and a flag that is true if
+             *     the reader has called prepare_wait() and must now be woken.
+             */
+            template <typename ConstBufferSequence>
+            std::pair<std::size_t, bool> write(const ConstBufferSequence& buffers) noexcept
+            {
+                std::uint64_t tail = _header->tail.load(std::memory_order_acquire);
+                if (!is_valid(_head, tail))
+                    return { 0, false };
+
+                std::size_t bytes_written = boost::asio::buffer_copy(
+                    boost::asio::mutable_buffer(
+                        _data + _head % _capacity,
+                        _capacity - static_cast<std::size_t>(_head - tail)),
+                    buffers);
+
+                if (!bytes_written)
+                    return { 0, false };
+
+                _head += bytes_written;
+                _header->head.store(_head, std::memory_order_seq_cst);
+
+                return {
+                    bytes_written,
+                    _header->reader_waiting.exchange(0, std::memory_order_seq_cst) != 0
+                };
+            }
+
+            /**
+             * Announces that the writer is about to wait for space to become available. Called
+             * only by the writer after write() has reported that the ring is full. If the reader
+             * has consumed data since then, the announcement is withdrawn and false is returned,
+             * and the writer should call write() again instead of waiting.
+             *
+             * @return True if the writer may wait; the next consume() will then report that the
+             *     writer must be woken. False if space is available or the ring is corrupt.
+             */
+            bool prepare_wait_for_space() noexcept
+            {
+                _header->writer_waiting.store(1, std::memory_order_seq_cst);
+
+                std::uint64_t tail = _header->tail.load(std::memory_order_seq_cst);
+                if (is_valid(_head, tail) && _head - tail == _capacity)
+                    return true;
+
+                _header->writer_waiting.store(0, std::memory_order_relaxed);
+                return false;
+            }
+
+            /**
+             * Gets the region of the ring containing data that has been written but not yet
+             * consumed. Called only by the reader. The region is always contiguous, and may be
+             * modified in place by the reader.
+             *
+             * @return A pointer to the readable data and the number of readable bytes. The
+             *     number of readable bytes is zero if the ring is corrupt.
+             */
+            std::pair<std::uint8_t *, std::size_t> readable() noexcept
+            {
+                std::uint64_t head = _header->head.load(std::memory_order_acquire);
+                if (!is_valid(head, _tail))
+                    return { _data, 0 };
+
+                _seen_head = head;
+
+                return {
+                    _data + _tail % _capacity,
+                    static_cast<std::size_t>(head - _tail)
+                };
+            }
+
+            /**
+             * Releases data at the beginning of the readable region back to the writer. Called
+             * only by the reader.
+             *
+             * @param size The number of bytes to release. This must not exceed the size of the
+             *     region most recently returned by readable().
+             *
+             * @return True if the writer has called prepare_wait_for_space() and must now be
+             *     woken.
+             */
+            bool consume(std::size_t size) noexcept
+            {
+                if (!size)
+                    return false;
+
+                _tail += size;
+                _header->tail.store(_tail, std::memory_order_seq_cst);
+
+                return _header->writer_waiting.load(std::memory_order_seq_cst)
+                    && _header->writer_waiting.exchange(0, std::memory_order_seq_cst) != 0;
+            }
+
+            /**
+             * Announces that the reader is about to sleep. Called only by the reader after it has
+             * processed everything returned by readable(). If the writer has written more data
+             * since then, the announcement is withdrawn and false is returned, and the reader
+             * should call readable() again instead of sleeping.
+             *
+             * @return True if the reader may sleep; the next write() will then report that the
+             *     reader must be woken.
+             */
+            bool prepare_wait() noexcept
+            {
+                _header->reader_waiting.store(1, std::memory_order_seq_cst);
+
+                if (_header->head.load(std::memory_order_seq_cst) == _seen_head)
+                    return true;
+
+                _header->reader_waiting.store(0, std::memory_order_relaxed);
+                return false;
+            }
+
+        private:
+
+            struct header
+            {
+                std::uint64_t magic;
+                std::uint64_t cookie;
+                std::uint64_t capacity;
+                alignas(64) std::atomic<std::uint64_t> head;
+                alignas(64) std::atomic<std::uint64_t> tail;
+                alignas(64) std::atomic<std::uint32_t> reader_waiting;
+                alignas(64) std::atomic<std::uint32_t> writer_waiting;
+            };
+
+            static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                "shared memory rings require lock-free 64-bit atomics");
+
+            void map(int fd, std::size_t header_size);
+
+            bool is_valid(std::uint64_t head, std::uint64_t tail) noexcept
+            {
+                if (!_is_corrupt && tail <= head && head - tail <= _capacity)
+                    return true;
+
+                _is_corrupt = true;
+                return false;
+            }
+
+            std::string _name;
+            bool _is_owner;
+            std::size_t _capacity = 0;
+            std::size_t _mapping_size = 0;
+            void *_mapping = nullptr;
+            header *_header = nullptr;
+            std::uint8_t *_data = nullptr;
+            std::uint64_t _head = 0;
+            std::uint64_t _tail = 0;
+            std::uint64_t _seen_head = 0;
+            bool _is_corrupt = false;
+    };
+}
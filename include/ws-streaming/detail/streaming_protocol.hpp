@@ -27,6 +27,57 @@ namespace wss::detail
         {
             constexpr unsigned DATA = 1;        /**< Specifies that a packet contains signal data. */
             constexpr unsigned METADATA = 2;    /**< Specifies that a packet contains metadata. */
+            constexpr unsigned AGGREGATE = 3;   /**< Specifies that a packet contains data for several signals (a library extension; see AGGREGATE_CAPABILITY). */
+        }
+
+        /**
+         * The name of the capability, listed in the "capabilities" array of the "init" metadata
+         * message, by which a peer indicates that it accepts aggregate packets. Aggregate packets
+         * are never sent to peers that have not advertised this capability.
+         *
+         * The payload of an aggregate packet consists of a 32-bit entry count, followed by a
+         * table of that many entries each consisting of a 32-bit signal number and a 32-bit data
+         * size, followed by the concatenated data of every entry. All fields use the byte order
+         * of the packet header. Each entry is processed exactly as if it had been received as a
+         * separate data packet.
+         */
+        constexpr const char *AGGREGATE_CAPABILITY = "aggregatePackets";
+
+        /**
+         * The capability string a peer advertises in the "capabilities" array of its "init"
+         * message if it can decode data packets of signals whose metadata declares a payload
+         * encoding (see wss::encodings). Peers only declare payload encodings in the metadata
+         * they transmit to peers advertising this capability.
+         */
+        constexpr const char *ENCODING_CAPABILITY = "payloadEncodings";
+
+        /**
+         * The capability string a peer advertises in the "capabilities" array of its "init"
+         * message if it understands the shared memory negotiation (see
+         * peer::offer_shared_memory()). Shared memory is only offered to peers advertising this
+         * capability, so that no segment is created for peers that would ignore the offer.
+         */
+        constexpr const char *SHARED_MEMORY_CAPABILITY = "sharedMemory";
+
+        /**
+         * Describes one signal's data within an aggregate packet.
+         */
+        struct aggregate_entry
+        {
+            unsigned signo;                             /**< The signal number. */
+            std::size_t size;                           /**< The size of the signal's data in bytes. */
+        };
+
+        /**
+         * Calculates the size of the table at the beginning of an aggregate packet's payload.
+         *
+         * @param entry_count The number of entries in the aggregate packet.
+         *
+         * @return The size of the table in bytes, including the entry count.
+         */
+        constexpr std::size_t aggregate_table_size(std::size_t entry_count) noexcept
+        {
+            return sizeof(std::uint32_t) + entry_count * 2 * sizeof(std::uint32_t);
         }
 
         /**
@@ -58,6 +109,9 @@ namespace wss::detail
          * @perfcrit This function is called once for every transmitted WebSocket Streaming
          *     Protocol packet.
          *
+         * @tparam Order The byte order of the header fields: little endian for the WebSocket
+         *     protocol, or big endian for the direct TCP protocol.
+         *
          * @param header A pointer to memory to populate with the header. The pointed-to area must
          *     be large enough to hold the largest possible header (MAX_HEADER_SIZE).
          * @param signo The signal number, which may be zero for metadata.
@@ -66,22 +120,30 @@ namespace wss::detail
          *
          * @return The size of the generated header in bytes.
          */
+        template <boost::endian::order Order = boost::endian::order::little>
         inline std::size_t generate_header(std::uint8_t *header,
             unsigned signo, unsigned type, std::size_t payload_size)
         {
-            if (payload_size < 256)
+            // A size field of zero in the first word indicates that the size follows in a
+            // second word, so empty payloads must also use the long form.
+            if (payload_size && payload_size < 256)
             {
-                reinterpret_cast<std::uint32_t *>(header)[0] = boost::endian::native_to_little<std::uint32_t>(
-                    signo |
-                    (static_cast<unsigned>(payload_size) << 20)
-                    | (type << 28));
+                boost::endian::endian_store<std::uint32_t, sizeof(std::uint32_t), Order>(
+                    header,
+                    signo
+                        | (static_cast<unsigned>(payload_size) << 20)
+                        | (type << 28));
                 return sizeof(std::uint32_t);
             }
 
             else if (payload_size <= std::numeric_limits<std::uint32_t>::max())
             {
-                reinterpret_cast<std::uint32_t *>(header)[0] = boost::endian::native_to_little<std::uint32_t>(signo | (type << 28));
-                reinterpret_cast<std::uint32_t *>(header)[1] = boost::endian::native_to_little<std::uint32_t>(static_cast<std::uint32_t>(payload_size));
+                boost::endian::endian_store<std::uint32_t, sizeof(std::uint32_t), Order>(
+                    header,
+                    signo | (type << 28));
+                boost::endian::endian_store<std::uint32_t, sizeof(std::uint32_t), Order>(
+                    header + sizeof(std::uint32_t),
+                    static_cast<std::uint32_t>(payload_size));
                 return 2 * sizeof(std::uint32_t);
             }
 
@@ -105,19 +167,267 @@ namespace wss::detail
         /**
          * Decodes a WebSocket Streaming Protocol packet header.
          *
+         * @perfcrit This function is called once for every received WebSocket Streaming
+         *     Protocol packet. It is defined inline so that receive loops specialized for a
+         *     particular byte order contain no per-packet branches on the protocol variant.
+         *
+         * @tparam Order The byte order of the header fields: little endian for the WebSocket
+         *     protocol, or big endian for the direct TCP protocol.
+         *
          * @param data A pointer to the WebSocket Streaming Protocol packet data. The data may be
          *     truncated; i.e., it is safe to call this function even if it's not known whether
          *     the data contains a complete and valid packet. In this case the returned
          *     decoded_header::header_size member is set to 0 (see the Returns description).
          * @param size The size of the data pointed to by @p data in bytes.
-         * @param use_tcp_protocol True to use the direct TCP protocol instead of the WebSocket
-         *     protocol.
          *
          * @return A decoded_header structure containing the values of the packet's fields. If the
          *     pointed-to data contains a complete packet (including payload), the returned
          *     decoded_header::header_size member is set to the actual size of the header. If the
          *     data is truncated, the returned decoded_header::header_size member is set to 0.
          */
+        template <boost::endian::order Order>
+        inline decoded_header decode_header(
+            const std::uint8_t *data,
+            std::size_t size) noexcept
+        {
+            decoded_header header { };
+
+            if (size < sizeof(std::uint32_t))
+                return header;
+
+            std::uint32_t word = boost::endian::endian_load<std::uint32_t, sizeof(std::uint32_t), Order>(data);
+
+            header.type = word >> 28;
+            header.signo = word & 0xFFFFFu;
+            header.payload_size = (word >> 20) & 0xFFu;
+            std::size_t header_size = sizeof(std::uint32_t);
+
+            if (header.payload_size == 0)
+            {
+                if (size < 2 * sizeof(std::uint32_t))
+                    return header;
+
+                header.payload_size = boost::endian::endian_load<std::uint32_t, sizeof(std::uint32_t), Order>(
+                    data + sizeof(std::uint32_t));
+                header_size += sizeof(std::uint32_t);
+            }
+
+            if (size - header_size >= header.payload_size)
+                header.header_size = header_size;
+
+            return header;
+        }
+
+        /**
+         * Describes the location of a WebSocket Streaming Protocol packet found by
+         * scan_packets().
+         */
+        struct packet_descriptor
+        {
+            unsigned signo;                             /**< The signal number, which may be zero for metadata. */
+            unsigned type;                              /**< The type of packet; see packet_type for possible values. */
+            std::size_t offset;                         /**< The offset of the payload from the beginning of the scanned data, in bytes. */
+            std::size_t payload_size;                   /**< The size of the payload in bytes. */
+        };
+
+        /**
+         * The result of a call to scan_packets().
+         */
+        struct scan_result
+        {
+            std::size_t packet_count;                   /**< The number of packet descriptors populated. */
+            std::size_t bytes_scanned;                  /**< The number of bytes occupied by the described packets. */
+        };
+
+        /**
+         * Scans a buffer of consecutive WebSocket Streaming Protocol packets, populating an array
+         * of packet descriptors in a single pass. Scanning stops when the array is full, when the
+         * remaining data does not contain a complete packet, or after a metadata packet.
+         * Metadata packets end a scan because processing them can change how subsequent data
+         * must be interpreted.
+         *
+         * @perfcrit This function is called once for every batch of received packets when using
+         *     the direct TCP protocol.
+         *
+         * @tparam Order The byte order of the header fields.
+         *
+         * @param data A pointer to the data to scan.
+         * @param size The size of the data pointed to by @p data in bytes.
+         * @param descriptors A pointer to an array of descriptors to populate.
+         * @param max_descriptors The number of elements in the array pointed to by
+         *     @p descriptors.
+         *
+         * @return The number of populated descriptors and the number of bytes they occupy. If no
+         *     complete packet was found, both are zero.
+         */
+        template <boost::endian::order Order>
+        inline scan_result scan_packets(
+            const std::uint8_t *data,
+            std::size_t size,
+            packet_descriptor *descriptors,
+            std::size_t max_descriptors) noexcept
+        {
+            // A packet with a short-form header is at most this many bytes.
+            constexpr std::size_t MAX_SHORT_PACKET_SIZE = sizeof(std::uint32_t) + 255;
+
+            std::size_t offset = 0;
+            std::size_t count = 0;
+
+            while (count < max_descriptors)
+            {
+                // Fast path: if enough data remains to hold any packet with a short-form header,
+                // and this packet has one, no truncation checks are needed.
+                if (size - offset >= MAX_SHORT_PACKET_SIZE)
+                {
+                    std::uint32_t word = boost::endian::endian_load<std::uint32_t, sizeof(std::uint32_t), Order>(data + offset);
+                    std::size_t payload_size = (word >> 20) & 0xFFu;
+
+                    if (payload_size)
+                    {
+                        unsigned type = word >> 28;
+
+                        descriptors[count++] = {
+                            word & 0xFFFFFu,
+                            type,
+                            offset + sizeof(std::uint32_t),
+                            payload_size
+                        };
+
+                        offset += sizeof(std::uint32_t) + payload_size;
+
+                        if (type == packet_type::METADATA)
+                            break;
+
+                        continue;
+                    }
+                }
+
+                auto header = decode_header<Order>(data + offset, size - offset);
+                if (!header.header_size)
+                    break;
+
+                descriptors[count++] = {
+                    header.signo,
+                    header.type,
+                    offset + header.header_size,
+                    header.payload_size
+                };
+
+                offset += header.header_size + header.payload_size;
+
+                if (header.type == packet_type::METADATA)
+                    break;
+            }
+
+            return { count, offset };
+        }
+
+        /**
+         * Populates the table at the beginning of an aggregate packet's payload.
+         *
+         * @tparam Order The byte order of the table fields, which must match that of the packet
+         *     header.
+         *
+         * @param table A pointer to memory to populate with the table. The pointed-to area must
+         *     be at least aggregate_table_size(@p entry_count) bytes.
+         * @param entries A pointer to an array of entries describing the packet's contents.
+         * @param entry_count The number of entries pointed to by @p entries.
+         *
+         * @return The size of the generated table in bytes.
+         */
+        template <boost::endian::order Order>
+        inline std::size_t generate_aggregate_table(
+            std::uint8_t *table,
+            const aggregate_entry *entries,
+            std::size_t entry_count) noexcept
+        {
+            boost::endian::endian_store<std::uint32_t, sizeof(std::uint32_t), Order>(
+                table,
+                static_cast<std::uint32_t>(entry_count));
+            table += sizeof(std::uint32_t);
+
+            for (std::size_t i = 0; i < entry_count; ++i)
+            {
+                boost::endian::endian_store<std::uint32_t, sizeof(std::uint32_t), Order>(
+                    table,
+                    entries[i].signo);
+                boost::endian::endian_store<std::uint32_t, sizeof(std::uint32_t), Order>(
+                    table + sizeof(std::uint32_t),
+                    static_cast<std::uint32_t>(entries[i].size));
+                table += 2 * sizeof(std::uint32_t);
+            }
+
+            return aggregate_table_size(entry_count);
+        }
+
+        /**
+         * Splits the payload of an aggregate packet into the data of its individual signals.
+         * The whole table is validated before @p handler is invoked for any entry, so a
+         * malformed packet is either processed completely or not at all.
+         *
+         * @tparam Order The byte order of the table fields.
+         * @tparam Handler A callable object with the signature
+         *     `void(unsigned signo, const std::uint8_t *data, std::size_t size)`.
+         *
+         * @param data A pointer to the aggregate packet's payload.
+         * @param size The size of the payload pointed to by @p data in bytes.
+         * @param handler The handler to invoke for each entry, in order.
+         *
+         * @return True if the payload was valid, or false if it was malformed.
+         */
+        template <boost::endian::order Order, typename Handler>
+        bool split_aggregate(
+            const std::uint8_t *data,
+            std::size_t size,
+            Handler&& handler)
+        {
+            if (size < sizeof(std::uint32_t))
+                return false;
+
+            std::size_t entry_count = boost::endian::endian_load<std::uint32_t, sizeof(std::uint32_t), Order>(data);
+            if (entry_count > (size - sizeof(std::uint32_t)) / (2 * sizeof(std::uint32_t)))
+                return false;
+
+            const std::uint8_t *table = data + sizeof(std::uint32_t);
+            std::size_t table_size = aggregate_table_size(entry_count);
+            std::size_t data_size = 0;
+
+            for (std::size_t i = 0; i < entry_count; ++i)
+                data_size += boost::endian::endian_load<std::uint32_t, sizeof(std::uint32_t), Order>(
+                    table + i * 2 * sizeof(std::uint32_t) + sizeof(std::uint32_t));
+
+            if (data_size != size - table_size)
+                return false;
+
+            const std::uint8_t *entry_data = data + table_size;
+
+            for (std::size_t i = 0; i < entry_count; ++i)
+            {
+                unsigned signo = boost::endian::endian_load<std::uint32_t, sizeof(std::uint32_t), Order>(
+                    table + i * 2 * sizeof(std::uint32_t));
+                std::size_t entry_size = boost::endian::endian_load<std::uint32_t, sizeof(std::uint32_t), Order>(
+                    table + i * 2 * sizeof(std::uint32_t) + sizeof(std::uint32_t));
+
+                handler(signo, entry_data, entry_size);
+                entry_data += entry_size;
+            }
+
+            return true;
+        }
+
+        /**
+         * Decodes a WebSocket Streaming Protocol packet header, selecting the byte order at run
+         * time. Performance-critical code should call the byte-order-specific overload instead.
+         *
+         * @param data A pointer to the WebSocket Streaming Protocol packet data. The data may be
+         *     truncated, as for the byte-order-specific overload.
+         * @param size The size of the data pointed to by @p data in bytes.
+         * @param use_tcp_protocol True to use the direct TCP protocol instead of the WebSocket
+         *     protocol.
+         *
+         * @return A decoded_header structure containing the values of the packet's fields, as for
+         *     the byte-order-specific overload.
+         */
         decoded_header decode_header(
             const std::uint8_t *data,
             std::size_t size,
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace wss::detail
+{
+    /**
+     * Allocates memory for outgoing signal data from reference-counted slabs. Each allocation
+     * holds a reference to its slab, and the slab is reused once every allocation carved from
+     * it, and every reference held by connections still transmitting from it, has been released.
+     * In the steady state, this allows applications to write samples directly into memory from
+     * which every connection then transmits, without allocating or copying.
+     *
+     * When the last reference to a slab is released, the slab is pushed onto a lock-free list
+     * with release ordering, and the arena takes it back with acquire ordering before reusing
+     * it, so that writes to a reused slab cannot race with a connection's last reads from it.
+     * The reference count of a slab's shared pointer lives in the slab itself, so reusing a slab
+     * does not allocate either. At most MAX_SPARE_SLABS released slabs are retained; slabs
+     * beyond that, and dedicated slabs for large requests, are freed.
+     *
+     * This class is not thread-safe: allocate() and trim() must not be called concurrently.
+     * However, references to allocations may be released from any thread.
+     */
+    class transmit_arena
+    {
+        public:
+
+            /**
+             * The default size of each slab in bytes.
+             */
+            static constexpr std::size_t DEFAULT_SLAB_SIZE = 1024 * 1024;
+
+            /**
+             * The alignment of each allocation in bytes.
+             */
+            static constexpr std::size_t ALIGNMENT = 16;
+
+            /**
+             * The maximum number of released slabs retained for reuse.
+             */
+            static constexpr std::size_t MAX_SPARE_SLABS = 4;
+
+            /**
+             * Constructs an arena. No memory is allocated until allocate() is called.
+             *
+             * @param slab_size The size of each slab in bytes. Requests larger than this are
+             *     satisfied using dedicated slabs.
+             */
+            explicit transmit_arena(std::size_t slab_size = DEFAULT_SLAB_SIZE);
+
+            transmit_arena(const transmit_arena&) = delete;
+            transmit_arena& operator=(const transmit_arena&) = delete;
+
+            /**
+             * Destroys the arena. Slabs still referenced by allocations are freed once released.
+             */
+            ~transmit_arena();
+
+            /**
+             * Allocates memory from the arena.
+             *
+             * @param size The number of bytes to allocate.
+             *
+             * @return A pointer to the allocated memory, which shares ownership of the slab
+             *     containing it.
+             */
+            std::shared_ptr<std::uint8_t> allocate(std::size_t size);
+
+            /**
+             * Returns the unused end of the most recent allocation to the arena. This has no
+             * effect if other memory has been allocated since.
+             *
+             * @param allocation A pointer to the allocation, as returned by allocate().
+             * @param old_size The size passed to allocate().
+             * @param new_size The number of bytes of the allocation that remain in use.
+             */
+            void trim(
+                const std::uint8_t *allocation,
+                std::size_t old_size,
+                std::size_t new_size) noexcept;
+
+        private:
+
+            struct slab;
+            struct slab_list;
+
+            template <typename T>
+            struct slab_allocator;
+
+            std::shared_ptr<slab> acquire_slab(std::size_t size);
+
+            std::size_t _slab_size;
+            std::shared_ptr<slab_list> _released;
+            std::vector<std::unique_ptr<slab>> _spare;
+            std::shared_ptr<slab> _current;
+            std::size_t _offset = 0;
+    };
+}
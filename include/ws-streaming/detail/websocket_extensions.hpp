@@ -0,0 +1,108 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace wss::detail
+{
+    /**
+     * Describes the WebSocket extensions (see section 9 of RFC 6455) offered or supported by one
+     * side of a connection, or agreed on by both, and implements their negotiation in the HTTP
+     * upgrade handshake. A client sends the value of offer() in the Sec-WebSocket-Extensions
+     * request header; the server replies with the extensions it accepts, as determined by
+     * negotiate(), in the Sec-WebSocket-Extensions response header; and the client validates the
+     * reply with accept().
+     */
+    struct websocket_extensions
+    {
+        /**
+         * The extension token of the block compression extension, a private extension of this
+         * library. If both peers agree on it, either may transmit a block of consecutive
+         * WebSocket frames as a single binary frame with the RSV2 bit set, whose payload is
+         * the block compressed by a block_compressor.
+         */
+        static constexpr const char *BLOCK_COMPRESSION = "x-wss-lz4";
+
+        /**
+         * The extension token of the standard per-message deflate extension (see RFC 7692),
+         * which browsers and many third-party WebSocket clients offer. If both peers agree on
+         * it, either may transmit a message compressed with DEFLATE, with the RSV1 bit set.
+         */
+        static constexpr const char *PERMESSAGE_DEFLATE = "permessage-deflate";
+
+        /**
+         * The smallest LZ77 window size (as a base-2 logarithm) with which we can compress.
+         * Offers that limit the server to a smaller window are declined, and clients that are
+         * limited to a smaller window transmit uncompressed messages.
+         */
+        static constexpr unsigned MIN_WINDOW_BITS = 9;
+
+        /**
+         * The largest LZ77 window size (as a base-2 logarithm) permitted by RFC 7692.
+         */
+        static constexpr unsigned MAX_WINDOW_BITS = 15;
+
+        bool block_compression = false;     /**< True if block compression is offered, supported or agreed on. */
+        bool permessage_deflate = false;    /**< True if per-message deflate is offered, supported or agreed on. */
+
+        /**
+         * True if the server must (or, in an offer, is asked to) reset its compression context
+         * after each message. A server also sets this if it does not wish to use context
+         * takeover, even if the client does not ask.
+         */
+        bool server_no_context_takeover = false;
+
+        /**
+         * True if the client must (or, in an offer, is asked to) reset its compression context
+         * after each message.
+         */
+        bool client_no_context_takeover = false;
+
+        /**
+         * The largest LZ77 window size, as a base-2 logarithm, the server may use to compress.
+         */
+        unsigned server_max_window_bits = MAX_WINDOW_BITS;
+
+        /**
+         * The largest LZ77 window size, as a base-2 logarithm, the client may use to compress.
+         */
+        unsigned client_max_window_bits = MAX_WINDOW_BITS;
+
+        /**
+         * Generates the value of the Sec-WebSocket-Extensions header with which a client offers
+         * the extensions described by this object.
+         *
+         * @return The header value, or an empty string if no extensions are offered.
+         */
+        std::string offer() const;
+
+        /**
+         * Determines the extensions a server accepts.
+         *
+         * @param offer The value of the client's Sec-WebSocket-Extensions request header.
+         * @param supported The extensions supported by the server.
+         * @param response A string in which to store the value of the Sec-WebSocket-Extensions
+         *     response header. An empty string means the header should be omitted.
+         *
+         * @return The extensions agreed on.
+         */
+        static websocket_extensions negotiate(
+            const std::string& offer,
+            const websocket_extensions& supported,
+            std::string& response);
+
+        /**
+         * Determines the extensions agreed on from a server's response.
+         *
+         * @param response The value of the server's Sec-WebSocket-Extensions response header.
+         * @param offered The extensions offered by the client.
+         *
+         * @return The extensions agreed on, or std::nullopt if the server accepted an extension
+         *     or parameter that was not offered, in which case the client must fail the
+         *     connection.
+         */
+        static std::optional<websocket_extensions> accept(
+            const std::string& response,
+            const websocket_extensions& offered);
+    };
+}
@@ -3,6 +3,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <optional>
 #include <string>
 
@@ -30,6 +31,9 @@ namespace wss::detail
         namespace flags
         {
             constexpr unsigned FIN = 0x80;  /**< Identifies the last fragment in a sequence. */
+            constexpr unsigned RSV1 = 0x40; /**< Reserved for use by a negotiated extension. */
+            constexpr unsigned RSV2 = 0x20; /**< Reserved for use by a negotiated extension (block compression). */
+            constexpr unsigned RSV3 = 0x10; /**< Reserved for use by a negotiated extension. */
         }
 
         /**
@@ -109,6 +113,8 @@ namespace wss::detail
         /**
          * Decodes a WebSocket frame header.
          *
+         * @perfcrit This function is called once for every received WebSocket frame.
+         *
          * @param data A pointer to the WebSocket frame data. The data may be truncated; i.e., it
          *     is safe to call this function even if it's not known whether the data contains a
          *     complete and valid frame. In this case the returned decoded_header::header_size
@@ -120,7 +126,73 @@ namespace wss::detail
          *     decoded_header::header_size member is set to the actual size of the header. If the
          *     data is truncated, the returned decoded_header::header_size member is set to 0.
          */
-        decoded_header decode_header(const std::uint8_t *data, std::size_t size) noexcept;
+        inline decoded_header decode_header(const std::uint8_t *data, std::size_t size) noexcept
+        {
+            decoded_header header { };
+            const std::uint8_t *data_begin = data;
+
+            if (size < 2)
+                return header;
+
+            header.opcode = data[0] & 0xF;
+            header.flags = data[0] & 0xF0;
+            header.is_masked = 0 != (data[1] & 0x80);
+            header.payload_size = data[1] & 0x7F;
+
+            data += 2;
+            size -= 2;
+
+            if (header.payload_size == 126)
+            {
+                if (size < sizeof(std::uint16_t))
+                    return header;
+
+                header.payload_size =
+                    (static_cast<std::uint16_t>(data[0]) << 8) |
+                    data[1];
+
+                data += sizeof(std::uint16_t);
+                size -= sizeof(std::uint16_t);
+            }
+
+            else if (header.payload_size == 127)
+            {
+                if (size < sizeof(std::uint64_t))
+                    return header;
+
+                header.payload_size =
+                    (static_cast<std::uint64_t>(data[0]) << 56) |
+                    (static_cast<std::uint64_t>(data[1]) << 48) |
+                    (static_cast<std::uint64_t>(data[2]) << 40) |
+                    (static_cast<std::uint64_t>(data[3]) << 32) |
+                    (static_cast<std::uint64_t>(data[4]) << 24) |
+                    (static_cast<std::uint64_t>(data[5]) << 16) |
+                    (static_cast<std::uint64_t>(data[6]) << 8) |
+                    data[7];
+
+                data += sizeof(std::uint64_t);
+                size -= sizeof(std::uint64_t);
+            }
+
+            if (header.is_masked)
+            {
+                if (size < header.masking_key.size())
+                    return header;
+
+                std::memcpy(
+                    header.masking_key.data(),
+                    data,
+                    header.masking_key.size());
+
+                data += header.masking_key.size();
+                size -= header.masking_key.size();
+            }
+
+            if (size >= header.payload_size)
+                header.header_size = data - data_begin;
+
+            return header;
+        }
 
         /**
          * Calculates the correct Sec-WebSocket-Accept HTTP header value for an HTTP WebSocket
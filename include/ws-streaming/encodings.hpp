@@ -0,0 +1,19 @@
+#pragma once
+
+namespace wss
+{
+    /**
+     * Contains constants for the lossless payload encoding strings supported by this library.
+     * Payload encodings are a library extension to the WebSocket Streaming Protocol. An
+     * application requests an encoding for an explicit-rule signal by declaring it in the
+     * signal's metadata using metadata_builder::encoding(). Data is only encoded for remote
+     * peers that also support payload encodings; other peers receive unencoded data, and
+     * metadata without the encoding declaration.
+     */
+    namespace encodings
+    {
+        static constexpr const char *delta = "delta";                   /**< Integer samples are transmitted as bit-packed differences between consecutive samples. */
+        static constexpr const char *delta_of_delta = "deltaOfDelta";   /**< Integer samples are transmitted as bit-packed second differences; suited to explicit timestamps. */
+        static constexpr const char *xor_float = "xor";                 /**< Floating-point samples are transmitted as Gorilla-style XORs with the preceding sample. */
+    };
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstdint>
+
+namespace wss
+{
+    /**
+     * An exact, unsigned fixed-point time value with 64 integer bits and 64 fractional bits of
+     * seconds, in the style of the NTP date format. Time values can be converted exactly to and
+     * from integer counts of ticks of any rational tick resolution, such as the tick resolution
+     * of a domain signal. Conversions use fixed-size integer arithmetic and never allocate
+     * memory.
+     *
+     * The library uses this class to interpret the time and signal rate messages of direct TCP
+     * protocol devices. Applications can use it to convert domain values between tick
+     * resolutions.
+     */
+    class fixed_point_time
+    {
+        public:
+
+            /**
+             * Constructs a time value of zero.
+             */
+            constexpr fixed_point_time() noexcept = default;
+
+            /**
+             * Constructs a time value from its integer and fractional parts.
+             *
+             * @param seconds The integer part of the time value, in seconds.
+             * @param fraction The fractional part of the time value, in units of 2^-64 seconds.
+             */
+            constexpr fixed_point_time(std::uint64_t seconds, std::uint64_t fraction = 0) noexcept
+                : _seconds(seconds)
+                , _fraction(fraction)
+            {
+            }
+
+            /**
+             * Constructs a time value from an NTP-style 32.32 fixed-point timestamp.
+             *
+             * @param seconds The integer part of the timestamp, in seconds.
+             * @param fraction The fractional part of the timestamp, in units of 2^-32 seconds.
+             *
+             * @return The time value.
+             */
+            static constexpr fixed_point_time from_ntp(
+                std::uint32_t seconds,
+                std::uint32_t fraction) noexcept
+            {
+                return { seconds, std::uint64_t{fraction} << 32 };
+            }
+
+            /**
+             * Converts a count of ticks to a time value, rounding down to the nearest 2^-64
+             * seconds.
+             *
+             * @param ticks The count of ticks.
+             * @param numerator The numerator of the tick resolution in seconds.
+             * @param denominator The denominator of the tick resolution in seconds.
+             *
+             * @return The time value, saturated to the largest representable value if it is
+             *     out of range, or zero if @p denominator is zero.
+             */
+            static fixed_point_time from_ticks(
+                std::uint64_t ticks,
+                std::uint64_t numerator,
+                std::uint64_t denominator) noexcept;
+
+            /**
+             * Gets the integer part of the time value.
+             *
+             * @return The integer part of the time value, in seconds.
+             */
+            constexpr std::uint64_t seconds() const noexcept
+            {
+                return _seconds;
+            }
+
+            /**
+             * Gets the fractional part of the time value.
+             *
+             * @return The fractional part of the time value, in units of 2^-64 seconds.
+             */
+            constexpr std::uint64_t fraction() const noexcept
+            {
+                return _fraction;
+            }
+
+            /**
+             * Converts the time value (optionally divided by an integer) to a count of ticks,
+             * rounding down.
+             *
+             * @param numerator The numerator of the tick resolution in seconds.
+             * @param denominator The denominator of the tick resolution in seconds.
+             * @param divisor An integer by which the time value is divided before conversion,
+             *     such as a number of samples spanned by the time value. The division is exact.
+             *
+             * @return The count of ticks, saturated to the largest representable value if it is
+             *     out of range, or zero if @p numerator or @p divisor is zero.
+             */
+            std::uint64_t to_ticks(
+                std::uint64_t numerator,
+                std::uint64_t denominator,
+                std::uint64_t divisor = 1) const noexcept;
+
+            /**
+             * Converts the time value (optionally divided by an integer) to a count of ticks,
+             * rounding to the nearest tick. Halfway cases are rounded up.
+             *
+             * @param numerator The numerator of the tick resolution in seconds.
+             * @param denominator The denominator of the tick resolution in seconds.
+             * @param divisor An integer by which the time value is divided before conversion,
+             *     such as a number of samples spanned by the time value. The division is exact.
+             *
+             * @return The count of ticks, saturated to the largest representable value if it is
+             *     out of range, or zero if @p numerator or @p divisor is zero.
+             */
+            std::uint64_t to_ticks_rounded(
+                std::uint64_t numerator,
+                std::uint64_t denominator,
+                std::uint64_t divisor = 1) const noexcept;
+
+            /**
+             * Adds two time values. The result wraps around modulo 2^64 seconds.
+             */
+            constexpr fixed_point_time operator+(const fixed_point_time& rhs) const noexcept
+            {
+                std::uint64_t fraction = _fraction + rhs._fraction;
+                return { _seconds + rhs._seconds + (fraction < _fraction), fraction };
+            }
+
+            /**
+             * Subtracts two time values. The result wraps around modulo 2^64 seconds.
+             */
+            constexpr fixed_point_time operator-(const fixed_point_time& rhs) const noexcept
+            {
+                return { _seconds - rhs._seconds - (_fraction < rhs._fraction), _fraction - rhs._fraction };
+            }
+
+            /**
+             * Compares two time values for equality.
+             */
+            constexpr bool operator==(const fixed_point_time& rhs) const noexcept
+            {
+                return _seconds == rhs._seconds && _fraction == rhs._fraction;
+            }
+
+            /**
+             * Compares two time values for inequality.
+             */
+            constexpr bool operator!=(const fixed_point_time& rhs) const noexcept
+            {
+                return !(*this == rhs);
+            }
+
+            /**
+             * Tests whether this time value precedes another.
+             */
+            constexpr bool operator<(const fixed_point_time& rhs) const noexcept
+            {
+                return _seconds < rhs._seconds
+                    || (_seconds == rhs._seconds && _fraction < rhs._fraction);
+            }
+
+        private:
+
+            std::uint64_t _seconds = 0;
+            std::uint64_t _fraction = 0;
+    };
+}
@@ -2,16 +2,49 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <string>
+#include <type_traits>
+#include <utility>
 
+#include <boost/asio/buffer.hpp>
 #include <boost/signals2/signal.hpp>
 
 #include <ws-streaming/metadata.hpp>
+#include <ws-streaming/detail/broadcast_ring.hpp>
+#include <ws-streaming/detail/deadband_filter.hpp>
+#include <ws-streaming/detail/last_value_cache.hpp>
+#include <ws-streaming/detail/transmit_arena.hpp>
+
+namespace wss::detail
+{
+    template <typename BufferRange>
+    using enable_if_buffer_range = std::enable_if_t<
+        std::is_convertible_v<
+            decltype(std::data(std::declval<const BufferRange&>())),
+            const boost::asio::const_buffer *>>;
+}
 
 namespace wss
 {
+    /**
+     * Statistics describing how published domain values have been transmitted for a signal with
+     * an associated linear-rule domain signal. These are totals across every connection to
+     * which the signal's data has been transmitted. Instances are returned by
+     * local_signal::domain_statistics().
+     */
+    struct domain_sync_statistics
+    {
+        std::uint64_t blocks;       /**< The number of published blocks whose domain value was checked. */
+        std::uint64_t resyncs;      /**< The number of blocks for which a domain data packet was transmitted. */
+        std::uint64_t max_error;    /**< The largest deviation tolerated without transmitting a domain data packet, in ticks. */
+    };
+
     /**
      * Represents a signal, sourced by the application, which can be streamed. This class
      * encapsulates the interactions between an application that generates data to be streamed and
@@ -26,6 +59,18 @@ namespace wss
      * concurrently. However, calls need not be synchronized with streaming endpoints. In
      * particular, it is safe to call publish_data() from an acquisition loop thread, so
      * long as no other application threads concurrently call local_signal member functions.
+     *
+     * By default, publishing data synchronously raises the on_data_published event, whose
+     * handlers may lock mutexes, allocate memory and write to sockets. Signals published from
+     * real-time threads should instead enable a broadcast ring by calling
+     * enable_broadcast_ring(). The publish_data() and commit() functions of such signals,
+     * including the overloads taking reference-counted buffers, never allocate memory, never
+     * block on a lock and never make a system call, so they can safely be called from a thread
+     * with a real-time scheduling policy. The reserve() function only allocates memory while
+     * the signal's transmit arena has no released slab to reuse, i.e. during the first calls
+     * and whenever every retained slab is still referenced; once the arena has warmed up, it is
+     * real-time-safe too. Enabling the last-value cache (see set_last_value_cache()) makes
+     * every publish take a mutex, so signals with the cache enabled are not real-time-safe.
      */
     class local_signal
     {
@@ -99,6 +144,344 @@ namespace wss
                 std::size_t size)
                 noexcept;
 
+            /**
+             * Publishes data held in a reference-counted buffer to the signal. This behaves as
+             * publish_data(const void *, std::size_t), except that streaming endpoints that
+             * cannot transmit the data immediately hold a reference to @p data until it has been
+             * transmitted, instead of copying it. The buffer is released when the last such
+             * reference is dropped, which allows, for example, DMA buffers to be returned to a
+             * pool by a custom deleter once every connection has sent them.
+             *
+             * @param data A pointer to the data to publish. The data must not be modified after
+             *     this function is called. The std::shared_ptr aliasing constructor can be used
+             *     to publish part of a larger buffer.
+             * @param size The number of bytes pointed to by @p data.
+             */
+            void publish_data(
+                const std::shared_ptr<const void>& data,
+                std::size_t size)
+                noexcept;
+
+            /**
+             * Publishes data held in a reference-counted buffer to the signal with an associated
+             * linear-rule domain signal. This behaves as
+             * publish_data(std::int64_t, std::size_t, const void *, std::size_t), except that
+             * the buffer is referenced rather than copied, as for
+             * publish_data(const std::shared_ptr<const void>&, std::size_t).
+             *
+             * @param domain_value The domain value associated with this data.
+             * @param sample_count The number of samples contained in the data pointed to by
+             *     @p data.
+             * @param data A pointer to the data to publish. The data must not be modified after
+             *     this function is called.
+             * @param size The number of bytes pointed to by @p data.
+             */
+            void publish_data(
+                std::int64_t domain_value,
+                std::size_t sample_count,
+                const std::shared_ptr<const void>& data,
+                std::size_t size)
+                noexcept;
+
+            /**
+             * Memory reserved for data to be published by a later call to commit(). Instances of
+             * this class are returned by reserve().
+             */
+            class reservation
+            {
+                public:
+
+                    /**
+                     * Constructs an empty reservation.
+                     */
+                    reservation() = default;
+
+                    /**
+                     * Gets a pointer to the reserved memory, into which the application should
+                     * write the data to publish.
+                     *
+                     * @return A pointer to the reserved memory, or null if this reservation is
+                     *     empty.
+                     */
+                    void *data() const noexcept
+                    {
+                        return _data.get();
+                    }
+
+                    /**
+                     * Gets the size of the reserved memory.
+                     *
+                     * @return The number of bytes reserved.
+                     */
+                    std::size_t size() const noexcept
+                    {
+                        return _size;
+                    }
+
+                private:
+
+                    friend class local_signal;
+
+                    std::shared_ptr<std::uint8_t> _data;
+                    std::size_t _size = 0;
+            };
+
+            /**
+             * Reserves memory from which data can later be published with no further copies.
+             * The application writes data directly into the reserved memory, then calls commit()
+             * to publish it. Streaming endpoints transmit directly from the reserved memory,
+             * holding references to it if they cannot transmit immediately, as for
+             * publish_data(const std::shared_ptr<const void>&, std::size_t). The memory is
+             * recycled once every endpoint has transmitted it.
+             *
+             * @param size The number of bytes to reserve.
+             *
+             * @return The reservation.
+             */
+            reservation reserve(std::size_t size);
+
+            /**
+             * Publishes data previously written into memory obtained from reserve().
+             *
+             * @param reservation The reservation. After the call, the reservation is empty, and
+             *     the application must not write to the previously reserved memory.
+             * @param size The number of bytes to publish, which must not exceed the reserved
+             *     size. Any unused reserved memory is returned for use by subsequent
+             *     reservations if possible.
+             */
+            void commit(
+                reservation& reservation,
+                std::size_t size)
+                noexcept;
+
+            /**
+             * Publishes data previously written into memory obtained from reserve(), with an
+             * associated linear-rule domain signal. This is the reserve/commit equivalent of
+             * publish_data(std::int64_t, std::size_t, const void *, std::size_t).
+             *
+             * @param domain_value The domain value associated with this data.
+             * @param sample_count The number of samples contained in the published data.
+             * @param reservation The reservation. After the call, the reservation is empty.
+             * @param size The number of bytes to publish, which must not exceed the reserved
+             *     size.
+             */
+            void commit(
+                std::int64_t domain_value,
+                std::size_t sample_count,
+                reservation& reservation,
+                std::size_t size)
+                noexcept;
+
+            /**
+             * Publishes data gathered from multiple buffers to the signal. The buffers are
+             * transmitted as a single data packet, as if their contents had been concatenated
+             * and passed to publish_data(const void *, std::size_t), but without copying them
+             * into a contiguous staging area first. This allows, for example, a header or
+             * timestamp block and a separately allocated DMA buffer to be published together.
+             *
+             * @tparam BufferRange A contiguous range of boost::asio::const_buffer objects, such
+             *     as `std::array<boost::asio::const_buffer, N>` or
+             *     `std::vector<boost::asio::const_buffer>`.
+             *
+             * @param buffers Descriptors of the buffers to publish, in order. The buffers are
+             *     transmitted or (if necessary) buffered synchronously. The described memory
+             *     does not need to remain valid after this function returns.
+             */
+            template <typename BufferRange, typename = detail::enable_if_buffer_range<BufferRange>>
+            void publish_data(
+                const BufferRange& buffers)
+                noexcept
+            {
+                publish(0, 0, std::data(buffers), std::size(buffers), nullptr);
+            }
+
+            /**
+             * Publishes data gathered from multiple buffers to the signal with an associated
+             * linear-rule domain signal. This is the scatter-gather equivalent of
+             * publish_data(std::int64_t, std::size_t, const void *, std::size_t).
+             *
+             * @tparam BufferRange A contiguous range of boost::asio::const_buffer objects.
+             *
+             * @param domain_value The domain value associated with this data.
+             * @param sample_count The number of samples contained in the buffers described by
+             *     @p buffers.
+             * @param buffers Descriptors of the buffers to publish, in order. The described
+             *     memory does not need to remain valid after this function returns.
+             */
+            template <typename BufferRange, typename = detail::enable_if_buffer_range<BufferRange>>
+            void publish_data(
+                std::int64_t domain_value,
+                std::size_t sample_count,
+                const BufferRange& buffers)
+                noexcept
+            {
+                publish(
+                    domain_value,
+                    sample_count,
+                    std::data(buffers),
+                    std::size(buffers),
+                    nullptr);
+            }
+
+            /**
+             * Sets how far published domain values may deviate from the values implied by the
+             * associated linear-rule domain signal before the domain is resynchronized. By
+             * default, any deviation causes a domain data packet to be transmitted along with
+             * the published data. Timestamps with a few ticks of jitter therefore cause a domain
+             * data packet for nearly every block. With a nonzero tolerance, a domain data packet
+             * is only transmitted when the deviation exceeds the tolerance, so remote peers
+             * observe domain values that are never more than @p ticks from the published ones.
+             *
+             * Because the domain is resynchronized to a published (and therefore jittered)
+             * value, the tolerance should be at least the peak-to-peak jitter of the published
+             * domain values. Slow clock drift is absorbed by occasional resynchronizations.
+             *
+             * The tolerance is ignored while a deadband is enabled (see set_deadband()).
+             *
+             * @param ticks The tolerance, in ticks of the domain signal.
+             */
+            void set_domain_tolerance(std::uint64_t ticks) noexcept;
+
+            /**
+             * Gets the tolerance set by set_domain_tolerance().
+             *
+             * @return The tolerance, in ticks of the domain signal.
+             */
+            std::uint64_t domain_tolerance() const noexcept;
+
+            /**
+             * Gets statistics describing how published domain values have been transmitted.
+             *
+             * @return The statistics.
+             */
+            domain_sync_statistics domain_statistics() const noexcept;
+
+            /**
+             * Records that a published block's domain value deviated from the value implied by
+             * the linear-rule domain signal. This function is used internally by streaming
+             * endpoints with which this signal is registered.
+             *
+             * @param error The absolute deviation, in ticks.
+             * @param resynced True if a domain data packet was transmitted as a result.
+             */
+            void record_domain_sync(std::uint64_t error, bool resynced) noexcept;
+
+            /**
+             * Enables change-only transmission of a slow-moving signal. Once enabled, a
+             * published block is only transmitted if one of its samples differs from the most
+             * recently transmitted sample by more than the deadband, or if nothing has been
+             * transmitted for the heartbeat interval. Suppressed blocks are discarded before
+             * reaching any streaming endpoint or broadcast ring.
+             *
+             * Because suppressed samples leave gaps in the transmitted data, the signal should be
+             * published with domain values (using an overload of publish_data() that accepts
+             * them) against a linear-rule domain signal. Each transmitted block then carries its
+             * own domain value, so remote peers observe the correct timing. Since remote peers
+             * do not count suppressed samples, the block following a gap deviates from the
+             * domain by the length of the gap; the domain tolerance set by set_domain_tolerance()
+             * is therefore ignored while a deadband is enabled, so that any deviation causes the
+             * domain to be resynchronized. The deadband is applied to whole blocks, so signals
+             * should be published one sample at a time for the filter to be most effective.
+             *
+             * @param absolute The absolute width of the deadband, in the units of the signal's
+             *     raw (not post-scaled) values.
+             * @param relative The width of the deadband relative to the magnitude of the most
+             *     recently transmitted sample (for example, 0.01 for 1%). The larger of the
+             *     absolute and relative widths applies.
+             * @param heartbeat The interval after which a block is transmitted even if it is
+             *     within the deadband, or zero to disable the heartbeat.
+             */
+            void set_deadband(
+                double absolute,
+                double relative = 0,
+                std::chrono::steady_clock::duration heartbeat
+                    = std::chrono::steady_clock::duration::zero());
+
+            /**
+             * Disables change-only transmission enabled by set_deadband(). All subsequently
+             * published blocks are transmitted.
+             */
+            void clear_deadband() noexcept;
+
+            /**
+             * Determines whether change-only transmission has been enabled by set_deadband().
+             *
+             * @return True if a deadband is enabled.
+             */
+            bool has_deadband() const noexcept;
+
+            /**
+             * Enables or disables the last-value cache. While enabled, the most recently
+             * published (and not suppressed) block is retained along with its domain value, and
+             * streaming endpoints transmit it to each remote peer immediately after the peer
+             * subscribes, so that peers subscribing to slow signals see the current value
+             * without waiting for the next publish. Disabling the cache discards the retained
+             * block.
+             *
+             * Blocks published from reference-counted buffers are retained by reference; other
+             * blocks are copied under a lock. Publishing with the cache enabled is therefore not
+             * real-time-safe, even with a broadcast ring.
+             *
+             * @param enable True to enable the cache, or false to disable it.
+             */
+            void set_last_value_cache(bool enable);
+
+            /**
+             * Gets the block retained by the last-value cache. This function is used internally
+             * by streaming endpoints with which this signal is registered.
+             *
+             * @return The most recently published block, or std::nullopt if the cache is
+             *     disabled or nothing has been published since it was enabled.
+             */
+            std::optional<detail::last_value_cache::block> last_value() const;
+
+            /**
+             * Gets the sequence number of the block most recently published, or currently being
+             * published, through the on_data_published event. Blocks retained by the last-value
+             * cache carry the same number, so that streaming endpoints can recognize a block
+             * they have already transmitted from the cache. For signals with a broadcast ring,
+             * blocks are instead numbered by the ring position following them. This function is
+             * used internally by streaming endpoints with which this signal is registered, from
+             * handlers of the on_data_published event.
+             *
+             * @return The sequence number of the most recently published block.
+             */
+            std::uint64_t publish_sequence() const noexcept
+            {
+                return _publish_sequence;
+            }
+
+            /**
+             * Enables fan-out through a broadcast ring. Once enabled, publishing data appends it
+             * to the ring once, in constant time regardless of the number of subscribers, and
+             * the on_data_published event is no longer raised. Instead, each subscribed
+             * connection reads the ring from its own cursor, on its own execution context. A
+             * connection that falls more than the ring's capacity behind skips the data it has
+             * missed, without affecting the publisher or other connections.
+             *
+             * Connections check the ring for new data periodically, which adds up to about a
+             * millisecond of latency.
+             *
+             * Publishing to a broadcast ring is real-time-safe: it never allocates memory, never
+             * blocks on a lock and never makes a system call.
+             *
+             * This function must be called before the signal is registered with any streaming
+             * endpoint.
+             *
+             * @param capacity The capacity of the ring in bytes. Each publish_data() call
+             *     occupies its data size plus a few dozen bytes of overhead. Calls which publish
+             *     more data than the ring can hold are discarded.
+             */
+            void enable_broadcast_ring(std::size_t capacity);
+
+            /**
+             * Gets the broadcast ring enabled by enable_broadcast_ring(). This function is used
+             * internally by streaming endpoints with which this signal is registered.
+             *
+             * @return The broadcast ring, or null if it has not been enabled.
+             */
+            const std::shared_ptr<detail::broadcast_ring>& broadcast_ring() const noexcept;
+
             /**
              * Gets the signal's global identifier.
              *
@@ -148,15 +531,21 @@ namespace wss
 
             /**
              * An event raised when the application publishes signal data by calling
-             * publish_data(). This event is used internally by streaming endpoints with which
-             * this signal is registered.
+             * publish_data(), unless a broadcast ring has been enabled by calling
+             * enable_broadcast_ring(). This event is used internally by streaming endpoints with
+             * which this signal is registered.
              *
              * @param domain_value The domain value passed to publish_data(), or zero if the
              *     publish_data() overload without domain information was called.
              * @param sample_count The sample count passed to publish_data(), or zero if the
              *     publish_data() overload without domain information was called.
-             * @param data A pointer to the published data.
-             * @param size The number of bytes pointed to by @p data.
+             * @param buffers A pointer to an array of descriptors of the published data. The
+             *     contents of the described buffers, in order, form the published data.
+             * @param buffer_count The number of descriptors pointed to by @p buffers.
+             * @param owner An object keeping the described buffers alive, if the data was
+             *     published using a reference-counted buffer, or null otherwise. Handlers that
+             *     cannot consume the data before returning may retain a reference to @p owner
+             *     instead of copying the data.
              *
              * @throws ... The behavior is undefined if an attached event handler throws an
              *     exception.
@@ -165,10 +554,33 @@ namespace wss
                 void(
                     std::int64_t domain_value,
                     std::size_t sample_count,
-                    const void *data,
-                    std::size_t size)
+                    const boost::asio::const_buffer *buffers,
+                    std::size_t buffer_count,
+                    const std::shared_ptr<const void>& owner)
             > on_data_published;
 
+            /**
+             * An event raised by publish_group::publish() before publishing data for this
+             * signal as part of a group. Every such event is followed by on_group_end() once
+             * the data of every signal in the group has been published. Streaming endpoints use
+             * these events to transmit the group's data together. This event is used internally
+             * by streaming endpoints with which this signal is registered.
+             *
+             * @throws ... The behavior is undefined if an attached event handler throws an
+             *     exception.
+             */
+            boost::signals2::signal<void()> on_group_begin;
+
+            /**
+             * An event raised by publish_group::publish() after the data of every signal in a
+             * group has been published. This event is used internally by streaming endpoints
+             * with which this signal is registered.
+             *
+             * @throws ... The behavior is undefined if an attached event handler throws an
+             *     exception.
+             */
+            boost::signals2::signal<void()> on_group_end;
+
             /**
              * An RAII object which a caller can hold while a remote peer is subscribed to a
              * local_signal. Instances of this object are returned by increment_subscribe_count().
@@ -271,8 +683,30 @@ namespace wss
 
         private:
 
+            friend class publish_group;
+
+            void publish(
+                std::int64_t domain_value,
+                std::size_t sample_count,
+                const boost::asio::const_buffer *buffers,
+                std::size_t buffer_count,
+                const std::shared_ptr<const void>& owner)
+                noexcept;
+
             std::string             _id;
             wss::metadata           _metadata;
             std::atomic<unsigned>   _subscribe_count    = 0;
+            detail::transmit_arena  _arena;
+
+            std::atomic<std::uint64_t>  _domain_tolerance   = 0;
+            std::atomic<std::uint64_t>  _domain_blocks      = 0;
+            std::atomic<std::uint64_t>  _domain_resyncs     = 0;
+            std::atomic<std::uint64_t>  _domain_max_error   = 0;
+            std::atomic<bool>           _has_deadband       = false;
+            std::uint64_t               _publish_sequence   = 0;
+
+            std::shared_ptr<detail::broadcast_ring> _broadcast_ring;
+            std::optional<detail::deadband_filter>  _deadband;
+            detail::last_value_cache                _last_value;
     };
 }
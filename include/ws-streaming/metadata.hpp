@@ -60,6 +60,15 @@ namespace wss
              */
             std::string data_type() const;
 
+            /**
+             * Gets the payload encoding of the signal. The wss::encodings namespace contains
+             * constants for the encodings supported by this library.
+             *
+             * @return The payload encoding string of the signal, or an empty string if the
+             *     signal's data is not encoded.
+             */
+            std::string encoding() const;
+
             /**
              * Gets the endianness of the signal. The wss::endianness namespace contains constants
              * for the endianness strings specified by the WebSocket Streaming Protocol
@@ -121,6 +130,16 @@ namespace wss
              */
             std::string origin() const;
 
+            /**
+             * Gets the post-scaling parameters of this signal. A signal with post-scaling
+             * transmits raw values from which the physical value is calculated as
+             * raw * scale + offset.
+             *
+             * @return A pair consisting of the scale and offset, respectively, of the signal; or
+             *     std::nullopt if not set.
+             */
+            std::optional<std::pair<double, double>> post_scaling() const;
+
             /**
              * Gets the value range of this signal.
              *
@@ -66,6 +66,19 @@ namespace wss
             metadata_builder& data_type(
                 const std::string& type);
 
+            /**
+             * Requests a lossless payload encoding for the signal's data. The wss::encodings
+             * namespace contains constants for the supported encodings. Encodings apply only
+             * to explicit-rule signals of suitable data types, and only to connections with
+             * peers that support them; other data is transmitted unencoded.
+             *
+             * @param encoding The payload encoding of the signal.
+             *
+             * @return A reference to this object.
+             */
+            metadata_builder& encoding(
+                const std::string& encoding);
+
             /**
              * Sets the endianness of the signal. The wss::endianness namespace contains constants
              * for the data types specified by the WebSocket Streaming Protocol specification.
@@ -115,6 +128,19 @@ namespace wss
             metadata_builder& origin(
                 const std::string& origin);
 
+            /**
+             * Sets the post-scaling parameters of this signal. Sinks calculate the physical
+             * value of each sample as raw * scale + offset.
+             *
+             * @param scale The factor by which raw values are multiplied.
+             * @param offset The value added to scaled raw values.
+             *
+             * @return A reference to this object.
+             */
+            metadata_builder& post_scaling(
+                double scale,
+                double offset);
+
             /**
              * Sets the value range of this signal.
              *
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/typed_local_signal.hpp>
+
+namespace wss
+{
+    /**
+     * Publishes data for several local signals together. Data for each signal is added to the
+     * group by calling add(), then publish() publishes all of it at once. Streaming endpoints
+     * transmit the data of a group together, so that a remote peer never observes part of a
+     * group without the rest, and each connection transmits the whole group using as few system
+     * calls as possible. This is particularly useful for explicit-rule signals, whose value and
+     * domain data must otherwise be published by separate calls.
+     *
+     * Groups can be reused: publish() clears the group, retaining its allocated storage.
+     *
+     * The same thread-safety rules apply to this class as to local_signal. In particular, the
+     * application must not call member functions of the signals in the group concurrently with
+     * publish().
+     *
+     * If every signal in the group has a broadcast ring enabled, and the group's storage has
+     * been allocated in advance by calling reserve(), adding data to the group and publishing
+     * it are real-time-safe, as described for local_signal.
+     */
+    class publish_group
+    {
+        public:
+
+            /**
+             * Adds data to be published for a signal, as for local_signal::publish_data().
+             *
+             * @param signal The signal for which to publish the data.
+             * @param data A pointer to the data to publish. The data is not copied, and must
+             *     remain valid until publish() returns.
+             * @param size The number of bytes pointed to by @p data.
+             */
+            void add(local_signal& signal, const void *data, std::size_t size);
+
+            /**
+             * Adds data to be published for a signal with an associated linear-rule domain
+             * signal, as for the corresponding local_signal::publish_data() overload.
+             *
+             * @param signal The signal for which to publish the data.
+             * @param domain_value The domain value associated with the first sample.
+             * @param sample_count The number of samples contained in the data.
+             * @param data A pointer to the data to publish. The data is not copied, and must
+             *     remain valid until publish() returns.
+             * @param size The number of bytes pointed to by @p data.
+             */
+            void add(
+                local_signal& signal,
+                std::int64_t domain_value,
+                std::size_t sample_count,
+                const void *data,
+                std::size_t size);
+
+            /**
+             * Adds a single sample to be published for a typed signal.
+             *
+             * @param signal The signal for which to publish the sample.
+             * @param sample The sample to publish. The sample is not copied, and must remain
+             *     valid until publish() returns.
+             */
+            template <typename T>
+            void add(typed_local_signal<T>& signal, const T& sample)
+            {
+                add(signal, &sample, sizeof(T));
+            }
+
+            /**
+             * Temporaries cannot be added, because the group keeps a reference to each sample
+             * until publish() returns.
+             */
+            template <typename T>
+            void add(typed_local_signal<T>& signal, const T&& sample) = delete;
+
+            /**
+             * Allocates storage for the specified number of add() calls, so that adding up to
+             * that much data to the group does not allocate memory.
+             *
+             * @param count The number of add() calls for which to allocate storage.
+             */
+            void reserve(std::size_t count);
+
+            /**
+             * Publishes the data of every signal in the group, in the order in which it was
+             * added, and clears the group.
+             */
+            void publish() noexcept;
+
+            /**
+             * Removes all data from the group without publishing it.
+             */
+            void clear() noexcept;
+
+            /**
+             * Tests whether the group contains any data.
+             *
+             * @return True if the group contains no data.
+             */
+            bool empty() const noexcept;
+
+        private:
+
+            struct entry
+            {
+                local_signal *signal;
+                std::int64_t domain_value;
+                std::size_t sample_count;
+                boost::asio::const_buffer buffer;
+            };
+
+            std::vector<entry> _entries;
+    };
+}
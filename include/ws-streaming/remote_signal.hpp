@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include <boost/signals2/signal.hpp>
@@ -28,6 +29,12 @@ namespace wss
             bool is_subscribed() const noexcept;
             unsigned signo() const noexcept;
             const wss::metadata& metadata() const noexcept;
+            std::optional<std::int64_t> domain_delta() const noexcept;
+
+            bool domain_values(
+                std::int64_t domain_value,
+                std::size_t sample_count,
+                std::int64_t *output) const noexcept;
 
         protected:
 
@@ -38,6 +45,7 @@ namespace wss
             bool _is_subscribed = false;
             unsigned _signo = 0;
             wss::metadata _metadata;
+            std::optional<std::int64_t> _domain_delta;
 
         private:
 
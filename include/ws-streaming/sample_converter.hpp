@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+
+#include <ws-streaming/metadata.hpp>
+
+namespace wss
+{
+    /**
+     * Converts the raw sample data of a signal to floating-point values. The conversion is
+     * selected once from the signal's metadata, taking into account the data type, the
+     * endianness and, optionally, the post-scaling parameters of the signal. Each call then
+     * runs a tight loop specialized for that combination, which compilers can vectorize.
+     *
+     * Converters are typically constructed in an on_metadata_changed handler and used in the
+     * corresponding on_data_received handler. Conversion never allocates memory.
+     */
+    class sample_converter
+    {
+        public:
+
+            /**
+             * Constructs an invalid converter that cannot convert any data.
+             */
+            sample_converter() noexcept;
+
+            /**
+             * Constructs a converter for the samples described by the specified metadata.
+             * Signals of all fixed-size primitive data types in the wss::data_types namespace
+             * are supported. Data is assumed to be little-endian unless the metadata specifies
+             * big-endian data.
+             *
+             * @param metadata The signal metadata.
+             * @param apply_post_scaling If true and the metadata specifies post-scaling
+             *     parameters, each converted value is scaled as raw * scale + offset.
+             */
+            sample_converter(
+                const metadata& metadata,
+                bool apply_post_scaling = true);
+
+            /**
+             * Determines whether the converter supports the signal's data type.
+             *
+             * @return True if the converter can convert data.
+             */
+            bool valid() const noexcept
+            {
+                return _to_double != nullptr;
+            }
+
+            /**
+             * Gets the size in bytes of each raw sample.
+             *
+             * @return The size in bytes of each raw sample, or zero if the converter is not
+             *     valid.
+             */
+            std::size_t sample_size() const noexcept
+            {
+                return _sample_size;
+            }
+
+            /**
+             * Converts raw samples to double-precision values.
+             *
+             * @param data A pointer to @p sample_count raw samples. No alignment is required.
+             * @param sample_count The number of samples to convert.
+             * @param output A pointer to an array of at least @p sample_count values.
+             *
+             * @return True if the samples were converted, or false if the converter is not
+             *     valid.
+             */
+            bool convert(
+                const void *data,
+                std::size_t sample_count,
+                double *output) const noexcept;
+
+            /**
+             * Converts raw samples to single-precision values.
+             *
+             * @param data A pointer to @p sample_count raw samples. No alignment is required.
+             * @param sample_count The number of samples to convert.
+             * @param output A pointer to an array of at least @p sample_count values.
+             *
+             * @return True if the samples were converted, or false if the converter is not
+             *     valid.
+             */
+            bool convert(
+                const void *data,
+                std::size_t sample_count,
+                float *output) const noexcept;
+
+        private:
+
+            using to_double_function = void (*)(
+                const void *, std::size_t, double *, double, double) noexcept;
+
+            using to_float_function = void (*)(
+                const void *, std::size_t, float *, double, double) noexcept;
+
+            to_double_function _to_double = nullptr;
+            to_float_function _to_float = nullptr;
+            std::size_t _sample_size = 0;
+            double _scale = 1;
+            double _offset = 0;
+    };
+}
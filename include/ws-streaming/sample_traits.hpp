@@ -0,0 +1,238 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/struct_field_builder.hpp>
+
+namespace wss
+{
+    /**
+     * Describes a field of a structure-valued sample type. Instances are created by field() and
+     * listed in the `fields` tuple of a sample_traits specialization.
+     *
+     * @tparam Struct The structure type.
+     * @tparam Member The type of the field.
+     */
+    template <typename Struct, typename Member>
+    struct field_descriptor
+    {
+        const char *name;                       /**< The name of the field. */
+        Member Struct::*member;                 /**< A pointer to the field. */
+    };
+
+    /**
+     * Creates a descriptor for a field of a structure-valued sample type.
+     *
+     * @param name The name of the field, as it should appear in the signal metadata.
+     * @param member A pointer to the field. Fields must be arithmetic types or std::array
+     *     objects of arithmetic types.
+     *
+     * @return A descriptor for the field.
+     */
+    template <typename Struct, typename Member>
+    constexpr field_descriptor<Struct, Member> field(
+        const char *name,
+        Member Struct::*member) noexcept
+    {
+        return { name, member };
+    }
+
+    /**
+     * Describes the layout of a sample type for use with typed_local_signal. Arithmetic types
+     * are supported without further declarations. Applications can describe structure-valued
+     * sample types by specializing this template with a `static constexpr` tuple named `fields`
+     * which lists every field of the structure, in order, using field():
+     *
+     * @code
+     * template <>
+     * struct wss::sample_traits<can_message>
+     * {
+     *     static constexpr auto fields = std::make_tuple(
+     *         wss::field("ArbId", &can_message::message_id),
+     *         wss::field("Length", &can_message::payload_length),
+     *         wss::field("Data", &can_message::payload));
+     * };
+     * @endcode
+     *
+     * The structure must not contain padding, so that its in-memory representation matches the
+     * sample layout described by the signal metadata. That the fields cover the whole structure
+     * is verified at compile time. That they are listed in declaration order, each at the offset
+     * implied by the fields before it, is verified when a typed_local_signal is constructed, so
+     * that a misordered or duplicated field is detected before any data is published.
+     *
+     * @tparam T The sample type.
+     */
+    template <typename T, typename Enable = void>
+    struct sample_traits
+    {
+    };
+
+    /**
+     * Describes the layout of an arithmetic sample type.
+     *
+     * @tparam T The sample type.
+     */
+    template <typename T>
+    struct sample_traits<T, std::enable_if_t<std::is_arithmetic_v<T>>>
+    {
+        /**
+         * The WebSocket Streaming Protocol data type string corresponding to @p T.
+         */
+        static constexpr const char *data_type =
+            std::is_floating_point_v<T>
+                ? (sizeof(T) == 4 ? data_types::real32_t
+                    : sizeof(T) == 8 ? data_types::real64_t
+                    : nullptr)
+            : std::is_signed_v<T>
+                ? (sizeof(T) == 1 ? data_types::int8_t
+                    : sizeof(T) == 2 ? data_types::int16_t
+                    : sizeof(T) == 4 ? data_types::int32_t
+                    : sizeof(T) == 8 ? data_types::int64_t
+                    : nullptr)
+                : (sizeof(T) == 1 ? data_types::uint8_t
+                    : sizeof(T) == 2 ? data_types::uint16_t
+                    : sizeof(T) == 4 ? data_types::uint32_t
+                    : sizeof(T) == 8 ? data_types::uint64_t
+                    : nullptr);
+
+        static_assert(data_type != nullptr,
+            "arithmetic type has no WebSocket Streaming Protocol equivalent");
+    };
+}
+
+namespace wss::detail
+{
+    template <typename T>
+    struct field_layout
+    {
+        using element_type = T;
+        static constexpr std::size_t count = 0;
+    };
+
+    template <typename T, std::size_t N>
+    struct field_layout<std::array<T, N>>
+    {
+        using element_type = T;
+        static constexpr std::size_t count = N;
+    };
+
+    template <typename T, typename = void>
+    struct is_struct_sample : std::false_type { };
+
+    template <typename T>
+    struct is_struct_sample<T, std::void_t<decltype(sample_traits<T>::fields)>>
+        : std::true_type { };
+
+    template <typename T, typename = void>
+    struct is_arithmetic_sample : std::false_type { };
+
+    template <typename T>
+    struct is_arithmetic_sample<T, std::void_t<decltype(sample_traits<T>::data_type)>>
+        : std::true_type { };
+
+    template <typename Struct, typename Member>
+    constexpr std::size_t field_size(const field_descriptor<Struct, Member>&) noexcept
+    {
+        return sizeof(Member);
+    }
+
+    /**
+     * Computes the total size of the fields listed in a structure-valued sample type's
+     * sample_traits specialization.
+     */
+    template <typename T>
+    constexpr std::size_t struct_fields_size() noexcept
+    {
+        return std::apply([](auto... fields)
+            {
+                return (std::size_t{0} + ... + field_size(fields));
+            },
+            sample_traits<T>::fields);
+    }
+
+    /**
+     * Determines the offset of a field within its structure. Member pointers cannot be
+     * converted to offsets in constant expressions, so the field's address is taken in an
+     * uninitialized instance of the structure instead.
+     */
+    template <typename Struct, typename Member>
+    std::size_t field_offset(const field_descriptor<Struct, Member>& field) noexcept
+    {
+        union probe
+        {
+            unsigned char bytes[sizeof(Struct)];
+            Struct object;
+
+            probe() noexcept : bytes{} { }
+            ~probe() { }
+        } storage;
+
+        return static_cast<std::size_t>(
+            reinterpret_cast<const unsigned char *>(&(storage.object.*field.member))
+                - storage.bytes);
+    }
+
+    /**
+     * Determines whether the fields listed in a structure-valued sample type's sample_traits
+     * specialization are in declaration order, with each field located immediately after the
+     * previous one.
+     */
+    template <typename T>
+    bool struct_fields_contiguous() noexcept
+    {
+        return std::apply([](auto... fields)
+            {
+                std::size_t offset = 0;
+                return ((field_offset(fields) == offset
+                    && (offset += field_size(fields), true)) && ...);
+            },
+            sample_traits<T>::fields);
+    }
+
+    /**
+     * Generates the metadata description of a field of a structure-valued sample type.
+     */
+    template <typename Struct, typename Member>
+    struct_field_builder describe_field(const field_descriptor<Struct, Member>& field)
+    {
+        using layout = field_layout<Member>;
+
+        static_assert(is_arithmetic_sample<typename layout::element_type>::value,
+            "struct fields must be arithmetic types or std::array objects of arithmetic types");
+
+        struct_field_builder builder{field.name};
+        builder.data_type(sample_traits<typename layout::element_type>::data_type);
+
+        if constexpr (layout::count > 0)
+            builder.array(layout::count);
+
+        return builder;
+    }
+
+    /**
+     * Adds data type information for a sample type to a metadata_builder.
+     */
+    template <typename T>
+    void describe_sample(metadata_builder& builder)
+    {
+        if constexpr (is_struct_sample<T>::value)
+        {
+            builder.data_type(data_types::struct_t);
+
+            std::apply([&](auto... fields)
+                {
+                    (builder.struct_field(describe_field(fields)), ...);
+                },
+                sample_traits<T>::fields);
+        }
+
+        else
+            builder.data_type(sample_traits<T>::data_type);
+    }
+}
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <list>
 #include <memory>
 #include <set>
+#include <string>
 
 #include <boost/asio.hpp>
 #include <boost/signals2/signal.hpp>
@@ -16,7 +18,9 @@
 #include <ws-streaming/remote_signal.hpp>
 #include <ws-streaming/detail/connected_client.hpp>
 #include <ws-streaming/detail/connected_client_iterator.hpp>
+#include <ws-streaming/detail/deflate_pool.hpp>
 #include <ws-streaming/detail/http_client_servicer.hpp>
+#include <ws-streaming/detail/websocket_extensions.hpp>
 
 namespace wss
 {
@@ -24,7 +28,9 @@ namespace wss
      * Asynchronously accepts and manages WebSocket Streaming connections from clients. The
      * application configures the server with one or more TCP listeners by calling add_listener(),
      * or by calling add_default_listeners() to use the default port numbers specified by the
-     * WebSocket Streaming specification. It then calls run() to begin listening for connections.
+     * WebSocket Streaming specification. On platforms that support them, UNIX domain socket
+     * listeners can also be added by calling add_local_listener(), allowing same-host clients to
+     * bypass the TCP/IP stack. It then calls run() to begin listening for connections.
      *
      * A server can publish signal data to connected clients. The application should call
      * add_local_signal() for each signal to be published. Signals are advertised as available to
@@ -74,6 +80,33 @@ namespace wss
              */
             void add_listener(std::shared_ptr<listener<>> listener);
 
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+            /**
+             * Adds a listener so that the server listens on the specified UNIX domain socket
+             * path. A stale socket left behind by a previous process (one that refuses
+             * connections because nothing is listening) is removed first. Any other file at that
+             * path is left alone.
+             *
+             * This function must be called before calling run().
+             *
+             * @param path The filesystem path of the UNIX domain socket to listen on.
+             *
+             * @throws boost::system::system_error A file other than a stale socket exists at
+             *     @p path, or the path cannot be inspected, or connecting to an existing socket
+             *     fails for a reason other than the connection being refused.
+             */
+            void add_local_listener(const std::string& path);
+
+            /**
+             * Adds a UNIX domain socket listener.
+             *
+             * This function must be called before calling run().
+             *
+             * @param listener The listener object to use.
+             */
+            void add_listener(std::shared_ptr<listener<boost::asio::local::stream_protocol>> listener);
+#endif
+
             /**
              * Adds listeners for the standard port numbers specified by the WebSocket Streaming
              * Specification, namely 7414 and 7438. This function is equivalent to calling
@@ -83,6 +116,44 @@ namespace wss
              */
             void add_default_listeners();
 
+            /**
+             * Enables or disables block compression (see detail::websocket_extensions) for
+             * future WebSocket connections whose clients offer it. Block compression is disabled
+             * by default. It is adaptive, so that connections carrying incompressible data spend
+             * almost no time compressing it.
+             *
+             * @param enable True to accept block compression, or false to decline it.
+             */
+            void set_block_compression(bool enable) { _extensions.block_compression = enable; }
+
+            /**
+             * Enables or disables per-message deflate (see RFC 7692) for future WebSocket
+             * connections whose clients offer it, as browsers do. Per-message deflate is disabled
+             * by default.
+             *
+             * @param enable True to accept per-message deflate, or false to decline it.
+             * @param context_takeover True to keep the compression context from one message to
+             *     the next, which compresses better but holds a compressor for each connection.
+             *     False to compress each message independently, with a compressor borrowed only
+             *     while compressing it. Clients can ask for the latter for their own
+             *     connection, in which case it is always used.
+             */
+            void set_permessage_deflate(bool enable, bool context_takeover = true)
+            {
+                _extensions.permessage_deflate = enable;
+                _extensions.server_no_context_takeover = !context_takeover;
+            }
+
+            /**
+             * Limits the number of per-message deflate compressors (of roughly 150 KiB each)
+             * shared by all connections. Connections that cannot acquire one transmit
+             * uncompressed messages until they can.
+             *
+             * @param max_streams The maximum number of compressors. The default is
+             *     detail::deflate_pool::DEFAULT_MAX_STREAMS.
+             */
+            void set_max_deflate_streams(std::size_t max_streams) { _deflate_pool->set_max_streams(max_streams); }
+
             /**
              * Activates the server object by scheduling asynchronous I/O operations with the
              * execution context passed to the constructor. Do not call add_listener() or
@@ -226,15 +297,15 @@ namespace wss
 
         private:
 
-            void on_listener_accept(
-                boost::asio::ip::tcp::socket& socket);
+            template <typename Socket>
+            void on_listener_accept(Socket& socket);
 
             nlohmann::json on_servicer_command_interface_request(
                 const std::shared_ptr<detail::http_client_servicer>& servicer,
                 const std::string& method,
                 const nlohmann::json& params);
 
-            void on_servicer_websocket_upgrade(const std::shared_ptr<detail::http_client_servicer>& servicer, boost::asio::ip::tcp::socket& socket);
+            void on_servicer_websocket_upgrade(const std::shared_ptr<detail::http_client_servicer>& servicer, boost::asio::generic::stream_protocol::socket& socket, const detail::websocket_extensions& extensions);
             void on_servicer_closed(const std::shared_ptr<detail::http_client_servicer>& servicer, const boost::system::error_code& ec);
 
             void on_connection_available(
@@ -251,15 +322,18 @@ namespace wss
 
             struct listener_entry
             {
+                template <typename Protocol>
                 listener_entry(
-                        std::shared_ptr<listener<>> l,
+                        std::shared_ptr<listener<Protocol>> l,
                         boost::signals2::scoped_connection connection)
-                    : l(l)
+                    : run([l]() { l->run(); })
+                    , stop([l]() { l->stop(); })
                     , connection(std::move(connection))
                 {
                 }
 
-                std::shared_ptr<listener<>> l;
+                std::function<void()> run;
+                std::function<void()> stop;
                 boost::signals2::scoped_connection connection;
             };
 
@@ -291,5 +365,7 @@ namespace wss
             std::set<local_signal *> _signals;
             std::list<local_signal *> _ordered_signals;
             std::uint16_t _command_interface_port = 0;
+            detail::websocket_extensions _extensions;
+            std::shared_ptr<detail::deflate_pool> _deflate_pool = std::make_shared<detail::deflate_pool>();
     };
 }
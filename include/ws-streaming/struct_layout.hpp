@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <ws-streaming/metadata.hpp>
+
+namespace wss
+{
+    /**
+     * Describes the in-memory layout of the samples of a structure-valued signal: the offset,
+     * element type and array element count of each field. A layout is computed once from
+     * signal metadata (typically in an on_metadata_changed handler), so that received data
+     * can be interpreted without repeatedly querying the JSON-backed metadata objects.
+     *
+     * A layout can also transpose a block of received structures into one contiguous column
+     * per field with extract() or extract_columns(). Bytes are copied unchanged; if the
+     * signal's endianness differs from the host's, the caller must byte-swap the columns.
+     */
+    class struct_layout
+    {
+        public:
+
+            /**
+             * Describes the placement of one field within a structure sample.
+             */
+            struct field
+            {
+                /**
+                 * The name of the field.
+                 */
+                std::string name;
+
+                /**
+                 * The data type string of the field's elements.
+                 */
+                std::string data_type;
+
+                /**
+                 * The size in bytes of each element, or zero if the data type is not a
+                 * primitive type with a known size.
+                 */
+                std::size_t element_size;
+
+                /**
+                 * The number of elements in the field: the size of the field's linear array
+                 * dimension, or one if the field is a scalar.
+                 */
+                std::size_t count;
+
+                /**
+                 * The offset in bytes of the field from the beginning of the structure.
+                 */
+                std::size_t offset;
+
+                /**
+                 * The total size in bytes of the field (element_size * count).
+                 */
+                std::size_t size;
+            };
+
+            /**
+             * Constructs an empty layout, with no fields and a sample size of zero.
+             */
+            struct_layout();
+
+            /**
+             * Computes the layout of the samples described by the specified metadata. If the
+             * metadata does not describe a structure-valued signal, the layout is empty.
+             *
+             * @param metadata The signal metadata.
+             */
+            struct_layout(const metadata& metadata);
+
+            /**
+             * Gets the fields of the structure, in declaration order.
+             *
+             * @return A reference to the fields of the structure.
+             */
+            const std::vector<field>& fields() const noexcept
+            {
+                return _fields;
+            }
+
+            /**
+             * Looks up a field by name.
+             *
+             * @param name The name of the field.
+             *
+             * @return The index of the first field with the specified name, or std::nullopt if
+             *     there is no such field.
+             */
+            std::optional<std::size_t> find(const std::string& name) const noexcept;
+
+            /**
+             * Gets the size in bytes of each structure sample. This is equal to the value
+             * returned by metadata::sample_size() for the metadata from which the layout was
+             * computed.
+             *
+             * @return The size in bytes of each structure sample.
+             */
+            std::size_t sample_size() const noexcept
+            {
+                return _sample_size;
+            }
+
+            /**
+             * Copies one field of each of a block of structure samples into a contiguous
+             * column. The column receives fields()[field_index].size bytes per sample.
+             *
+             * @param field_index The index of the field to extract.
+             * @param samples A pointer to @p sample_count consecutive structure samples, each
+             *     sample_size() bytes in size. No alignment is required.
+             * @param sample_count The number of samples to extract.
+             * @param column A pointer to a buffer of at least
+             *     fields()[field_index].size * @p sample_count bytes. No alignment is
+             *     required.
+             */
+            void extract(
+                std::size_t field_index,
+                const void *samples,
+                std::size_t sample_count,
+                void *column) const noexcept;
+
+            /**
+             * Transposes a block of structure samples into one contiguous column per field.
+             * This is equivalent to, but faster than, calling extract() for each field.
+             *
+             * @param samples A pointer to @p sample_count consecutive structure samples, each
+             *     sample_size() bytes in size. No alignment is required.
+             * @param sample_count The number of samples to extract.
+             * @param columns An array of fields().size() pointers, each of which points to a
+             *     buffer for the corresponding field as described for extract(). A null
+             *     pointer skips the corresponding field.
+             */
+            void extract_columns(
+                const void *samples,
+                std::size_t sample_count,
+                void *const *columns) const noexcept;
+
+        private:
+
+            std::vector<field> _fields;
+            std::size_t _sample_size = 0;
+    };
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+namespace wss
+{
+    /**
+     * Contains constants for the reduced-precision transport format strings supported by this
+     * library. Transport formats are a library extension to the WebSocket Streaming Protocol. A
+     * remote peer requests a format by passing an object such as
+     * `{ "signalId": "/Value", "format": "real16" }` to the `subscribe` command interface
+     * method. The server then streams a derived signal whose samples are the source signal's
+     * post-scaled values in the requested representation.
+     */
+    namespace transport_formats
+    {
+        static constexpr const char *real32 = "real32";             /**< Samples are transmitted as 32-bit floating-point numbers. */
+        static constexpr const char *real16 = "real16";             /**< Samples are transmitted as IEEE 754 half-precision floating-point numbers. */
+        static constexpr const char *scaled_int16 = "scaledInt16";  /**< Samples are quantized over the signal's range to 16-bit integers, with post-scaling that restores their values. */
+    };
+}
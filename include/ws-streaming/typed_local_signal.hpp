@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <boost/endian/conversion.hpp>
+
+#include <ws-streaming/endianness.hpp>
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/sample_traits.hpp>
+
+namespace wss::detail
+{
+    template <typename Range, typename T>
+    using enable_if_samples = std::enable_if_t<
+        std::is_convertible_v<
+            decltype(std::data(std::declval<const Range&>())),
+            const T *>>;
+}
+
+namespace wss
+{
+    /**
+     * A local_signal whose samples are of a fixed C++ type. The data type (and for
+     * structure-valued types, the structure definition) of the signal's metadata is derived from
+     * @p T at compile time using wss::sample_traits, and data is published as arrays of @p T
+     * rather than as untyped bytes, so that the published data always consists of a whole number
+     * of samples matching the metadata.
+     *
+     * Instances can be registered with streaming endpoints in the same way as local_signal
+     * objects, and the same thread-safety rules apply.
+     *
+     * @tparam T The sample type. This must be an arithmetic type, or a trivially copyable
+     *     structure type described by a specialization of wss::sample_traits.
+     */
+    template <typename T>
+    class typed_local_signal : public local_signal
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+            "sample types must be trivially copyable");
+
+        static_assert(detail::is_arithmetic_sample<T>::value || detail::is_struct_sample<T>::value,
+            "sample types must be arithmetic types or described by a sample_traits specialization");
+
+        public:
+
+            /**
+             * The size of a single sample in bytes.
+             */
+            static constexpr std::size_t sample_size = sizeof(T);
+
+            /**
+             * Constructs a signal with the specified global identifier.
+             *
+             * @param id The signal's global identifier. The same uniqueness requirements apply
+             *     as for local_signal.
+             * @param metadata A builder object describing the signal. The data type, structure
+             *     definition and endianness are set automatically according to @p T, replacing
+             *     any values set by the caller.
+             *
+             * @throws std::invalid_argument The fields listed in the sample_traits
+             *     specialization for @p T are not in declaration order.
+             */
+            typed_local_signal(const std::string& id, metadata_builder metadata)
+                : local_signal(id, describe(metadata))
+            {
+            }
+
+            /**
+             * Sets or updates the metadata describing the signal, as for
+             * local_signal::set_metadata(). The data type, structure definition and endianness
+             * are set automatically according to @p T, replacing any values set by the caller.
+             *
+             * @param metadata A builder object describing the signal.
+             *
+             * @throws std::invalid_argument The fields listed in the sample_traits
+             *     specialization for @p T are not in declaration order.
+             */
+            void set_metadata(metadata_builder metadata)
+            {
+                local_signal::set_metadata(describe(metadata));
+            }
+
+            /**
+             * Publishes a single sample to the signal, as for local_signal::publish_data().
+             *
+             * @param sample The sample to publish.
+             */
+            void publish_data(const T& sample) noexcept
+            {
+                local_signal::publish_data(&sample, sample_size);
+            }
+
+            /**
+             * Publishes an array of samples to the signal, as for local_signal::publish_data().
+             *
+             * @param samples A pointer to the samples to publish.
+             * @param count The number of samples pointed to by @p samples.
+             */
+            void publish_data(const T *samples, std::size_t count) noexcept
+            {
+                local_signal::publish_data(samples, count * sample_size);
+            }
+
+            /**
+             * Publishes a contiguous range of samples to the signal, as for
+             * local_signal::publish_data(). Any contiguous container or view of @p T can be
+             * passed, such as `std::span<const T>`, `std::vector<T>` or `std::array<T, N>`.
+             *
+             * @param samples The samples to publish.
+             */
+            template <typename Range, typename = detail::enable_if_samples<Range, T>>
+            void publish_data(const Range& samples) noexcept
+            {
+                publish_data(std::data(samples), std::size(samples));
+            }
+
+            /**
+             * Publishes an array of samples to the signal with an associated linear-rule domain
+             * signal, as for the corresponding local_signal::publish_data() overload. The sample
+             * count is derived from @p count.
+             *
+             * @param domain_value The domain value associated with the first sample.
+             * @param samples A pointer to the samples to publish.
+             * @param count The number of samples pointed to by @p samples.
+             */
+            void publish_data(
+                std::int64_t domain_value,
+                const T *samples,
+                std::size_t count)
+                noexcept
+            {
+                local_signal::publish_data(domain_value, count, samples, count * sample_size);
+            }
+
+            /**
+             * Publishes a contiguous range of samples to the signal with an associated
+             * linear-rule domain signal, as for the corresponding local_signal::publish_data()
+             * overload. The sample count is derived from the size of @p samples.
+             *
+             * @param domain_value The domain value associated with the first sample.
+             * @param samples The samples to publish.
+             */
+            template <typename Range, typename = detail::enable_if_samples<Range, T>>
+            void publish_data(std::int64_t domain_value, const Range& samples) noexcept
+            {
+                publish_data(domain_value, std::data(samples), std::size(samples));
+            }
+
+        private:
+
+            static wss::metadata describe(metadata_builder& metadata)
+            {
+                if constexpr (detail::is_struct_sample<T>::value)
+                {
+                    static_assert(detail::struct_fields_size<T>() == sizeof(T),
+                        "the sample_traits fields must cover the entire structure without padding");
+
+                    if (!detail::struct_fields_contiguous<T>())
+                        throw std::invalid_argument(
+                            "the sample_traits fields must be listed in declaration order");
+                }
+
+                detail::describe_sample<T>(metadata);
+
+                metadata.endian(
+                    boost::endian::order::native == boost::endian::order::little
+                        ? endianness::little
+                        : endianness::big);
+
+                return metadata.build();
+            }
+    };
+}
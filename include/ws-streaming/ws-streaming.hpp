@@ -4,16 +4,24 @@
 #include <ws-streaming/connection.hpp>
 #include <ws-streaming/data_types.hpp>
 #include <ws-streaming/dimension_builder.hpp>
+#include <ws-streaming/encodings.hpp>
 #include <ws-streaming/endianness.hpp>
+#include <ws-streaming/fixed_point_time.hpp>
 #include <ws-streaming/json_rpc_exception.hpp>
 #include <ws-streaming/listener.hpp>
 #include <ws-streaming/local_signal.hpp>
 #include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/publish_group.hpp>
 #include <ws-streaming/quantities.hpp>
 #include <ws-streaming/remote_signal.hpp>
 #include <ws-streaming/rule_types.hpp>
+#include <ws-streaming/sample_converter.hpp>
+#include <ws-streaming/sample_traits.hpp>
 #include <ws-streaming/server.hpp>
 #include <ws-streaming/struct_field.hpp>
 #include <ws-streaming/struct_field_builder.hpp>
 #include <ws-streaming/struct_field_dimension.hpp>
+#include <ws-streaming/struct_layout.hpp>
+#include <ws-streaming/transport_formats.hpp>
+#include <ws-streaming/typed_local_signal.hpp>
 #include <ws-streaming/unit.hpp>
@@ -8,8 +8,8 @@
 
 #include <boost/asio/any_io_executor.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
-#include <boost/beast/core/tcp_stream.hpp>
 #include <boost/beast/http/error.hpp>
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/message.hpp>
@@ -19,7 +19,9 @@
 #include <ws-streaming/client.hpp>
 #include <ws-streaming/connection.hpp>
 #include <ws-streaming/detail/base64.hpp>
+#include <ws-streaming/detail/deflate_pool.hpp>
 #include <ws-streaming/detail/url.hpp>
+#include <ws-streaming/detail/websocket_extensions.hpp>
 
 wss::client::client(boost::asio::any_io_executor executor)
     : _http_client{std::make_shared<detail::http_client>(executor)}
@@ -35,6 +37,19 @@ void wss::client::async_connect(
             connection_ptr connection)
     > handler)
 {
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    if (url.substr(0, unix_scheme_prefix.size()) == unix_scheme_prefix)
+    {
+        boost::asio::local::stream_protocol::endpoint endpoint{
+            std::string{url.substr(unix_scheme_prefix.size())}};
+
+        return _http_client->async_request(
+            endpoint,
+            create_request("localhost", "/"),
+            make_upgrade_handler(_extensions, _deflate_pool, std::move(handler)));
+    }
+#endif
+
     detail::url url_obj{url};
 
     if (url_obj.scheme() == "ws")
@@ -45,28 +60,8 @@ void wss::client::async_connect(
         _http_client->async_request(
             url_obj.host_address(),
             std::to_string(port),
-            create_request(url),
-            [handler = std::move(handler)](
-                const boost::system::error_code& ec,
-                const boost::beast::http::response<boost::beast::http::string_body>& response,
-                boost::beast::tcp_stream& stream,
-                const boost::beast::flat_buffer& buffer)
-            {
-                if (ec)
-                    return handler(ec, {});
-
-                if (response.result() != boost::beast::http::status::switching_protocols)
-                    return handler(boost::beast::http::error::bad_status, {});
-
-                auto connection = std::make_shared<wss::connection>(
-                    stream.release_socket(),
-                    true);
-
-                auto data = buffer.data();
-                connection->run(data.data(), data.size());
-
-                handler({}, connection);
-            });
+            create_request(url_obj.host_address(), url_obj.path()),
+            make_upgrade_handler(_extensions, _deflate_pool, std::move(handler)));
     }
 
     else
@@ -116,10 +111,55 @@ void wss::client::cancel()
     _http_client->cancel();
 }
 
+wss::detail::http_client::handler_type
+wss::client::make_upgrade_handler(
+    const detail::websocket_extensions& offered,
+    std::shared_ptr<detail::deflate_pool> deflate_pool,
+    std::function<
+        void(
+            const boost::system::error_code& ec,
+            connection_ptr connection)
+    > handler)
+{
+    return [offered, deflate_pool = std::move(deflate_pool), handler = std::move(handler)](
+        const boost::system::error_code& ec,
+        const boost::beast::http::response<boost::beast::http::string_body>& response,
+        detail::http_client::stream_type& stream,
+        const boost::beast::flat_buffer& buffer)
+    {
+        if (ec)
+            return handler(ec, {});
+
+        if (response.result() != boost::beast::http::status::switching_protocols)
+            return handler(boost::beast::http::error::bad_status, {});
+
+        // The server must not accept extensions we did not offer.
+        auto extensions = detail::websocket_extensions::accept(
+            std::string(response[boost::beast::http::field::sec_websocket_extensions]),
+            offered);
+
+        if (!extensions)
+            return handler(boost::beast::http::error::bad_value, {});
+
+        auto connection = std::make_shared<wss::connection>(
+            stream.release_socket(),
+            true,
+            false,
+            *extensions,
+            deflate_pool);
+
+        auto data = buffer.data();
+        connection->run(data.data(), data.size());
+
+        handler({}, connection);
+    };
+}
+
 boost::beast::http::request<boost::beast::http::string_body>
-wss::client::create_request(const detail::url& url)
+wss::client::create_request(
+    const std::string& host,
+    std::string path)
 {
-    std::string path = url.path();
     if (path.empty())
         path = "/";
 
@@ -129,11 +169,14 @@ wss::client::create_request(const detail::url& url)
         11};
 
     request.set(boost::beast::http::field::connection, "Upgrade");
-    request.set(boost::beast::http::field::host, url.host_address());
+    request.set(boost::beast::http::field::host, host);
     request.set(boost::beast::http::field::sec_websocket_key, get_random_key());
     request.set(boost::beast::http::field::sec_websocket_version, "13");
     request.set(boost::beast::http::field::upgrade, "websocket");
 
+    if (auto extensions = _extensions.offer(); !extensions.empty())
+        request.set(boost::beast::http::field::sec_websocket_extensions, extensions);
+
     return request;
 }
 
@@ -1,45 +1,89 @@
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <cmath>
+#include <limits>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
-#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
 #include <boost/endian/conversion.hpp>
 
 #include <ws-streaming/connection.hpp>
 #include <ws-streaming/json_rpc_exception.hpp>
+#include <ws-streaming/local_signal.hpp>
 #include <ws-streaming/metadata.hpp>
+#include <ws-streaming/metadata_builder.hpp>
 #include <ws-streaming/remote_signal.hpp>
 #include <ws-streaming/rule_types.hpp>
 #include <ws-streaming/detail/command_interface_client_factory.hpp>
+#include <ws-streaming/detail/const_buffer_span.hpp>
+#include <ws-streaming/detail/decimated_signal.hpp>
+#include <ws-streaming/detail/deflate_pool.hpp>
+#include <ws-streaming/detail/endpoint.hpp>
 #include <ws-streaming/detail/in_band_command_interface_client.hpp>
+#include <ws-streaming/detail/json.hpp>
+#include <ws-streaming/detail/last_value_cache.hpp>
 #include <ws-streaming/detail/linear_table.hpp>
 #include <ws-streaming/detail/peer.hpp>
+#include <ws-streaming/detail/reduced_signal.hpp>
 #include <ws-streaming/detail/registered_local_signal.hpp>
 #include <ws-streaming/detail/remote_signal_impl.hpp>
 #include <ws-streaming/detail/semver.hpp>
 #include <ws-streaming/detail/streaming_protocol.hpp>
+#include <ws-streaming/detail/websocket_extensions.hpp>
 
 using namespace std::placeholders;
 
+static std::string make_stream_id(
+    const boost::asio::generic::stream_protocol::socket& socket)
+{
+    auto endpoint = socket.remote_endpoint();
+
+    if (wss::detail::to_tcp_endpoint(endpoint))
+        return wss::detail::to_string(endpoint);
+
+    // Non-IP endpoints (e.g. unnamed UNIX domain sockets) don't uniquely identify the remote
+    // peer, so append a process-wide sequence number to keep stream IDs distinct.
+    static std::atomic<unsigned> next_id = 1;
+    return wss::detail::to_string(endpoint) + "#" + std::to_string(next_id++);
+}
+
 wss::connection::connection(
-        boost::asio::ip::tcp::socket&& socket,
+        boost::asio::generic::stream_protocol::socket&& socket,
         bool is_client,
-        bool use_tcp_protocol)
+        bool use_tcp_protocol,
+        const detail::websocket_extensions& extensions,
+        std::shared_ptr<detail::deflate_pool> deflate_pool)
     : _is_client{is_client}
     , _peer{std::make_shared<detail::peer>(std::move(socket), is_client, use_tcp_protocol)}
-    , _local_stream_id{_peer->socket().remote_endpoint().address().to_string()
-        + ":" + std::to_string(_peer->socket().remote_endpoint().port())}
+    , _local_stream_id{make_stream_id(_peer->socket())}
+    , _broadcast_timer{_peer->socket().get_executor()}
 {
     _command_interfaces["jsonrpc"] = { { "httpMethod", "" } };
+
+    if (extensions.block_compression)
+        _peer->enable_block_compression();
+
+    // The parameters that constrain our own compressor are those for our side of the connection.
+    if (extensions.permessage_deflate)
+        _peer->enable_permessage_deflate(
+            is_client ? extensions.client_max_window_bits : extensions.server_max_window_bits,
+            is_client ? !extensions.client_no_context_takeover : !extensions.server_no_context_takeover,
+            deflate_pool ? std::move(deflate_pool) : std::make_shared<detail::deflate_pool>(1));
 }
 
 wss::connection::~connection()
 {
     _peer->stop();
+
+    // Decimated and reduced signals are destroyed before the base class, so unregister them first.
+    clear_local_signals();
 }
 
 void wss::connection::register_external_command_interface(
@@ -88,7 +132,7 @@ void wss::connection::add_local_signal(local_signal& signal)
         entry->is_explicit = rule == rule_types::explicit_rule;
 
         if (rule == rule_types::linear_rule)
-            entry->table = std::make_shared<detail::linear_table>(signal.metadata());
+            entry->table.emplace(signal.metadata());
 
         auto table_id = signal.metadata().table_id();
         if (!table_id.empty() && table_id != signal.id())
@@ -97,7 +141,19 @@ void wss::connection::add_local_signal(local_signal& signal)
             if (domain_entry)
             {
                 entry->domain_signo = domain_entry->signo;
-                entry->domain_table = domain_entry->table;
+                entry->domain_table = &domain_entry->table;
+            }
+        }
+
+        // Link any signals registered earlier that use this one as their domain signal.
+        for (const auto& other : local_signals())
+        {
+            if (other != entry
+                    && other->signal.id() != signal.id()
+                    && other->signal.metadata().table_id() == signal.id())
+            {
+                other->domain_signo = entry->signo;
+                other->domain_table = &entry->table;
             }
         }
 
@@ -108,6 +164,16 @@ void wss::connection::add_local_signal(local_signal& signal)
 
 void wss::connection::remove_local_signal(local_signal& signal)
 {
+    remove_decimated_signals(signal);
+    remove_reduced_signals(signal);
+
+    // Unlink any signals using this one as their domain signal, since they refer to its linear
+    // table without owning it.
+    if (auto entry = find_local_signal(signal.id()); entry)
+        for (const auto& other : local_signals())
+            if (other->domain_table == &entry->table)
+                other->domain_table = nullptr;
+
     unsigned signo = detail::local_signal_container::remove_local_signal(signal);
 
     if (signo)
@@ -126,7 +192,7 @@ const boost::asio::any_io_executor& wss::connection::executor() const noexcept
     return _peer->socket().get_executor();
 }
 
-const boost::asio::ip::tcp::socket& wss::connection::socket() const noexcept
+const boost::asio::generic::stream_protocol::socket& wss::connection::socket() const noexcept
 {
     return _peer->socket();
 }
@@ -153,6 +219,12 @@ nlohmann::json wss::connection::do_command_interface(
 
 void wss::connection::do_hello()
 {
+    // We advertise the shared memory capability below, so accept the remote peer's offers.
+    _peer->enable_shared_memory();
+
+    // The greeting is transmitted as a single batch.
+    _peer->begin_batch();
+
     _peer->send_metadata(
         0,
         "apiVersion",
@@ -166,6 +238,11 @@ void wss::connection::do_hello()
         {
             { "streamId", _local_stream_id },
             { "commandInterfaces", _command_interfaces },
+            { "capabilities", {
+                detail::streaming_protocol::AGGREGATE_CAPABILITY,
+                detail::streaming_protocol::ENCODING_CAPABILITY,
+                detail::streaming_protocol::SHARED_MEMORY_CAPABILITY,
+            } },
         });
 
     auto signal_ids = nlohmann::json::array();
@@ -181,6 +258,8 @@ void wss::connection::do_hello()
                 { "signalIds", signal_ids }
             });
 
+    _peer->end_batch();
+
     _hello_sent = true;
 }
 
@@ -225,6 +304,7 @@ void wss::connection::on_peer_closed(
     _on_peer_data_received.disconnect();
     _on_peer_metadata_received.disconnect();
     _on_peer_closed.disconnect();
+    _broadcast_timer.cancel();
 
     clear_remote_signals(
         [this](remote_signal_ptr signal)
@@ -233,6 +313,9 @@ void wss::connection::on_peer_closed(
         });
 
     clear_local_signals();
+    _decimated_signals.clear();
+    _decimated_domains.clear();
+    _reduced_signals.clear();
 
     on_disconnected(ec);
 }
@@ -245,7 +328,7 @@ void wss::connection::on_local_signal_metadata_changed(
         if (entry.table)
             entry.table->update(entry.signal.metadata());
         else
-            entry.table = std::make_shared<detail::linear_table>(entry.signal.metadata());
+            entry.table.emplace(entry.signal.metadata());
     }
 
     else
@@ -253,7 +336,7 @@ void wss::connection::on_local_signal_metadata_changed(
 
     auto table_id = entry.signal.metadata().table_id();
     entry.domain_signo = 0;
-    entry.domain_table.reset();
+    entry.domain_table = nullptr;
 
     if (!table_id.empty() && table_id != entry.signal.id())
     {
@@ -262,21 +345,76 @@ void wss::connection::on_local_signal_metadata_changed(
         if (domain_entry)
         {
             entry.domain_signo = domain_entry->signo;
-            entry.domain_table = domain_entry->table;
+            entry.domain_table = &domain_entry->table;
         }
     }
 
-    _peer->send_metadata(entry.signo, "signal", entry.signal.metadata().json());
+    _peer->send_metadata(entry.signo, "signal", transmitted_metadata(entry));
+}
+
+nlohmann::json wss::connection::transmitted_metadata(
+    detail::registered_local_signal& entry)
+{
+    nlohmann::json metadata = entry.signal.metadata().json();
+
+    // Payload encodings are only declared to peers that can decode them, and only if the
+    // encoding applies to the signal; otherwise the data is transmitted unencoded.
+    entry.codec = _peer_supports_encodings
+        ? detail::payload_codec{entry.signal.metadata()}
+        : detail::payload_codec{};
+
+    // The encoding buffers are reserved up front, so that publishing blocks of up to
+    // ENCODE_BUFFER_SIZE bytes does not allocate.
+    if (entry.codec.enabled())
+    {
+        entry.encode_input.reserve(ENCODE_BUFFER_SIZE);
+        entry.encoded.reserve(detail::payload_codec::max_encoded_size(ENCODE_BUFFER_SIZE));
+    }
+
+    if (!entry.codec.enabled()
+            && metadata.contains("definition")
+            && metadata["definition"].is_object())
+        metadata["definition"].erase("encoding");
+
+    return metadata;
+}
+
+void wss::connection::on_local_signal_data_published_live(
+    const std::shared_ptr<detail::registered_local_signal>& entry,
+    std::int64_t domain_value,
+    std::size_t sample_count,
+    const boost::asio::const_buffer *buffers,
+    std::size_t buffer_count,
+    const std::shared_ptr<const void>& owner)
+{
+    // Skip blocks that subscribe() has already transmitted from the last-value cache.
+    if (entry->signal.publish_sequence()
+            <= entry->last_value_sequence.load(std::memory_order_relaxed))
+        return;
+
+    on_local_signal_data_published(
+        entry,
+        domain_value,
+        sample_count,
+        buffers,
+        buffer_count,
+        owner);
 }
 
 void wss::connection::on_local_signal_data_published(
-    std::shared_ptr<detail::registered_local_signal> entry,
+    const std::shared_ptr<detail::registered_local_signal>& entry,
     std::int64_t domain_value,
     std::size_t sample_count,
-    const void *data,
-    std::size_t size)
+    const boost::asio::const_buffer *buffers,
+    std::size_t buffer_count,
+    const std::shared_ptr<const void>& owner)
 {
-    auto domain_table = entry->domain_table.lock();
+    // The domain table is linked without ownership when signals are registered or their
+    // metadata changes, so that no reference counting is needed here.
+    detail::linear_table *domain_table
+        = entry->domain_table && *entry->domain_table
+            ? &**entry->domain_table
+            : nullptr;
 
     if (domain_table)
     {
@@ -285,7 +423,20 @@ void wss::connection::on_local_signal_data_published(
                 ? entry->value_index
                 : domain_table->driven_index();
 
-        if (domain_value != domain_table->value_at(index))
+        // Only resynchronize the domain if the published value deviates from the value implied
+        // by the linear rule by more than the signal's tolerance. Blocks of a signal with a
+        // deadband may follow suppressed samples that the peer has not counted, so any
+        // deviation is corrected.
+        std::int64_t implied_value = domain_table->value_at(index);
+        std::uint64_t error = domain_value >= implied_value
+            ? static_cast<std::uint64_t>(domain_value) - static_cast<std::uint64_t>(implied_value)
+            : static_cast<std::uint64_t>(implied_value) - static_cast<std::uint64_t>(domain_value);
+        std::uint64_t tolerance = entry->signal.has_deadband() ? 0 : entry->signal.domain_tolerance();
+        bool must_resync = error > tolerance;
+
+        entry->signal.record_domain_sync(error, must_resync);
+
+        if (must_resync)
         {
             domain_table->set(index, domain_value);
 
@@ -299,9 +450,35 @@ void wss::connection::on_local_signal_data_published(
         }
     }
 
-    _peer->send_data(
-        entry->signo,
-        boost::asio::const_buffer{data, size});
+    if (entry->codec.enabled())
+    {
+        const void *data = buffer_count ? buffers[0].data() : nullptr;
+        std::size_t size = buffer_count ? buffers[0].size() : 0;
+
+        if (buffer_count > 1)
+        {
+            entry->encode_input.clear();
+            for (std::size_t i = 0; i < buffer_count; ++i)
+                entry->encode_input.insert(
+                    entry->encode_input.end(),
+                    static_cast<const std::uint8_t *>(buffers[i].data()),
+                    static_cast<const std::uint8_t *>(buffers[i].data()) + buffers[i].size());
+
+            data = entry->encode_input.data();
+            size = entry->encode_input.size();
+        }
+
+        // The encoded data is not owned, so the peer copies it if it cannot be sent
+        // synchronously, and the buffer can be reused for the next publish.
+        entry->codec.encode(data, size, entry->encoded);
+        _peer->send_data(entry->signo, boost::asio::buffer(entry->encoded));
+    }
+
+    else
+        _peer->send_data(
+            entry->signo,
+            detail::const_buffer_span{buffers, buffer_count},
+            owner);
 
     entry->value_index += sample_count;
 
@@ -309,6 +486,95 @@ void wss::connection::on_local_signal_data_published(
         domain_table->drive_to(entry->value_index);
 }
 
+void wss::connection::do_wait_broadcast()
+{
+    _broadcast_timer.expires_after(BROADCAST_POLL_INTERVAL);
+    _broadcast_timer.async_wait(
+        std::bind(
+            &connection::finish_wait_broadcast,
+            shared_from_this(),
+            _1));
+
+    _waiting_broadcast = true;
+}
+
+void wss::connection::finish_wait_broadcast(const boost::system::error_code& ec)
+{
+    _waiting_broadcast = false;
+
+    if (ec)
+        return;
+
+    bool any_rings = false;
+
+    // Transmit the data drained from every ring together.
+    _peer->begin_batch();
+
+    for (const auto& signal : local_signals())
+    {
+        if (signal->broadcast_ring)
+        {
+            drain_broadcast_ring(signal);
+            any_rings = true;
+        }
+    }
+
+    _peer->end_batch();
+
+    // Keep polling for as long as we are subscribed to any signal with a broadcast ring.
+    if (any_rings)
+        do_wait_broadcast();
+}
+
+void wss::connection::drain_broadcast_ring(
+    const std::shared_ptr<detail::registered_local_signal>& signal)
+{
+    detail::broadcast_ring::record_header header;
+
+    // Read only the records that were available when we started, so that a fast publisher
+    // cannot keep us here indefinitely.
+    std::uint64_t end = signal->broadcast_ring->head();
+
+    while (signal->broadcast_ring && signal->broadcast_cursor != end)
+    {
+        auto result = signal->broadcast_ring->read(
+            signal->broadcast_cursor,
+            header,
+            _broadcast_data);
+
+        if (result == detail::broadcast_ring::read_result::empty)
+            break;
+
+        if (result == detail::broadcast_ring::read_result::overrun)
+        {
+            ++signal->broadcast_overruns;
+            break;
+        }
+
+        // If records were skipped due to an overrun, advance the value index past the samples
+        // they contained, so that implicit linear-rule domain values remain correct.
+        if (signal->broadcast_sample_index.has_value()
+                && header.sample_index > *signal->broadcast_sample_index)
+        {
+            signal->value_index += header.sample_index - *signal->broadcast_sample_index;
+
+            if (signal->is_explicit && signal->domain_table && *signal->domain_table)
+                (*signal->domain_table)->drive_to(signal->value_index);
+        }
+
+        signal->broadcast_sample_index = header.sample_index + header.sample_count;
+
+        boost::asio::const_buffer buffer{_broadcast_data.data(), header.size};
+        on_local_signal_data_published(
+            signal,
+            header.domain_value,
+            header.sample_count,
+            &buffer,
+            1,
+            nullptr);
+    }
+}
+
 void wss::connection::on_signal_subscribe_requested(
     const std::string& signal_id)
 {
@@ -378,8 +644,31 @@ void wss::connection::handle_init(
             params["commandInterfaces"],
             _peer);
 
+    // Peers advertising support for aggregate packets receive data published in groups (or
+    // drained from broadcast rings) as aggregate packets. Peers advertising support for
+    // payload encodings receive the data of signals that declare one encoded.
+    bool peer_supports_shared_memory = false;
+
+    if (params.contains("capabilities") && params["capabilities"].is_array())
+    {
+        for (const auto& capability : params["capabilities"])
+        {
+            if (capability == detail::streaming_protocol::AGGREGATE_CAPABILITY)
+                _peer->enable_aggregate_packets();
+            else if (capability == detail::streaming_protocol::ENCODING_CAPABILITY)
+                _peer_supports_encodings = true;
+            else if (capability == detail::streaming_protocol::SHARED_MEMORY_CAPABILITY)
+                peer_supports_shared_memory = true;
+        }
+    }
+
     if (_is_client && _api_version >= detail::semver(2, 0, 0))
         do_hello();
+
+    // If the remote peer understands the negotiation and appears to run on the same host, try
+    // to move the data we transmit off the socket and into shared memory.
+    if (_hello_sent && peer_supports_shared_memory && detail::is_same_host(_peer->socket()))
+        _peer->offer_shared_memory();
 }
 
 void wss::connection::handle_available(
@@ -524,12 +813,34 @@ nlohmann::json wss::connection::do_command_interface_subscribe(const nlohmann::j
         return true;
     }
 
+    // Subscribing with decimation or transport format parameters creates (or reuses) a
+    // derived signal, whose ID is returned to the client.
+    else if (params.is_object())
+    {
+        auto signal_id = subscribe_derived(params);
+        if (signal_id.empty())
+            throw json_rpc_exception(
+                json_rpc_exception::server_error,
+                "failed to subscribe derived signal");
+
+        return signal_id;
+    }
+
     else if (params.is_array())
     {
         auto results = nlohmann::json::array();
 
         for (const auto& signal_id : params)
-            results.push_back(signal_id.is_string() && subscribe(signal_id, true));
+        {
+            if (signal_id.is_object())
+            {
+                auto derived_id = subscribe_derived(signal_id);
+                results.push_back(derived_id.empty() ? nlohmann::json(false) : nlohmann::json(derived_id));
+            }
+
+            else
+                results.push_back(signal_id.is_string() && subscribe(signal_id, true));
+        }
 
         return results;
     }
@@ -537,7 +848,7 @@ nlohmann::json wss::connection::do_command_interface_subscribe(const nlohmann::j
     else
         throw json_rpc_exception(
             json_rpc_exception::invalid_params,
-            "params must be a signal ID or an array of signal IDs");
+            "params must be a signal ID, a derived signal request or an array of these");
 }
 
 nlohmann::json wss::connection::do_command_interface_unsubscribe(const nlohmann::json& params)
@@ -549,6 +860,7 @@ nlohmann::json wss::connection::do_command_interface_unsubscribe(const nlohmann:
                 json_rpc_exception::server_error,
                 "failed to unsubscribe signal");
 
+        remove_derived_signal(params);
         return true;
     }
 
@@ -557,7 +869,13 @@ nlohmann::json wss::connection::do_command_interface_unsubscribe(const nlohmann:
         auto results = nlohmann::json::array();
 
         for (const auto& signal_id : params)
-            results.push_back(signal_id.is_string() && unsubscribe(signal_id, true));
+        {
+            bool unsubscribed = signal_id.is_string() && unsubscribe(signal_id, true);
+            if (unsubscribed)
+                remove_derived_signal(signal_id);
+
+            results.push_back(unsubscribed);
+        }
 
         return results;
     }
@@ -600,6 +918,9 @@ bool wss::connection::subscribe(
             subscribe(table_id, false);
     }
 
+    // The subscription's metadata is transmitted as a single batch.
+    _peer->begin_batch();
+
     _peer->send_metadata(
         signal->signo,
         "subscribe",
@@ -607,7 +928,7 @@ bool wss::connection::subscribe(
             { "signalId", signal->signal.id() }
         });
 
-    nlohmann::json metadata = signal->signal.metadata().json();
+    nlohmann::json metadata = transmitted_metadata(*signal);
     metadata["valueIndex"] = signal->value_index;
 
     _peer->send_metadata(
@@ -615,15 +936,59 @@ bool wss::connection::subscribe(
         "signal",
         metadata);
 
-    signal->on_data_published = signal->signal.on_data_published.connect(
-        std::bind(
-            &connection::on_local_signal_data_published,
-            shared_from_this(),
+    // Signals with broadcast rings are read from this connection's own cursor; others invoke
+    // us synchronously when data is published.
+    if (auto ring = signal->signal.broadcast_ring())
+    {
+        signal->broadcast_ring = ring;
+        signal->broadcast_cursor = ring->head();
+        signal->broadcast_sample_index.reset();
+
+        if (!_waiting_broadcast)
+            do_wait_broadcast();
+    }
+
+    else
+    {
+        signal->on_data_published = signal->signal.on_data_published.connect(
+            std::bind(
+                &connection::on_local_signal_data_published_live,
+                shared_from_this(),
+                signal,
+                _1,
+                _2,
+                _3,
+                _4,
+                _5));
+
+        // Data published as part of a publish_group is transmitted as a single batch.
+        signal->on_group_begin = signal->signal.on_group_begin.connect(
+            std::bind(&detail::peer::begin_batch, _peer));
+        signal->on_group_end = signal->signal.on_group_end.connect(
+            std::bind(&detail::peer::end_batch, _peer));
+    }
+
+    // Signals with a last-value cache transmit their most recently published block right away,
+    // so that the peer need not wait for the next publish. We follow the signal first, so that
+    // no block published meanwhile is lost. Blocks numbered up to the cached one are then
+    // skipped when they arrive live, and broadcast rings are read from right after it.
+    if (auto last = signal->signal.last_value())
+    {
+        signal->last_value_sequence.store(last->sequence, std::memory_order_relaxed);
+        if (signal->broadcast_ring)
+            signal->broadcast_cursor = last->sequence;
+
+        boost::asio::const_buffer buffer{last->data.get(), last->size};
+        on_local_signal_data_published(
             signal,
-            _1,
-            _2,
-            _3,
-            _4));
+            last->domain_value,
+            last->sample_count,
+            &buffer,
+            1,
+            last->data);
+    }
+
+    _peer->end_batch();
 
     signal->on_metadata_changed = signal->signal.on_metadata_changed.connect(
         std::bind(
@@ -650,8 +1015,11 @@ bool wss::connection::unsubscribe(
         return false;
 
     signal->on_data_published.disconnect();
+    signal->on_group_begin.disconnect();
+    signal->on_group_end.disconnect();
     signal->on_metadata_changed.disconnect();
     signal->holder.close();
+    signal->broadcast_ring.reset();
 
     _peer->send_metadata(
         signal->signo,
@@ -666,3 +1034,189 @@ bool wss::connection::unsubscribe(
 
     return true;
 }
+
+std::string wss::connection::subscribe_derived(const nlohmann::json& params)
+{
+    return params.contains("format")
+        ? subscribe_reduced(params)
+        : subscribe_decimated(params);
+}
+
+std::string wss::connection::subscribe_decimated(const nlohmann::json& params)
+{
+    auto source = find_local_signal(detail::json_ptr<std::string>(params, "/signalId", ""));
+    if (!source || source->signal.broadcast_ring())
+        return "";
+
+    // Only signals with linear-rule domains can be decimated, so that the domain of the
+    // decimated signal can also be described by a linear rule.
+    auto domain_id = source->signal.metadata().table_id();
+    auto domain = find_local_signal(domain_id);
+    if (!domain || domain == source || domain->signal.metadata().rule() != rule_types::linear_rule)
+        return "";
+
+    auto [start, delta] = domain->signal.metadata().linear_start_delta();
+    if (!delta || *delta <= 0)
+        return "";
+
+    // The decimation factor is either given directly, or derived from a target sample rate
+    // and the sample rate implied by the domain's tick resolution.
+    std::int64_t factor = detail::json_ptr<std::int64_t>(params, "/decimation", 0);
+    if (double target_rate = detail::json_ptr<double>(params, "/targetRate", 0); !factor && target_rate > 0)
+    {
+        auto resolution = domain->signal.metadata().tick_resolution();
+        if (resolution && resolution->first && resolution->second)
+        {
+            // Clamp before rounding, since a tiny target rate yields a ratio that does not fit
+            // an integer; ratios beyond MAX_DECIMATION are then rejected below.
+            double ratio = resolution->second
+                / (static_cast<double>(resolution->first) * *delta)
+                / target_rate;
+            factor = std::llround(std::clamp(ratio, 1.0, static_cast<double>(MAX_DECIMATION + 1)));
+        }
+    }
+
+    // The factor is bounded, since each distinct factor creates a signal on behalf of the peer,
+    // and the decimated domain's delta must be representable.
+    if (factor <= 0 || factor > MAX_DECIMATION
+            || *delta > std::numeric_limits<std::int64_t>::max() / factor)
+        return "";
+
+    std::string suffix = "/Decimated/" + std::to_string(factor);
+    std::string signal_id = source->signal.id() + suffix;
+    std::string decimated_domain_id = domain_id + suffix;
+
+    if (!_decimated_domains.count(decimated_domain_id))
+    {
+        auto decimated_domain = std::make_unique<local_signal>(
+            decimated_domain_id,
+            metadata_builder{from_json, domain->signal.metadata().json()}
+                .linear_rule(start.value_or(0), *delta * factor)
+                .table(decimated_domain_id)
+                .build());
+
+        add_local_signal(*decimated_domain);
+        _decimated_domains.emplace(decimated_domain_id, std::move(decimated_domain));
+    }
+
+    if (!_decimated_signals.count(signal_id))
+    {
+        auto decimated = std::make_unique<detail::decimated_signal>(
+            signal_id,
+            source->signal,
+            decimated_domain_id,
+            *delta,
+            factor);
+
+        add_local_signal(decimated->signal());
+        _decimated_signals.emplace(signal_id, std::move(decimated));
+    }
+
+    subscribe(signal_id, true);
+
+    return signal_id;
+}
+
+std::string wss::connection::subscribe_reduced(const nlohmann::json& params)
+{
+    auto source = find_local_signal(detail::json_ptr<std::string>(params, "/signalId", ""));
+    if (!source || source->signal.broadcast_ring())
+        return "";
+
+    auto format = detail::json_ptr<std::string>(params, "/format", "");
+    auto signal_id = detail::reduced_signal::make_id(source->signal.id(), format);
+
+    if (!_reduced_signals.count(signal_id))
+    {
+        auto reduced = detail::reduced_signal::get(source->signal, format);
+        if (!reduced)
+            return "";
+
+        add_local_signal(reduced->signal());
+        _reduced_signals.emplace(signal_id, std::move(reduced));
+    }
+
+    subscribe(signal_id, true);
+
+    return signal_id;
+}
+
+void wss::connection::remove_reduced_signals(local_signal& source)
+{
+    for (auto it = _reduced_signals.begin(); it != _reduced_signals.end(); )
+    {
+        if (&it->second->source() != &source)
+        {
+            ++it;
+            continue;
+        }
+
+        if (auto entry = find_local_signal(it->first); entry && entry->is_explicitly_subscribed)
+            unsubscribe(it->first, true);
+
+        remove_local_signal(it->second->signal());
+        it = _reduced_signals.erase(it);
+    }
+}
+
+void wss::connection::remove_decimated_signals(local_signal& source)
+{
+    bool removed = false;
+
+    for (auto it = _decimated_signals.begin(); it != _decimated_signals.end(); )
+    {
+        if (&it->second->source() != &source)
+        {
+            ++it;
+            continue;
+        }
+
+        if (auto entry = find_local_signal(it->first); entry && entry->is_explicitly_subscribed)
+            unsubscribe(it->first, true);
+
+        remove_local_signal(it->second->signal());
+        it = _decimated_signals.erase(it);
+        removed = true;
+    }
+
+    if (removed)
+        remove_unused_decimated_domains();
+}
+
+void wss::connection::remove_derived_signal(const std::string& signal_id)
+{
+    // Derived signals exist only on behalf of the peer's subscriptions to them, so they are
+    // removed as soon as the peer unsubscribes.
+    if (auto it = _decimated_signals.find(signal_id); it != _decimated_signals.end())
+    {
+        remove_local_signal(it->second->signal());
+        _decimated_signals.erase(it);
+        remove_unused_decimated_domains();
+    }
+
+    // Reduced signals are shared, and destroyed once no connection holds them.
+    else if (auto it = _reduced_signals.find(signal_id); it != _reduced_signals.end())
+    {
+        remove_local_signal(it->second->signal());
+        _reduced_signals.erase(it);
+    }
+}
+
+void wss::connection::remove_unused_decimated_domains()
+{
+    // Remove domain signals no longer used by any decimated signal.
+    for (auto it = _decimated_domains.begin(); it != _decimated_domains.end(); )
+    {
+        if (std::any_of(
+                _decimated_signals.begin(),
+                _decimated_signals.end(),
+                [&](const auto& entry) { return entry.second->domain_id() == it->first; }))
+        {
+            ++it;
+            continue;
+        }
+
+        remove_local_signal(*it->second);
+        it = _decimated_domains.erase(it);
+    }
+}
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
+
+#include <ws-streaming/detail/block_compressor.hpp>
+
+// Parameters of the LZ4 block format: matches are at least MIN_MATCH bytes long and at most
+// MAX_OFFSET bytes back, the last LAST_LITERALS bytes of a block are always literals, and the
+// last match starts at least MATCH_FIND_LIMIT bytes before the end of the block.
+static constexpr std::size_t MIN_MATCH = 4;
+static constexpr std::size_t MAX_OFFSET = 65535;
+static constexpr std::size_t LAST_LITERALS = 5;
+static constexpr std::size_t MATCH_FIND_LIMIT = 12;
+
+static constexpr unsigned HASH_BITS = 13;
+
+// The size of the uncompressed size field that precedes each compressed block.
+static constexpr std::size_t SIZE_FIELD_SIZE = sizeof(std::uint32_t);
+
+static inline std::uint32_t read32(const std::uint8_t *data) noexcept
+{
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static inline std::uint64_t read64(const std::uint8_t *data) noexcept
+{
+    std::uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static inline unsigned hash(std::uint32_t sequence) noexcept
+{
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static std::uint8_t *write_length(std::uint8_t *output, std::size_t length) noexcept
+{
+    for (; length >= 255; length -= 255)
+        *output++ = 255;
+
+    *output++ = static_cast<std::uint8_t>(length);
+    return output;
+}
+
+static std::uint8_t *write_literals(
+    std::uint8_t *output,
+    std::uint8_t *token,
+    const std::uint8_t *literals,
+    std::size_t literal_count) noexcept
+{
+    *token = static_cast<std::uint8_t>(std::min<std::size_t>(literal_count, 15) << 4);
+
+    if (literal_count >= 15)
+        output = write_length(output, literal_count - 15);
+
+    std::memcpy(output, literals, literal_count);
+    return output + literal_count;
+}
+
+static std::uint8_t *write_sequence(
+    std::uint8_t *output,
+    const std::uint8_t *literals,
+    std::size_t literal_count,
+    std::size_t offset,
+    std::size_t match_length) noexcept
+{
+    std::uint8_t *token = output++;
+    output = write_literals(output, token, literals, literal_count);
+
+    *output++ = static_cast<std::uint8_t>(offset);
+    *output++ = static_cast<std::uint8_t>(offset >> 8);
+
+    std::size_t extra_length = match_length - MIN_MATCH;
+    *token |= static_cast<std::uint8_t>(std::min<std::size_t>(extra_length, 15));
+
+    if (extra_length >= 15)
+        output = write_length(output, extra_length - 15);
+
+    return output;
+}
+
+// Greedy LZ77 parsing with a single-entry hash table, as in the reference LZ4 compressor. The
+// search accelerates through data in which it finds no matches, so that incompressible data
+// costs little more than copying it.
+static std::uint8_t *compress_block(
+    const std::uint8_t *input,
+    std::size_t size,
+    std::uint8_t *output,
+    std::vector<std::uint32_t>& table)
+{
+    const std::uint8_t *ip = input;
+    const std::uint8_t *anchor = input;
+    const std::uint8_t *end = input + size;
+
+    if (size > MATCH_FIND_LIMIT)
+    {
+        const std::uint8_t *limit = end - MATCH_FIND_LIMIT;
+        const std::uint8_t *match_limit = end - LAST_LITERALS;
+        unsigned misses = 0;
+
+        while (ip <= limit)
+        {
+            std::uint32_t sequence = read32(ip);
+            std::uint32_t& entry = table[hash(sequence)];
+            std::size_t position = entry;
+            entry = static_cast<std::uint32_t>(ip - input + 1);
+
+            // The table is not cleared between blocks, so entries may refer to positions in
+            // previous blocks that are not before the current position in this one.
+            const std::uint8_t *ref = position && position <= static_cast<std::size_t>(ip - input)
+                ? input + (position - 1)
+                : ip;
+
+            if (ref == ip
+                    || static_cast<std::size_t>(ip - ref) > MAX_OFFSET
+                    || read32(ref) != sequence)
+            {
+                ip += 1 + (misses++ >> 6);
+                continue;
+            }
+
+            misses = 0;
+
+            while (ip > anchor && ref > input && ip[-1] == ref[-1])
+                --ip, --ref;
+
+            const std::uint8_t *match_end = ip + MIN_MATCH;
+            const std::uint8_t *ref_end = ref + MIN_MATCH;
+
+            while (match_end + sizeof(std::uint64_t) <= match_limit
+                    && read64(match_end) == read64(ref_end))
+                match_end += sizeof(std::uint64_t), ref_end += sizeof(std::uint64_t);
+
+            while (match_end < match_limit && *match_end == *ref_end)
+                ++match_end, ++ref_end;
+
+            output = write_sequence(output, anchor, ip - anchor, ip - ref, match_end - ip);
+            ip = anchor = match_end;
+        }
+    }
+
+    std::uint8_t *token = output++;
+    return write_literals(output, token, anchor, end - anchor);
+}
+
+static bool read_length(
+    const std::uint8_t *& data,
+    const std::uint8_t *end,
+    std::size_t& length) noexcept
+{
+    std::uint8_t byte;
+
+    do
+    {
+        if (data == end)
+            return false;
+
+        byte = *data++;
+        length += byte;
+
+        if (length > wss::detail::block_compressor::MAX_BLOCK_SIZE)
+            return false;
+    } while (byte == 255);
+
+    return true;
+}
+
+wss::detail::block_compressor::block_compressor()
+    : _table(std::size_t{1} << HASH_BITS)
+{
+}
+
+bool wss::detail::block_compressor::compress(
+    const std::uint8_t *data,
+    std::size_t size,
+    std::vector<std::uint8_t>& output)
+{
+    output.clear();
+
+    if (_skip)
+    {
+        --_skip;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    output.resize(SIZE_FIELD_SIZE + size + size / 255 + 16);
+    boost::endian::store_little_u32(output.data(), static_cast<std::uint32_t>(size));
+    std::uint8_t *end = compress_block(data, size, output.data() + SIZE_FIELD_SIZE, _table);
+    output.resize(end - output.data());
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    std::size_t saved = output.size() < size ? size - output.size() : 0;
+    bool is_worthwhile = saved
+        && saved >= size / MIN_SAVINGS_DIVISOR
+        && elapsed <= MAX_NANOSECONDS_PER_SAVED_BYTE * static_cast<std::int64_t>(saved);
+
+    if (is_worthwhile)
+        _backoff = 0;
+
+    else
+    {
+        _backoff = std::min(std::max(1u, 2 * _backoff), MAX_SKIPPED_BLOCKS);
+        _skip = _backoff;
+    }
+
+    return is_worthwhile;
+}
+
+bool wss::detail::block_compressor::decompress(
+    const std::uint8_t *data,
+    std::size_t size,
+    std::vector<std::uint8_t>& output)
+{
+    output.clear();
+
+    if (size < SIZE_FIELD_SIZE)
+        return false;
+
+    std::size_t expected_size = boost::endian::load_little_u32(data);
+    if (expected_size > MAX_BLOCK_SIZE)
+        return false;
+
+    output.resize(expected_size);
+
+    const std::uint8_t *ip = data + SIZE_FIELD_SIZE;
+    const std::uint8_t *end = data + size;
+    std::uint8_t *op = output.data();
+    std::uint8_t *op_end = op + expected_size;
+
+    while (true)
+    {
+        if (ip == end)
+            return false;
+
+        unsigned token = *ip++;
+
+        std::size_t literal_count = token >> 4;
+        if (literal_count == 15 && !read_length(ip, end, literal_count))
+            return false;
+
+        if (literal_count > static_cast<std::size_t>(end - ip)
+                || literal_count > static_cast<std::size_t>(op_end - op))
+            return false;
+
+        std::memcpy(op, ip, literal_count);
+        op += literal_count;
+        ip += literal_count;
+
+        // The last sequence of a block consists of literals only.
+        if (ip == end)
+            break;
+
+        if (end - ip < 2)
+            return false;
+
+        std::size_t offset = ip[0] | (std::size_t{ip[1]} << 8);
+        ip += 2;
+
+        if (!offset || offset > static_cast<std::size_t>(op - output.data()))
+            return false;
+
+        std::size_t match_length = token & 15;
+        if (match_length == 15 && !read_length(ip, end, match_length))
+            return false;
+
+        match_length += MIN_MATCH;
+        if (match_length > static_cast<std::size_t>(op_end - op))
+            return false;
+
+        // Matches may overlap the bytes they produce, which repeats a short pattern.
+        const std::uint8_t *match = op - offset;
+
+        if (offset >= match_length)
+            std::memcpy(op, match, match_length);
+        else
+            for (std::size_t i = 0; i < match_length; ++i)
+                op[i] = match[i];
+
+        op += match_length;
+    }
+
+    if (op != op_end)
+    {
+        output.clear();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+#include <ws-streaming/detail/broadcast_ring.hpp>
+#include <ws-streaming/detail/const_buffer_span.hpp>
+
+// Appending must never block, so that it is safe to do from real-time threads.
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+    "broadcast rings require lock-free 64-bit atomics");
+
+static constexpr std::size_t align8(std::size_t size) noexcept
+{
+    return (size + 7) & ~std::size_t{7};
+}
+
+wss::detail::broadcast_ring::broadcast_ring(std::size_t capacity)
+    : _buffer(align8(std::max(capacity, sizeof(record_header))))
+{
+}
+
+bool wss::detail::broadcast_ring::append(
+    std::int64_t domain_value,
+    std::size_t sample_count,
+    const boost::asio::const_buffer *buffers,
+    std::size_t buffer_count) noexcept
+{
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < buffer_count; ++i)
+        size += buffers[i].size();
+
+    std::size_t record_size = align8(sizeof(record_header) + size);
+    if (record_size > _buffer.size())
+        return false;
+
+    std::uint64_t position = _head.load(std::memory_order_relaxed);
+    std::size_t offset = position % _buffer.size();
+
+    // If the record doesn't fit before the end of the ring, mark the rest of the ring as
+    // padding and wrap around to the beginning.
+    std::uint64_t record_position = position;
+    if (offset + record_size > _buffer.size())
+        record_position += _buffer.size() - offset;
+
+    // Announce which data we are about to overwrite before overwriting it.
+    _reserved.store(record_position + record_size, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (record_position != position)
+        std::memcpy(&_buffer[offset], &PADDING, sizeof(PADDING));
+
+    record_header header{record_size, domain_value, sample_count, _sample_index, size};
+    std::uint8_t *record = &_buffer[record_position % _buffer.size()];
+    std::memcpy(record, &header, sizeof(header));
+
+    boost::asio::buffer_copy(
+        boost::asio::mutable_buffer{record + sizeof(header), size},
+        detail::const_buffer_span{buffers, buffer_count});
+
+    _sample_index += sample_count;
+    _head.store(record_position + record_size, std::memory_order_release);
+
+    return true;
+}
+
+std::uint64_t wss::detail::broadcast_ring::head() const noexcept
+{
+    return _head.load(std::memory_order_acquire);
+}
+
+wss::detail::broadcast_ring::read_result wss::detail::broadcast_ring::read(
+    std::uint64_t& cursor,
+    record_header& header,
+    std::vector<std::uint8_t>& data) const
+{
+    while (true)
+    {
+        std::uint64_t head = _head.load(std::memory_order_acquire);
+
+        if (cursor == head)
+            return read_result::empty;
+
+        if (head - cursor > _buffer.size())
+        {
+            cursor = head;
+            return read_result::overrun;
+        }
+
+        std::size_t offset = cursor % _buffer.size();
+        std::size_t available = _buffer.size() - offset;
+
+        // Records never wrap, but a padding marker (which is smaller than a record header) may
+        // occupy the last few bytes of the ring.
+        header = { };
+        std::memcpy(&header, &_buffer[offset], std::min(sizeof(header), available));
+        bool is_padding = header.record_size == PADDING;
+
+        // The header may be garbage if it was overwritten while we copied it. Clamp it so that
+        // the copy stays in bounds, and let the validation below detect the overrun.
+        if (!is_padding && available >= sizeof(header))
+        {
+            std::size_t size = std::min<std::uint64_t>(header.size, available - sizeof(header));
+            data.resize(size);
+            std::memcpy(data.data(), &_buffer[offset + sizeof(header)], size);
+        }
+
+        // Verify that the producer had not started overwriting what we read.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_reserved.load(std::memory_order_relaxed) - cursor > _buffer.size())
+        {
+            cursor = _head.load(std::memory_order_acquire);
+            return read_result::overrun;
+        }
+
+        if (is_padding)
+        {
+            cursor += _buffer.size() - offset;
+            continue;
+        }
+
+        // A valid record always fits in the remainder of the ring.
+        if (header.record_size < sizeof(header) || header.record_size > available)
+        {
+            cursor = _head.load(std::memory_order_acquire);
+            return read_result::overrun;
+        }
+
+        cursor += header.record_size;
+        return read_result::record;
+    }
+}
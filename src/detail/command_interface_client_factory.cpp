@@ -5,6 +5,7 @@
 
 #include <ws-streaming/detail/command_interface_client.hpp>
 #include <ws-streaming/detail/command_interface_client_factory.hpp>
+#include <ws-streaming/detail/endpoint.hpp>
 #include <ws-streaming/detail/http_command_interface_client.hpp>
 #include <ws-streaming/detail/in_band_command_interface_client.hpp>
 #include <ws-streaming/detail/peer.hpp>
@@ -21,7 +22,11 @@ wss::detail::command_interface_client_factory::create_client(
     if (interfaces.contains("jsonrpc"))
         return std::make_unique<in_band_command_interface_client>(peer);
 
-    if (interfaces.contains("jsonrpc-http")
+    // The HTTP command interface can only be reached if the remote peer has an IP address.
+    auto remote_endpoint = to_tcp_endpoint(peer->socket().remote_endpoint());
+
+    if (remote_endpoint
+        && interfaces.contains("jsonrpc-http")
         && interfaces["jsonrpc-http"].is_object()
         && interfaces["jsonrpc-http"].contains("httpMethod")
         && interfaces["jsonrpc-http"]["httpMethod"].is_string()
@@ -40,7 +45,7 @@ wss::detail::command_interface_client_factory::create_client(
 
         return std::make_unique<http_command_interface_client>(
             peer->socket().get_executor(),
-            peer->socket().remote_endpoint().address().to_string(),
+            remote_endpoint->address().to_string(),
             port,
             interfaces["jsonrpc-http"]["httpMethod"],
             interfaces["jsonrpc-http"]["httpPath"],
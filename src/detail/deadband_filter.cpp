@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <boost/asio/buffer.hpp>
+
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/sample_converter.hpp>
+#include <ws-streaming/detail/deadband_filter.hpp>
+
+wss::detail::deadband_filter::deadband_filter(
+        const metadata& metadata,
+        double absolute,
+        double relative,
+        std::chrono::steady_clock::duration heartbeat)
+    : _converter(metadata, false)
+    , _absolute(absolute)
+    , _relative(relative)
+    , _heartbeat(heartbeat)
+{
+}
+
+void wss::detail::deadband_filter::update(const metadata& metadata)
+{
+    _converter = sample_converter{metadata, false};
+    _has_reference = false;
+}
+
+bool wss::detail::deadband_filter::admit(
+    const boost::asio::const_buffer *buffers,
+    std::size_t buffer_count,
+    std::chrono::steady_clock::time_point now) noexcept
+{
+    std::size_t sample_size = _converter.sample_size();
+    if (!sample_size)
+        return true;
+
+    bool changed = !_has_reference
+        || (_heartbeat.count() && now - _last_transmitted >= _heartbeat);
+
+    double band = std::max(_absolute, _relative * std::abs(_reference));
+    double value = 0;
+    bool has_value = false;
+
+    // Samples may straddle buffer boundaries, in which case they are reassembled here. No
+    // supported data type is larger than eight bytes.
+    std::uint8_t sample[8];
+    std::size_t filled = 0;
+
+    for (std::size_t i = 0; i < buffer_count; ++i)
+    {
+        const auto *data = static_cast<const std::uint8_t *>(buffers[i].data());
+        std::size_t size = buffers[i].size();
+
+        while (size)
+        {
+            const std::uint8_t *source = data;
+            std::size_t n = std::min(size, sample_size - filled);
+
+            if (filled || n < sample_size)
+            {
+                std::memcpy(sample + filled, data, n);
+                filled += n;
+                source = sample;
+            }
+
+            data += n;
+            size -= n;
+
+            if (source == sample && filled < sample_size)
+                continue;
+
+            filled = 0;
+            _converter.convert(source, 1, &value);
+            has_value = true;
+
+            // Written so that NaN values count as changes.
+            if (!changed && !(std::abs(value - _reference) <= band))
+                changed = true;
+        }
+    }
+
+    if (!has_value)
+        return true;
+
+    if (changed)
+    {
+        _has_reference = true;
+        _reference = value;
+        _last_transmitted = now;
+    }
+
+    return changed;
+}
@@ -0,0 +1,157 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/endian/conversion.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/endianness.hpp>
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/sample_converter.hpp>
+#include <ws-streaming/struct_field_builder.hpp>
+#include <ws-streaming/detail/const_buffer_span.hpp>
+#include <ws-streaming/detail/decimated_signal.hpp>
+#include <ws-streaming/detail/envelope_decimator.hpp>
+
+using namespace std::placeholders;
+
+wss::detail::decimated_signal::decimated_signal(
+        const std::string& id,
+        local_signal& source,
+        const std::string& domain_id,
+        std::int64_t domain_delta,
+        std::size_t factor)
+    : _source(source)
+    , _signal(id, make_metadata(source.metadata(), domain_id))
+    , _domain_id(domain_id)
+    , _domain_delta(domain_delta)
+    , _converter(source.metadata())
+    , _decimator(factor)
+{
+    _signal.set_domain_tolerance(source.domain_tolerance());
+
+    _on_subscribed = _signal.on_subscribed.connect(
+        std::bind(&decimated_signal::on_subscribed, this));
+    _on_unsubscribed = _signal.on_unsubscribed.connect(
+        std::bind(&decimated_signal::on_unsubscribed, this));
+}
+
+wss::local_signal& wss::detail::decimated_signal::signal() noexcept
+{
+    return _signal;
+}
+
+wss::local_signal& wss::detail::decimated_signal::source() noexcept
+{
+    return _source;
+}
+
+const std::string& wss::detail::decimated_signal::domain_id() const noexcept
+{
+    return _domain_id;
+}
+
+wss::metadata wss::detail::decimated_signal::make_metadata(
+    const metadata& source,
+    const std::string& domain_id)
+{
+    nlohmann::json json = source.json();
+
+    // Envelopes are calculated from converted, post-scaled values, and transmitted as three
+    // real64 values in native byte order.
+    auto& definition = json["definition"];
+    definition.erase("postScaling");
+    definition["dataType"] = data_types::struct_t;
+    definition["endian"] = boost::endian::order::native == boost::endian::order::little
+        ? endianness::little
+        : endianness::big;
+    definition["struct"] = {
+        struct_field_builder{"Min"}.data_type(data_types::real64_t).build(),
+        struct_field_builder{"Max"}.data_type(data_types::real64_t).build(),
+        struct_field_builder{"Mean"}.data_type(data_types::real64_t).build(),
+    };
+
+    json["tableId"] = domain_id;
+
+    return json;
+}
+
+void wss::detail::decimated_signal::on_subscribed()
+{
+    // The source's metadata may have changed while we were not observing it.
+    on_source_metadata_changed();
+
+    _source_holder = _source.increment_subscribe_count();
+
+    _on_source_metadata_changed = _source.on_metadata_changed.connect(
+        std::bind(&decimated_signal::on_source_metadata_changed, this));
+    _on_source_data_published = _source.on_data_published.connect(
+        std::bind(&decimated_signal::on_source_data_published, this, _1, _2, _3, _4, _5));
+}
+
+void wss::detail::decimated_signal::on_unsubscribed()
+{
+    _on_source_data_published.disconnect();
+    _on_source_metadata_changed.disconnect();
+    _source_holder.close();
+}
+
+void wss::detail::decimated_signal::on_source_metadata_changed()
+{
+    _converter = sample_converter{_source.metadata()};
+    _decimator.reset();
+
+    _signal.set_metadata(make_metadata(_source.metadata(), _domain_id));
+}
+
+void wss::detail::decimated_signal::on_source_data_published(
+    std::int64_t domain_value,
+    std::size_t sample_count,
+    const boost::asio::const_buffer *buffers,
+    std::size_t buffer_count,
+    const std::shared_ptr<const void>&)
+{
+    if (!_converter.valid())
+        return;
+
+    const void *data = buffer_count == 1 ? buffers[0].data() : nullptr;
+    std::size_t size = boost::asio::buffer_size(const_buffer_span{buffers, buffer_count});
+
+    // The converter requires contiguous input.
+    if (buffer_count != 1)
+    {
+        _data.resize(size);
+        boost::asio::buffer_copy(
+            boost::asio::buffer(_data),
+            const_buffer_span{buffers, buffer_count});
+        data = _data.data();
+    }
+
+    std::size_t count = size / _converter.sample_size();
+    if (sample_count && sample_count < count)
+        count = sample_count;
+
+    _values.resize(count);
+    _converter.convert(data, count, _values.data());
+
+    _envelopes.clear();
+    std::int64_t first_domain_value = _decimator.process(
+        _values.data(),
+        count,
+        domain_value,
+        _domain_delta,
+        _envelopes);
+
+    if (!_envelopes.empty())
+        _signal.publish_data(
+            first_domain_value,
+            _envelopes.size(),
+            _envelopes.data(),
+            _envelopes.size() * sizeof(envelope_decimator::envelope));
+}
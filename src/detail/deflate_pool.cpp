@@ -0,0 +1,75 @@
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+#include <boost/beast/zlib/deflate_stream.hpp>
+
+#include <ws-streaming/detail/deflate_pool.hpp>
+
+wss::detail::deflate_pool::deflate_pool(std::size_t max_streams)
+    : _max_streams(max_streams)
+{
+}
+
+std::shared_ptr<boost::beast::zlib::deflate_stream>
+wss::detail::deflate_pool::acquire(unsigned window_bits)
+{
+    std::unique_ptr<boost::beast::zlib::deflate_stream> stream;
+
+    {
+        std::lock_guard lock{_mutex};
+
+        if (!_idle.empty())
+        {
+            stream = std::move(_idle.back());
+            _idle.pop_back();
+        }
+
+        else if (_stream_count < _max_streams)
+            ++_stream_count;
+
+        else
+            return nullptr;
+    }
+
+    if (!stream)
+        stream = std::make_unique<boost::beast::zlib::deflate_stream>();
+
+    // Resetting with unchanged parameters keeps the stream's buffers.
+    stream->reset(
+        COMPRESSION_LEVEL,
+        window_bits,
+        MEMORY_LEVEL,
+        boost::beast::zlib::Strategy::normal);
+
+    return {
+        stream.release(),
+        [self = shared_from_this()](boost::beast::zlib::deflate_stream *stream)
+        {
+            self->release(stream);
+        }
+    };
+}
+
+void wss::detail::deflate_pool::set_max_streams(std::size_t max_streams)
+{
+    std::lock_guard lock{_mutex};
+    _max_streams = max_streams;
+
+    while (_stream_count > _max_streams && !_idle.empty())
+    {
+        _idle.pop_back();
+        --_stream_count;
+    }
+}
+
+void wss::detail::deflate_pool::release(boost::beast::zlib::deflate_stream *stream) noexcept
+{
+    std::unique_ptr<boost::beast::zlib::deflate_stream> owned{stream};
+    std::lock_guard lock{_mutex};
+
+    if (_stream_count > _max_streams)
+        --_stream_count;
+    else
+        _idle.push_back(std::move(owned));
+}
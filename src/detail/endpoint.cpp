@@ -0,0 +1,84 @@
+#include <cstring>
+#include <optional>
+#include <string>
+
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <ws-streaming/detail/endpoint.hpp>
+
+std::optional<boost::asio::ip::tcp::endpoint> wss::detail::to_tcp_endpoint(
+    const boost::asio::generic::stream_protocol::endpoint& endpoint)
+{
+    int family = endpoint.protocol().family();
+
+    if (family != BOOST_ASIO_OS_DEF(AF_INET) && family != BOOST_ASIO_OS_DEF(AF_INET6))
+        return std::nullopt;
+
+    boost::asio::ip::tcp::endpoint tcp_endpoint;
+
+    if (endpoint.size() > tcp_endpoint.capacity())
+        return std::nullopt;
+
+    std::memcpy(tcp_endpoint.data(), endpoint.data(), endpoint.size());
+    tcp_endpoint.resize(endpoint.size());
+
+    return tcp_endpoint;
+}
+
+std::string wss::detail::to_string(
+    const boost::asio::generic::stream_protocol::endpoint& endpoint)
+{
+    if (auto tcp_endpoint = to_tcp_endpoint(endpoint); tcp_endpoint)
+        return tcp_endpoint->address().to_string()
+            + ":" + std::to_string(tcp_endpoint->port());
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    if (endpoint.protocol().family() == AF_UNIX)
+    {
+        boost::asio::local::stream_protocol::endpoint local_endpoint;
+
+        if (endpoint.size() <= local_endpoint.capacity())
+        {
+            std::memcpy(local_endpoint.data(), endpoint.data(), endpoint.size());
+            local_endpoint.resize(endpoint.size());
+            return "unix:" + local_endpoint.path();
+        }
+    }
+#endif
+
+    return "family" + std::to_string(endpoint.protocol().family()) + ":";
+}
+
+bool wss::detail::is_same_host(
+    const boost::asio::generic::stream_protocol::socket& socket) noexcept
+{
+    boost::system::error_code ec;
+
+    auto remote_endpoint = socket.remote_endpoint(ec);
+    if (ec)
+        return false;
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    if (remote_endpoint.protocol().family() == AF_UNIX)
+        return true;
+#endif
+
+    auto remote_tcp_endpoint = to_tcp_endpoint(remote_endpoint);
+    if (!remote_tcp_endpoint)
+        return false;
+
+    if (remote_tcp_endpoint->address().is_loopback())
+        return true;
+
+    auto local_endpoint = socket.local_endpoint(ec);
+    if (ec)
+        return false;
+
+    auto local_tcp_endpoint = to_tcp_endpoint(local_endpoint);
+
+    return local_tcp_endpoint
+        && local_tcp_endpoint->address() == remote_tcp_endpoint->address();
+}
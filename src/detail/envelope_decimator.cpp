@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+#include <ws-streaming/detail/envelope_decimator.hpp>
+
+static_assert(sizeof(wss::detail::envelope_decimator::envelope) == 3 * sizeof(double),
+    "envelopes are transmitted as three consecutive real64 values");
+
+// Reduces a run of samples into the running minimum, maximum and sum. Compilers do not
+// vectorize floating-point reductions on their own (doing so reorders the operations), so
+// SSE2 is used explicitly where available. The min/max comparisons match those of MINPD and
+// MAXPD, so both paths treat NaN values identically.
+static void reduce(
+    const double *values,
+    std::size_t count,
+    double& min,
+    double& max,
+    double& sum) noexcept
+{
+    std::size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    if (count >= 4)
+    {
+        // Two vectors of accumulators hide the latency of the dependent operations.
+        __m128d min0 = _mm_set1_pd(min), min1 = min0;
+        __m128d max0 = _mm_set1_pd(max), max1 = max0;
+        __m128d sum0 = _mm_setzero_pd(), sum1 = sum0;
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128d a = _mm_loadu_pd(values + i);
+            __m128d b = _mm_loadu_pd(values + i + 2);
+
+            min0 = _mm_min_pd(a, min0);
+            min1 = _mm_min_pd(b, min1);
+            max0 = _mm_max_pd(a, max0);
+            max1 = _mm_max_pd(b, max1);
+            sum0 = _mm_add_pd(sum0, a);
+            sum1 = _mm_add_pd(sum1, b);
+        }
+
+        double lanes[2];
+
+        _mm_storeu_pd(lanes, _mm_min_pd(min0, min1));
+        min = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+
+        _mm_storeu_pd(lanes, _mm_max_pd(max0, max1));
+        max = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+
+        _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+        sum += lanes[0] + lanes[1];
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        min = values[i] < min ? values[i] : min;
+        max = values[i] > max ? values[i] : max;
+        sum += values[i];
+    }
+}
+
+wss::detail::envelope_decimator::envelope_decimator(std::size_t factor)
+    : _factor(std::max<std::size_t>(factor, 1))
+{
+}
+
+std::size_t wss::detail::envelope_decimator::factor() const noexcept
+{
+    return _factor;
+}
+
+void wss::detail::envelope_decimator::reset() noexcept
+{
+    _count = 0;
+}
+
+std::int64_t wss::detail::envelope_decimator::process(
+    const double *values,
+    std::size_t count,
+    std::int64_t domain_value,
+    std::int64_t domain_delta,
+    std::vector<envelope>& output)
+{
+    std::size_t first_output = output.size();
+    std::int64_t first_start = 0;
+
+    for (std::size_t i = 0; i < count; )
+    {
+        if (_count == 0)
+        {
+            _start = domain_value + static_cast<std::int64_t>(i) * domain_delta;
+            _min = _max = values[i];
+            _sum = 0;
+        }
+
+        std::size_t n = std::min(_factor - _count, count - i);
+        reduce(values + i, n, _min, _max, _sum);
+        _count += n;
+        i += n;
+
+        if (_count == _factor)
+        {
+            if (output.size() == first_output)
+                first_start = _start;
+
+            output.push_back({ _min, _max, _sum / static_cast<double>(_factor) });
+            _count = 0;
+        }
+    }
+
+    return first_start;
+}
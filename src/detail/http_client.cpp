@@ -3,12 +3,13 @@
 #include <functional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/beast/version.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
-#include <boost/beast/core/tcp_stream.hpp>
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/http/string_body.hpp>
@@ -31,24 +32,9 @@ void wss::detail::http_client::async_request(
     const std::string& hostname,
     const std::string& port,
     boost::beast::http::request<boost::beast::http::string_body>&& request,
-    std::function<
-        void(
-            const boost::system::error_code& ec,
-            const boost::beast::http::response<boost::beast::http::string_body>& response,
-            boost::beast::tcp_stream& stream,
-            const boost::beast::flat_buffer& buffer)
-    > handler)
+    handler_type handler)
 {
-    _handler = std::move(handler);
-
-    request.set(boost::beast::http::field::user_agent,
-        "ws-streaming/" WS_STREAMING_VERSION_MAJOR
-            "." WS_STREAMING_VERSION_MINOR
-            "." WS_STREAMING_VERSION_PATCH
-            " " BOOST_BEAST_VERSION_STRING);
-
-    request.prepare_payload();
-    _request = std::move(request);
+    prepare_request(std::move(request), std::move(handler));
 
     _resolver.async_resolve(
         hostname,
@@ -60,12 +46,43 @@ void wss::detail::http_client::async_request(
             std::placeholders::_2));
 }
 
+void wss::detail::http_client::async_request(
+    const boost::asio::generic::stream_protocol::endpoint& endpoint,
+    boost::beast::http::request<boost::beast::http::string_body>&& request,
+    handler_type handler)
+{
+    prepare_request(std::move(request), std::move(handler));
+
+    _stream.async_connect(
+        endpoint,
+        std::bind(
+            &http_client::finish_connect,
+            shared_from_this(),
+            std::placeholders::_1));
+}
+
 void wss::detail::http_client::cancel()
 {
     _resolver.cancel();
     _stream.cancel();
 }
 
+void wss::detail::http_client::prepare_request(
+    boost::beast::http::request<boost::beast::http::string_body>&& request,
+    handler_type&& handler)
+{
+    _handler = std::move(handler);
+
+    request.set(boost::beast::http::field::user_agent,
+        "ws-streaming/" WS_STREAMING_VERSION_MAJOR
+            "." WS_STREAMING_VERSION_MINOR
+            "." WS_STREAMING_VERSION_PATCH
+            " " BOOST_BEAST_VERSION_STRING);
+
+    request.prepare_payload();
+    _request = std::move(request);
+}
+
 void wss::detail::http_client::finish_resolve(
     const boost::system::error_code& ec,
     const boost::asio::ip::tcp::resolver::results_type& results)
@@ -73,8 +90,13 @@ void wss::detail::http_client::finish_resolve(
     if (ec)
         return complete(ec);
 
+    // The stream is protocol-independent, so convert the resolved TCP endpoints.
+    std::vector<boost::asio::generic::stream_protocol::endpoint> endpoints;
+    for (const auto& result : results)
+        endpoints.emplace_back(result.endpoint());
+
     _stream.async_connect(
-        results,
+        endpoints,
         std::bind(
             &http_client::finish_connect,
             shared_from_this(),
@@ -5,7 +5,8 @@
 #include <string>
 #include <utility>
 
-#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/socket_base.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
 #include <boost/beast/version.hpp>
 #include <boost/beast/core/async_base.hpp>
 #include <boost/beast/core/error.hpp>
@@ -20,14 +21,17 @@
 #include <boost/system/error_code.hpp>
 
 #include <ws-streaming/detail/http_client_servicer.hpp>
+#include <ws-streaming/detail/websocket_extensions.hpp>
 #include <ws-streaming/detail/websocket_protocol.hpp>
 
 using namespace std::chrono_literals;
 using namespace std::placeholders;
 
 wss::detail::http_client_servicer::http_client_servicer(
-        boost::asio::ip::tcp::socket&& socket)
+        boost::asio::generic::stream_protocol::socket&& socket,
+        const websocket_extensions& supported)
     : stream(std::move(socket))
+    , supported_extensions(supported)
 {
 }
 
@@ -117,6 +121,15 @@ void wss::detail::http_client_servicer::finish_read(
         res.set(boost::beast::http::field::upgrade, "websocket");
         res.set(boost::beast::http::field::sec_websocket_accept, response_key);
 
+        std::string extensions_header;
+        extensions = websocket_extensions::negotiate(
+            std::string(get_header(boost::beast::http::field::sec_websocket_extensions)),
+            supported_extensions,
+            extensions_header);
+
+        if (!extensions_header.empty())
+            res.set(boost::beast::http::field::sec_websocket_extensions, extensions_header);
+
         do_response(res);
     }
 
@@ -227,7 +240,7 @@ void wss::detail::http_client_servicer::finish_write(
         case response_actions::upgrade:
         {
             auto socket = stream.release_socket();
-            return on_websocket_upgrade(socket);
+            return on_websocket_upgrade(socket, extensions);
         }
 
         default:
@@ -323,7 +336,7 @@ void wss::detail::http_client_servicer::close(
         return;
 
     boost::beast::error_code shutdown_ec;
-    stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_send, shutdown_ec);
+    stream.socket().shutdown(boost::asio::socket_base::shutdown_send, shutdown_ec);
     stream.close();
 
     on_closed(ec);
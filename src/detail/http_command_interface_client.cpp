@@ -6,7 +6,6 @@
 
 #include <boost/asio/any_io_executor.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
-#include <boost/beast/core/tcp_stream.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/beast/http/error.hpp>
 #include <boost/beast/http/field.hpp>
@@ -66,7 +65,7 @@ void wss::detail::http_command_interface_client::async_request(
         [this, handler = std::move(handler), client](
             const boost::system::error_code& ec,
             const boost::beast::http::response<boost::beast::http::string_body>& response,
-            boost::beast::tcp_stream& stream,
+            detail::http_client::stream_type& stream,
             const boost::beast::flat_buffer& buffer)
         {
             _clients.erase(client);
@@ -0,0 +1,77 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+#include <ws-streaming/detail/const_buffer_span.hpp>
+#include <ws-streaming/detail/last_value_cache.hpp>
+
+void wss::detail::last_value_cache::enable(bool enable)
+{
+    std::lock_guard lock{_mutex};
+
+    _enabled.store(enable, std::memory_order_relaxed);
+
+    if (!enable)
+    {
+        _block.reset();
+        _buffer.reset();
+    }
+}
+
+bool wss::detail::last_value_cache::enabled() const noexcept
+{
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+void wss::detail::last_value_cache::store(
+    std::uint64_t sequence,
+    std::int64_t domain_value,
+    std::size_t sample_count,
+    const boost::asio::const_buffer *buffers,
+    std::size_t buffer_count,
+    const std::shared_ptr<const void>& owner)
+{
+    if (!enabled())
+        return;
+
+    std::lock_guard lock{_mutex};
+
+    // Release our own reference to the previous block first, so that its memory can be reused
+    // if no endpoint is still transmitting it.
+    _block.reset();
+
+    block stored;
+    stored.sequence = sequence;
+    stored.domain_value = domain_value;
+    stored.sample_count = sample_count;
+    stored.size = boost::asio::buffer_size(const_buffer_span{buffers, buffer_count});
+
+    if (owner && buffer_count == 1)
+        stored.data = std::shared_ptr<const void>{owner, buffers[0].data()};
+
+    else
+    {
+        if (!_buffer || _buffer.use_count() > 1)
+            _buffer = std::make_shared<std::vector<std::uint8_t>>();
+
+        _buffer->resize(stored.size);
+        boost::asio::buffer_copy(
+            boost::asio::buffer(*_buffer),
+            const_buffer_span{buffers, buffer_count});
+
+        stored.data = std::shared_ptr<const void>{_buffer, _buffer->data()};
+    }
+
+    _block = std::move(stored);
+}
+
+std::optional<wss::detail::last_value_cache::block> wss::detail::last_value_cache::load() const
+{
+    std::lock_guard lock{_mutex};
+    return _block;
+}
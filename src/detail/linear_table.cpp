@@ -39,6 +39,11 @@ std::int64_t wss::detail::linear_table::driven_value() const noexcept
     return _value + _delta * (_driven_index - _index);
 }
 
+std::int64_t wss::detail::linear_table::delta() const noexcept
+{
+    return _delta;
+}
+
 std::int64_t wss::detail::linear_table::value_at(std::int64_t index) const noexcept
 {
     return _value + _delta * (index - _index);
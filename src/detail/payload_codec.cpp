@@ -0,0 +1,608 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/encodings.hpp>
+#include <ws-streaming/endianness.hpp>
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/rule_types.hpp>
+#include <ws-streaming/detail/payload_codec.hpp>
+
+// Appends a little-endian bitstream to a byte vector: the first bit written is the least
+// significant bit of the first byte.
+class bit_writer
+{
+    public:
+
+        bit_writer(std::vector<std::uint8_t>& output) noexcept
+            : _output(output)
+        {
+        }
+
+        void write(std::uint64_t value, unsigned bits)
+        {
+            if (bits > 32)
+            {
+                write(value & 0xFFFFFFFF, 32);
+                value >>= 32;
+                bits -= 32;
+            }
+
+            _bits |= (value & ((std::uint64_t{1} << bits) - 1)) << _count;
+            _count += bits;
+
+            for (; _count >= 8; _count -= 8, _bits >>= 8)
+                _output.push_back(static_cast<std::uint8_t>(_bits));
+        }
+
+        void flush()
+        {
+            if (_count)
+                _output.push_back(static_cast<std::uint8_t>(_bits));
+
+            _bits = 0;
+            _count = 0;
+        }
+
+    private:
+
+        std::vector<std::uint8_t>& _output;
+        std::uint64_t _bits = 0;
+        unsigned _count = 0;
+};
+
+// Reads a bitstream written by bit_writer, failing rather than reading past the end.
+class bit_reader
+{
+    public:
+
+        bit_reader(const std::uint8_t *data, std::size_t size) noexcept
+            : _data(data)
+            , _end(data + size)
+        {
+        }
+
+        bool read(unsigned bits, std::uint64_t& value) noexcept
+        {
+            if (bits > 32)
+            {
+                std::uint64_t low, high;
+
+                if (!read(32, low) || !read(bits - 32, high))
+                    return false;
+
+                value = low | (high << 32);
+                return true;
+            }
+
+            for (; _count < bits; _count += 8)
+            {
+                if (_data == _end)
+                    return false;
+                _bits |= std::uint64_t{*_data++} << _count;
+            }
+
+            value = _bits & ((std::uint64_t{1} << bits) - 1);
+            _bits >>= bits;
+            _count -= bits;
+            return true;
+        }
+
+        void align() noexcept
+        {
+            _bits = 0;
+            _count = 0;
+        }
+
+    private:
+
+        const std::uint8_t *_data;
+        const std::uint8_t *_end;
+        std::uint64_t _bits = 0;
+        unsigned _count = 0;
+};
+
+template <typename Unsigned, bool Swap>
+static inline Unsigned load(const std::uint8_t *data) noexcept
+{
+    Unsigned value;
+    std::memcpy(&value, data, sizeof(value));
+
+    if constexpr (Swap)
+        value = boost::endian::endian_reverse(value);
+
+    return value;
+}
+
+template <typename Unsigned, bool Swap>
+static inline void store(std::uint8_t *data, Unsigned value) noexcept
+{
+    if constexpr (Swap)
+        value = boost::endian::endian_reverse(value);
+
+    std::memcpy(data, &value, sizeof(value));
+}
+
+static unsigned bit_width(std::uint64_t value) noexcept
+{
+#if defined(__GNUC__)
+    return value ? 64 - __builtin_clzll(value) : 0;
+#else
+    unsigned width = 0;
+
+    for (; value; value >>= 1)
+        ++width;
+
+    return width;
+#endif
+}
+
+static unsigned leading_zeros(std::uint64_t value, unsigned bits) noexcept
+{
+    return bits - bit_width(value);
+}
+
+static unsigned trailing_zeros(std::uint64_t value) noexcept
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(value);
+#else
+    unsigned count = 0;
+
+    for (; !(value & 1); value >>= 1)
+        ++count;
+
+    return count;
+#endif
+}
+
+template <typename Unsigned>
+static inline Unsigned zigzag(Unsigned value) noexcept
+{
+    constexpr unsigned bits = 8 * sizeof(Unsigned);
+    return static_cast<Unsigned>(value << 1) ^ static_cast<Unsigned>(0 - (value >> (bits - 1)));
+}
+
+template <typename Unsigned>
+static inline Unsigned unzigzag(Unsigned value) noexcept
+{
+    return static_cast<Unsigned>(value >> 1) ^ static_cast<Unsigned>(0 - (value & 1));
+}
+
+// Residuals are computed in the unsigned type of the sample's width, so that differences wrap
+// around exactly as the samples themselves would and the encoding is lossless for any input.
+// The first Order residuals (the first sample, and for delta-of-delta the first difference)
+// are stored at full width, so that they do not inflate the bit width of the first group.
+template <typename Unsigned, bool Swap, unsigned Order>
+static void encode_integers(
+    const std::uint8_t *input,
+    std::size_t sample_count,
+    std::vector<std::uint8_t>& output)
+{
+    constexpr unsigned bits = 8 * sizeof(Unsigned);
+
+    bit_writer writer(output);
+    Unsigned residuals[wss::detail::payload_codec::GROUP_SIZE];
+    Unsigned previous = 0;
+    Unsigned previous_delta = 0;
+
+    auto next_residual = [&](std::size_t i)
+    {
+        Unsigned value = load<Unsigned, Swap>(input + i * sizeof(Unsigned));
+        Unsigned delta = value - previous;
+        Unsigned residual = delta;
+
+        if constexpr (Order == 2)
+            if (i >= 2)
+                residual = delta - previous_delta;
+
+        previous = value;
+        previous_delta = delta;
+        return residual;
+    };
+
+    std::size_t done = 0;
+
+    for (; done < std::min<std::size_t>(Order, sample_count); ++done)
+        writer.write(next_residual(done), bits);
+
+    writer.flush();
+
+    while (done < sample_count)
+    {
+        std::size_t count = std::min(wss::detail::payload_codec::GROUP_SIZE, sample_count - done);
+        Unsigned all = 0;
+
+        for (std::size_t i = 0; i < count; ++i, ++done)
+            all |= residuals[i] = zigzag<Unsigned>(next_residual(done));
+
+        unsigned width = bit_width(all);
+        writer.write(width, 8);
+
+        for (std::size_t i = 0; i < count; ++i)
+            writer.write(residuals[i], width);
+
+        writer.flush();
+    }
+}
+
+template <typename Unsigned, bool Swap, unsigned Order>
+static bool decode_integers(
+    const std::uint8_t *input,
+    std::size_t size,
+    std::size_t sample_count,
+    std::uint8_t *output)
+{
+    constexpr unsigned bits = 8 * sizeof(Unsigned);
+
+    bit_reader reader(input, size);
+    Unsigned previous = 0;
+    Unsigned previous_delta = 0;
+
+    auto store_residual = [&](std::size_t i, Unsigned residual)
+    {
+        Unsigned delta = residual;
+
+        if constexpr (Order == 2)
+            if (i >= 2)
+                delta += previous_delta;
+
+        previous += delta;
+        previous_delta = delta;
+        store<Unsigned, Swap>(output + i * sizeof(Unsigned), previous);
+    };
+
+    std::size_t done = 0;
+
+    for (; done < std::min<std::size_t>(Order, sample_count); ++done)
+    {
+        std::uint64_t value;
+        if (!reader.read(bits, value))
+            return false;
+
+        store_residual(done, static_cast<Unsigned>(value));
+    }
+
+    reader.align();
+
+    while (done < sample_count)
+    {
+        std::size_t count = std::min(wss::detail::payload_codec::GROUP_SIZE, sample_count - done);
+        std::uint64_t width;
+
+        if (!reader.read(8, width) || width > bits)
+            return false;
+
+        for (std::size_t i = 0; i < count; ++i, ++done)
+        {
+            std::uint64_t value;
+            if (!reader.read(static_cast<unsigned>(width), value))
+                return false;
+
+            store_residual(done, unzigzag<Unsigned>(static_cast<Unsigned>(value)));
+        }
+
+        reader.align();
+    }
+
+    return true;
+}
+
+template <typename Unsigned, bool Swap>
+static void encode_floats(
+    const std::uint8_t *input,
+    std::size_t sample_count,
+    std::vector<std::uint8_t>& output)
+{
+    constexpr unsigned bits = 8 * sizeof(Unsigned);
+    constexpr unsigned field_bits = bits == 32 ? 5 : 6;
+
+    if (!sample_count)
+        return;
+
+    bit_writer writer(output);
+    Unsigned previous = load<Unsigned, Swap>(input);
+    unsigned window_leading = bits;
+    unsigned window_trailing = 0;
+
+    writer.write(previous, bits);
+
+    for (std::size_t i = 1; i < sample_count; ++i)
+    {
+        Unsigned value = load<Unsigned, Swap>(input + i * sizeof(Unsigned));
+        Unsigned x = value ^ previous;
+        previous = value;
+
+        if (!x)
+        {
+            writer.write(0, 1);
+            continue;
+        }
+
+        unsigned leading = leading_zeros(x, bits);
+        unsigned trailing = trailing_zeros(x);
+
+        // Reuse the previous window of meaningful bits if this value fits in it.
+        if (window_leading < bits && leading >= window_leading && trailing >= window_trailing)
+        {
+            writer.write(0b01, 2);
+            writer.write(x >> window_trailing, bits - window_leading - window_trailing);
+        }
+
+        else
+        {
+            unsigned length = bits - leading - trailing;
+
+            writer.write(0b11, 2);
+            writer.write(leading, field_bits);
+            writer.write(length - 1, field_bits);
+            writer.write(x >> trailing, length);
+
+            window_leading = leading;
+            window_trailing = trailing;
+        }
+    }
+
+    writer.flush();
+}
+
+template <typename Unsigned, bool Swap>
+static bool decode_floats(
+    const std::uint8_t *input,
+    std::size_t size,
+    std::size_t sample_count,
+    std::uint8_t *output)
+{
+    constexpr unsigned bits = 8 * sizeof(Unsigned);
+    constexpr unsigned field_bits = bits == 32 ? 5 : 6;
+
+    if (!sample_count)
+        return true;
+
+    bit_reader reader(input, size);
+    std::uint64_t value;
+    unsigned window_leading = bits;
+    unsigned window_trailing = 0;
+
+    if (!reader.read(bits, value))
+        return false;
+
+    Unsigned previous = static_cast<Unsigned>(value);
+    store<Unsigned, Swap>(output, previous);
+
+    for (std::size_t i = 1; i < sample_count; ++i)
+    {
+        std::uint64_t control;
+        if (!reader.read(1, control))
+            return false;
+
+        if (control)
+        {
+            if (!reader.read(1, control))
+                return false;
+
+            if (control)
+            {
+                std::uint64_t leading, length;
+
+                if (!reader.read(field_bits, leading)
+                        || !reader.read(field_bits, length)
+                        || leading + length + 1 > bits)
+                    return false;
+
+                window_leading = static_cast<unsigned>(leading);
+                window_trailing = static_cast<unsigned>(bits - leading - length - 1);
+            }
+
+            else if (window_leading >= bits)
+                return false;
+
+            if (!reader.read(bits - window_leading - window_trailing, value))
+                return false;
+
+            previous ^= static_cast<Unsigned>(value << window_trailing);
+        }
+
+        store<Unsigned, Swap>(output + i * sizeof(Unsigned), previous);
+    }
+
+    return true;
+}
+
+template <typename Unsigned, bool Swap, typename Encode, typename Decode>
+static std::size_t select_integer_codec(
+    const std::string& encoding,
+    Encode& encode,
+    Decode& decode) noexcept
+{
+    if (encoding == wss::encodings::delta)
+    {
+        encode = &encode_integers<Unsigned, Swap, 1>;
+        decode = &decode_integers<Unsigned, Swap, 1>;
+    }
+
+    else if (encoding == wss::encodings::delta_of_delta)
+    {
+        encode = &encode_integers<Unsigned, Swap, 2>;
+        decode = &decode_integers<Unsigned, Swap, 2>;
+    }
+
+    return encode ? sizeof(Unsigned) : 0;
+}
+
+template <typename Unsigned, typename Encode, typename Decode>
+static std::size_t select_integer_codec(
+    const std::string& encoding,
+    bool swap,
+    Encode& encode,
+    Decode& decode) noexcept
+{
+    return swap
+        ? select_integer_codec<Unsigned, true>(encoding, encode, decode)
+        : select_integer_codec<Unsigned, false>(encoding, encode, decode);
+}
+
+template <typename Unsigned, typename Encode, typename Decode>
+static std::size_t select_float_codec(
+    const std::string& encoding,
+    bool swap,
+    Encode& encode,
+    Decode& decode) noexcept
+{
+    if (encoding != wss::encodings::xor_float)
+        return 0;
+
+    encode = swap ? &encode_floats<Unsigned, true> : &encode_floats<Unsigned, false>;
+    decode = swap ? &decode_floats<Unsigned, true> : &decode_floats<Unsigned, false>;
+    return sizeof(Unsigned);
+}
+
+static void write_varint(std::vector<std::uint8_t>& output, std::uint64_t value)
+{
+    for (; value >= 0x80; value >>= 7)
+        output.push_back(static_cast<std::uint8_t>(value | 0x80));
+
+    output.push_back(static_cast<std::uint8_t>(value));
+}
+
+static bool read_varint(
+    const std::uint8_t *& data,
+    const std::uint8_t *end,
+    std::uint64_t& value) noexcept
+{
+    value = 0;
+
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        if (data == end)
+            return false;
+
+        std::uint8_t byte = *data++;
+        value |= std::uint64_t{byte & 0x7Fu} << shift;
+
+        if (!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+wss::detail::payload_codec::payload_codec() noexcept
+{
+}
+
+wss::detail::payload_codec::payload_codec(const metadata& metadata)
+{
+    std::string encoding = metadata.encoding();
+
+    if (encoding.empty() || metadata.rule() != rule_types::explicit_rule)
+        return;
+
+    bool is_big_endian = metadata.endian() == endianness::big;
+    bool swap = is_big_endian != (boost::endian::order::native == boost::endian::order::big);
+
+    std::string type = metadata.data_type();
+
+    if (type == data_types::int8_t || type == data_types::uint8_t)
+        _sample_size = select_integer_codec<std::uint8_t>(encoding, swap, _encode, _decode);
+    else if (type == data_types::int16_t || type == data_types::uint16_t)
+        _sample_size = select_integer_codec<std::uint16_t>(encoding, swap, _encode, _decode);
+    else if (type == data_types::int32_t || type == data_types::uint32_t)
+        _sample_size = select_integer_codec<std::uint32_t>(encoding, swap, _encode, _decode);
+    else if (type == data_types::int64_t || type == data_types::uint64_t)
+        _sample_size = select_integer_codec<std::uint64_t>(encoding, swap, _encode, _decode);
+    else if (type == data_types::real32_t)
+        _sample_size = select_float_codec<std::uint32_t>(encoding, swap, _encode, _decode);
+    else if (type == data_types::real64_t)
+        _sample_size = select_float_codec<std::uint64_t>(encoding, swap, _encode, _decode);
+}
+
+void wss::detail::payload_codec::encode(
+    const void *data,
+    std::size_t size,
+    std::vector<std::uint8_t>& output) const
+{
+    const auto *input = static_cast<const std::uint8_t *>(data);
+
+    if (!_encode)
+    {
+        output.assign(input, input + size);
+        return;
+    }
+
+    std::size_t sample_count = size / _sample_size;
+    std::size_t raw_size = sample_count * _sample_size;
+
+    if (raw_size > MAX_DECODED_SIZE)
+    {
+        output.clear();
+        output.push_back(MODE_RAW);
+        output.insert(output.end(), input, input + raw_size);
+        return;
+    }
+
+    output.clear();
+    output.reserve(max_encoded_size(raw_size));
+    output.push_back(MODE_ENCODED);
+    write_varint(output, sample_count);
+    _encode(input, sample_count, output);
+
+    if (output.size() > raw_size)
+    {
+        output.clear();
+        output.push_back(MODE_RAW);
+        output.insert(output.end(), input, input + raw_size);
+    }
+}
+
+bool wss::detail::payload_codec::decode(
+    const void *data,
+    std::size_t size,
+    std::vector<std::uint8_t>& output) const
+{
+    const auto *input = static_cast<const std::uint8_t *>(data);
+    const auto *end = input + size;
+
+    if (!_decode)
+    {
+        output.assign(input, end);
+        return true;
+    }
+
+    output.clear();
+
+    if (!size)
+        return false;
+
+    std::uint8_t mode = *input++;
+
+    if (mode == MODE_RAW)
+    {
+        output.assign(input, end);
+        return true;
+    }
+
+    std::uint64_t sample_count;
+
+    if (mode != MODE_ENCODED
+            || !read_varint(input, end, sample_count)
+            || sample_count > static_cast<std::size_t>(end - input) * GROUP_SIZE
+            || sample_count > MAX_DECODED_SIZE / _sample_size)
+        return false;
+
+    output.resize(sample_count * _sample_size);
+
+    if (!_decode(input, end - input, sample_count, output.data()))
+    {
+        output.clear();
+        return false;
+    }
+
+    return true;
+}
@@ -5,26 +5,44 @@
 #include <cstring>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <utility>
 
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/error.hpp>
 #include <boost/asio/socket_base.hpp>
-#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/error.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+#include <boost/beast/zlib/zlib.hpp>
+#include <boost/endian/conversion.hpp>
 #include <boost/system/error_code.hpp>
+#include <boost/system/system_error.hpp>
 
 #include <nlohmann/json.hpp>
 
+#include <ws-streaming/detail/const_buffer_span.hpp>
+#include <ws-streaming/detail/deflate_pool.hpp>
+#include <ws-streaming/detail/endpoint.hpp>
+#include <ws-streaming/detail/framing.hpp>
 #include <ws-streaming/detail/peer.hpp>
+#include <ws-streaming/detail/shared_memory_ring.hpp>
 #include <ws-streaming/detail/streaming_protocol.hpp>
+#include <ws-streaming/detail/websocket_extensions.hpp>
 #include <ws-streaming/detail/websocket_protocol.hpp>
 
 using namespace std::placeholders;
 
+// The empty stored block with which a sync flush ends. RFC 7692 has senders strip it from each
+// compressed message, and receivers restore it.
+static constexpr std::uint8_t DEFLATE_TAIL[] = { 0x00, 0x00, 0xFF, 0xFF };
+
 wss::detail::peer::peer(
-        boost::asio::ip::tcp::socket&& socket,
+        boost::asio::generic::stream_protocol::socket&& socket,
         bool is_client,
         bool use_tcp_protocol,
         std::size_t rx_buffer_size,
@@ -74,12 +92,273 @@ void wss::detail::peer::stop()
     _socket.close(ec);
 }
 
+void wss::detail::peer::offer_shared_memory()
+{
+    if (_tx_ring)
+        return;
+
+    try
+    {
+        _tx_ring = std::make_unique<detail::shared_memory_ring>(_rx_buffer.size());
+    }
+
+    catch (const boost::system::system_error&)
+    {
+        return;
+    }
+
+    send_metadata(
+        0,
+        "sharedMemoryOffer",
+        {
+            { "name", _tx_ring->name() },
+            { "cookie", _tx_ring->cookie() },
+        });
+}
+
+void wss::detail::peer::enable_shared_memory() noexcept
+{
+    _shared_memory_enabled = true;
+}
+
+void wss::detail::peer::begin_batch() noexcept
+{
+    ++_batch_depth;
+}
+
+void wss::detail::peer::end_batch()
+{
+    if (!_batch_depth)
+        return;
+
+    if (_batch_depth == 1 && !_aggregate_entries.empty())
+        flush_aggregate();
+
+    if (_batch_depth == 1 && !_compress_input.empty())
+        flush_compressed_block();
+
+    if (--_batch_depth)
+        return;
+
+    // Transmit everything buffered during the batch at once, exactly as if the socket had just
+    // become writeable. If we were already waiting, the wait completion handler will do so.
+    if (_tx_queue_bytes && !_waiting_tx && !_is_closed)
+        finish_wait_tx({});
+}
+
+void wss::detail::peer::enable_aggregate_packets() noexcept
+{
+    _aggregate_packets = true;
+}
+
+void wss::detail::peer::enable_block_compression()
+{
+    // Block compression is a WebSocket extension, which the direct TCP protocol cannot carry.
+    if (!_use_tcp_protocol && !_block_compressor)
+        _block_compressor.emplace();
+}
+
+void wss::detail::peer::enable_permessage_deflate(
+    unsigned window_bits,
+    bool context_takeover,
+    std::shared_ptr<detail::deflate_pool> pool)
+{
+    if (_use_tcp_protocol)
+        return;
+
+    _inflate_enabled = true;
+
+    // Compressors cannot honor a window smaller than this, so we must not compress at all.
+    if (window_bits >= detail::websocket_extensions::MIN_WINDOW_BITS)
+    {
+        _deflate_pool = std::move(pool);
+        _deflate_window_bits = window_bits;
+        _deflate_context_takeover = context_takeover;
+    }
+}
+
+bool wss::detail::peer::deflate_message()
+{
+    // Borrow a compressor for this message only, unless we may keep it along with its context.
+    auto stream = _deflate_stream;
+
+    if (!stream)
+    {
+        stream = _deflate_pool->acquire(_deflate_window_bits);
+        if (!stream)
+            return false;
+
+        if (_deflate_context_takeover)
+            _deflate_stream = stream;
+    }
+
+    _deflate_output.resize(stream->upper_bound(_deflate_input.size()) + 2 * sizeof(DEFLATE_TAIL));
+
+    boost::beast::zlib::z_params zs;
+    zs.next_in = _deflate_input.data();
+    zs.avail_in = _deflate_input.size();
+    zs.next_out = _deflate_output.data();
+    zs.avail_out = _deflate_output.size();
+
+    boost::system::error_code ec;
+    stream->write(zs, boost::beast::zlib::Flush::sync, ec);
+
+    bool is_worthwhile = (!ec || ec == boost::beast::zlib::error::need_buffers)
+        && !zs.avail_in
+        && zs.total_out >= sizeof(DEFLATE_TAIL)
+        && zs.total_out - sizeof(DEFLATE_TAIL) < _deflate_input.size()
+        && !std::memcmp(
+            _deflate_output.data() + zs.total_out - sizeof(DEFLATE_TAIL),
+            DEFLATE_TAIL,
+            sizeof(DEFLATE_TAIL));
+
+    if (!is_worthwhile)
+    {
+        // The remote peer will not see this message compressed, so our context must forget it.
+        if (_deflate_stream)
+            _deflate_stream->reset();
+
+        return false;
+    }
+
+    _deflate_output.resize(zs.total_out - sizeof(DEFLATE_TAIL));
+    return true;
+}
+
+bool wss::detail::peer::inflate_message(
+    const std::uint8_t *data,
+    std::size_t size)
+{
+    if (!_inflate_stream)
+        _inflate_stream.emplace();
+
+    _inflated.clear();
+
+    for (auto [input, input_size] : { std::pair{data, size}, std::pair{DEFLATE_TAIL, sizeof(DEFLATE_TAIL)} })
+    {
+        boost::beast::zlib::z_params zs;
+        zs.next_in = input;
+        zs.avail_in = input_size;
+
+        // Decompressed messages are limited to the size of the receive buffer, like any other.
+        do
+        {
+            std::size_t offset = _inflated.size();
+            std::size_t room = std::min(
+                std::max<std::size_t>(4 * input_size, 4096),
+                _rx_buffer.size() - offset);
+
+            if (!room)
+                return false;
+
+            _inflated.resize(offset + room);
+            zs.next_out = _inflated.data() + offset;
+            zs.avail_out = room;
+
+            std::size_t avail_in = zs.avail_in;
+            boost::system::error_code ec;
+            _inflate_stream->write(zs, boost::beast::zlib::Flush::sync, ec);
+            _inflated.resize(offset + room - zs.avail_out);
+
+            // A final block ends the compressed stream, so the next message starts a new one.
+            if (ec == boost::beast::zlib::error::end_of_stream)
+            {
+                _inflate_stream->reset();
+                return true;
+            }
+
+            if (ec && ec != boost::beast::zlib::error::need_buffers)
+                return false;
+
+            if (zs.avail_in == avail_in && zs.avail_out == room)
+                break;
+        } while (zs.avail_in || !zs.avail_out);
+
+        if (zs.avail_in)
+            return false;
+    }
+
+    return true;
+}
+
+void wss::detail::peer::flush_compressed_block()
+{
+    std::size_t size = _compress_input.size();
+
+    if (_block_compressor->compress(_compress_input.data(), size, _compress_output))
+    {
+        std::array<std::uint8_t, detail::websocket_protocol::MAX_HEADER_SIZE> ws_header;
+
+        auto ws_header_size = detail::websocket_protocol::generate_header(
+            ws_header.data(),
+            detail::websocket_protocol::opcodes::BINARY,
+            detail::websocket_protocol::flags::FIN | detail::websocket_protocol::flags::RSV2,
+            _compress_output.size());
+
+        transmit(
+            boost::beast::buffers_cat(
+                boost::asio::buffer(ws_header.data(), ws_header_size),
+                boost::asio::buffer(_compress_output)),
+            ws_header_size + _compress_output.size(),
+            false);
+    }
+
+    else
+        transmit(boost::asio::buffer(_compress_input), size, false);
+
+    _compress_input.clear();
+}
+
+void wss::detail::peer::flush_aggregate()
+{
+    _aggregate_table.resize(
+        detail::streaming_protocol::aggregate_table_size(_aggregate_entries.size()));
+
+    if (_use_tcp_protocol)
+        detail::streaming_protocol::generate_aggregate_table<detail::raw_framing::byte_order>(
+            _aggregate_table.data(),
+            _aggregate_entries.data(),
+            _aggregate_entries.size());
+    else
+        detail::streaming_protocol::generate_aggregate_table<detail::websocket_framing::byte_order>(
+            _aggregate_table.data(),
+            _aggregate_entries.data(),
+            _aggregate_entries.size());
+
+    std::array<boost::asio::const_buffer, 2> buffers =
+    {
+        boost::asio::buffer(_aggregate_table),
+        boost::asio::buffer(_aggregate_data),
+    };
+
+    // Clear the pending entries before sending, since send_packet() flushes any that remain.
+    std::size_t size = _aggregate_table.size() + _aggregate_data.size();
+    _aggregate_entries.clear();
+
+    send_packet(
+        0,
+        detail::streaming_protocol::packet_type::AGGREGATE,
+        buffers,
+        size);
+
+    _aggregate_data.clear();
+}
+
 void wss::detail::peer::send_metadata(
     unsigned signo,
     const std::string& method,
     const nlohmann::json& params)
 {
-    std::uint32_t encoding = detail::streaming_protocol::metadata_encoding::MSGPACK;
+    std::array<std::uint8_t, sizeof(std::uint32_t)> encoding;
+
+    if (_use_tcp_protocol)
+        boost::endian::endian_store<std::uint32_t, sizeof(std::uint32_t), detail::raw_framing::byte_order>(
+            encoding.data(),
+            detail::streaming_protocol::metadata_encoding::MSGPACK);
+    else
+        boost::endian::endian_store<std::uint32_t, sizeof(std::uint32_t), detail::websocket_framing::byte_order>(
+            encoding.data(),
+            detail::streaming_protocol::metadata_encoding::MSGPACK);
 
     auto payload = nlohmann::json::to_msgpack({
         {"method", method},
@@ -88,7 +367,7 @@ void wss::detail::peer::send_metadata(
 
     std::array<boost::asio::const_buffer, 2> buffers =
     {
-        boost::asio::buffer(&encoding, sizeof(encoding)),
+        boost::asio::buffer(encoding),
         boost::asio::buffer(payload),
     };
 
@@ -96,7 +375,7 @@ void wss::detail::peer::send_metadata(
         signo,
         detail::streaming_protocol::packet_type::METADATA,
         buffers,
-        sizeof(encoding) + payload.size());
+        encoding.size() + payload.size());
 }
 
 void wss::detail::peer::set_send_buffer_size(std::size_t size)
@@ -123,12 +402,32 @@ void wss::detail::peer::do_wait_rx()
 
 void wss::detail::peer::do_wait_tx()
 {
-    _socket.async_wait(
-        boost::asio::socket_base::wait_write,
-        std::bind(
-            &peer::finish_wait_tx,
-            shared_from_this(),
-            _1));
+    // If the shared memory ring is full, ask the remote peer to ring the doorbell once it has
+    // consumed some data. If it already has, try again right away.
+    if (_tx_ring_active)
+    {
+        if (_tx_ring->prepare_wait_for_space())
+            _tx_ring_waiting = true;
+
+        else if (_tx_ring->corrupt())
+            return abandon_shared_memory();
+
+        else
+            boost::asio::post(
+                _socket.get_executor(),
+                std::bind(
+                    &peer::finish_wait_tx,
+                    shared_from_this(),
+                    boost::system::error_code{}));
+    }
+
+    else
+        _socket.async_wait(
+            boost::asio::socket_base::wait_write,
+            std::bind(
+                &peer::finish_wait_tx,
+                shared_from_this(),
+                _1));
 
     _waiting_tx = true;
 }
@@ -141,6 +440,9 @@ void wss::detail::peer::finish_wait_rx(const boost::system::error_code& wait_ec)
     if (wait_ec)
         return close(wait_ec);
 
+    if (_rx_ring_active)
+        return finish_wait_rx_ring();
+
     // Since the socket is readable, read as much as we can from it.
     std::size_t bytes_received = _socket.receive(
         boost::asio::buffer(
@@ -161,32 +463,90 @@ void wss::detail::peer::finish_wait_rx(const boost::system::error_code& wait_ec)
     process_buffer();
 }
 
+void wss::detail::peer::finish_wait_rx_ring()
+{
+    boost::system::error_code receive_ec;
+
+    // Once the byte stream has been moved into the shared memory ring, the remote peer only
+    // writes doorbells to the socket, which we can discard. A doorbell means that the remote
+    // peer has written to our receive ring or consumed data from our transmit ring.
+    std::size_t bytes_received = _socket.receive(
+        boost::asio::buffer(_rx_buffer),
+        0,
+        receive_ec);
+
+    bool is_eof = bytes_received == 0 && receive_ec != boost::asio::error::would_block;
+
+    if (receive_ec
+            && receive_ec != boost::asio::error::would_block
+            && receive_ec != boost::asio::error::eof)
+        return close(receive_ec);
+
+    // Process everything the remote peer has written, even if it has since closed the socket.
+    process_rx_ring();
+
+    if (_is_closed)
+        return;
+
+    if (is_eof)
+        return close({});
+
+    do_wait_rx();
+}
+
 void wss::detail::peer::finish_wait_tx(const boost::system::error_code& wait_ec)
 {
     boost::system::error_code send_ec;
+    std::size_t bytes_sent = 0;
     _waiting_tx = false;
 
     // Was there an error waiting for the socket to become writeable?
     if (wait_ec)
         return close(wait_ec);
 
-    // Since the socket is writeable, write as much as we can to it.
-    std::size_t bytes_sent = _socket.send(
-        boost::asio::buffer(_tx_buffer.data(), _tx_buffer_bytes),
-        0,
-        send_ec);
+    // Gather buffered data. If we are about to switch to the shared memory ring, only data
+    // preceding the switch goes to the socket.
+    tx_gather_array buffers;
+    std::size_t buffer_count = gather_tx(
+        buffers,
+        _switch_after ? _switch_after : _tx_queue_bytes);
+    detail::const_buffer_span pending{buffers.data(), buffer_count};
 
-    // Was there a genuine error writing to the socket?
-    if (send_ec && send_ec != boost::asio::error::would_block)
-        return close(send_ec);
+    if (_tx_ring_active)
+    {
+        if (!_socket.is_open())
+            return close(boost::asio::error::operation_aborted);
 
-    // If we sent all the data in our buffer, we can stop now.
-    if (bytes_sent)
-        std::memmove(
-            _tx_buffer.data(),
-            &_tx_buffer[bytes_sent],
-            _tx_buffer_bytes - bytes_sent);
-    _tx_buffer_bytes -= bytes_sent;
+        // Copy as much buffered data as will fit into the shared memory ring.
+        bool must_wake;
+        std::tie(bytes_sent, must_wake) = _tx_ring->write(pending);
+
+        if (must_wake)
+            ring_doorbell();
+
+        if (_tx_ring->corrupt())
+            return abandon_shared_memory();
+    }
+
+    else
+    {
+        // Since the socket is writeable, write as much as we can to it.
+        bytes_sent = _socket.send(pending, 0, send_ec);
+
+        // Was there a genuine error writing to the socket?
+        if (send_ec && send_ec != boost::asio::error::would_block)
+            return close(send_ec);
+    }
+
+    // Remove the sent data from our queue, releasing references to any fully sent buffers.
+    consume_tx(bytes_sent);
+
+    if (_switch_after)
+    {
+        _switch_after -= std::min(bytes_sent, _switch_after);
+        if (_switch_after == 0)
+            _tx_ring_active = true;
+    }
 
     if (_shutdown_after)
     {
@@ -195,40 +555,124 @@ void wss::detail::peer::finish_wait_tx(const boost::system::error_code& wait_ec)
             return close();
     }
 
-    if (bytes_sent < _tx_buffer_bytes)
+    // If there is still data in our queue, wait until we can send more.
+    if (_tx_queue_bytes)
         do_wait_tx();
 }
 
-void wss::detail::peer::process_buffer()
+std::size_t wss::detail::peer::gather_tx(
+    tx_gather_array& buffers,
+    std::size_t limit) const noexcept
 {
-    if (_use_tcp_protocol)
-        process_buffer_tcp();
+    std::size_t count = 0;
+    std::size_t copied_offset = 0;
+
+    for (const auto& segment : _tx_queue)
+    {
+        if (count == buffers.size() || !limit)
+            break;
+
+        const std::uint8_t *data = segment.data;
+        if (!segment.owner)
+        {
+            data = _tx_buffer.data() + copied_offset;
+            copied_offset += segment.size;
+        }
+
+        std::size_t size = std::min(segment.size, limit);
+        buffers[count++] = boost::asio::const_buffer{data, size};
+        limit -= size;
+    }
+
+    return count;
+}
+
+void wss::detail::peer::consume_tx(std::size_t size) noexcept
+{
+    std::size_t copied_bytes = 0;
+    _tx_queue_bytes -= size;
+
+    while (size)
+    {
+        auto& segment = _tx_queue.front();
+        std::size_t n = std::min(segment.size, size);
+
+        if (segment.owner)
+            segment.data += n;
+        else
+            copied_bytes += n;
+
+        segment.size -= n;
+        size -= n;
+
+        if (!segment.size)
+            _tx_queue.pop_front();
+    }
+
+    if (copied_bytes)
+    {
+        std::memmove(
+            _tx_buffer.data(),
+            &_tx_buffer[copied_bytes],
+            _tx_buffer_bytes - copied_bytes);
+        _tx_buffer_bytes -= copied_bytes;
+    }
+}
+
+void wss::detail::peer::queue_copy(const void *data, std::size_t size) noexcept
+{
+    std::memcpy(_tx_buffer.data() + _tx_buffer_bytes, data, size);
+    _tx_buffer_bytes += size;
+    _tx_queue_bytes += size;
+
+    if (!_tx_queue.empty() && !_tx_queue.back().owner)
+        _tx_queue.back().size += size;
     else
-        process_buffer_ws();
+        _tx_queue.push_back({ nullptr, nullptr, size });
 }
 
+void wss::detail::peer::queue_reference(
+    const std::shared_ptr<const void>& owner,
+    const void *data,
+    std::size_t size)
+{
+    _tx_queue.push_back({ owner, static_cast<const std::uint8_t *>(data), size });
+    _tx_queue_bytes += size;
+}
 
-void wss::detail::peer::process_buffer_tcp()
+void wss::detail::peer::process_buffer()
 {
-    // Process as many streaming protocol packets as possible.
-    while (true)
+    boost::system::error_code process_ec;
+    std::size_t bytes_consumed = process_stream(
+        _rx_buffer.data(),
+        _rx_buffer_bytes,
+        process_ec);
+
+    if (process_ec)
+        return close(process_ec);
+
+    // If the remote peer has switched to the shared memory ring, anything it wrote to the socket
+    // after the switch notification is a wake-up notification, which we can discard.
+    if (_rx_switch_pending)
     {
-        std::size_t bytes_consumed = process_packet(
-            _rx_buffer.data(),
-            _rx_buffer_bytes);
+        _rx_switch_pending = false;
+        _rx_ring_active = true;
+        _rx_buffer_bytes = 0;
 
-        // If there's not enough data to form a complete packet, we can't process any more.
-        if (!bytes_consumed)
-            break;
+        process_rx_ring();
+        if (!_is_closed)
+            do_wait_rx();
+        return;
+    }
 
-        // Consume the handled frame by sliding the remaining data in the read buffer over
-        // to the left. (Can't use std::memcpy() for this because the ranges overlap.)
+    // Consume the handled data by sliding the remaining data in the read buffer over to the
+    // left. (Can't use std::memcpy() for this because the ranges overlap.)
+    if (bytes_consumed)
         std::memmove(
             &_rx_buffer[0],
             &_rx_buffer[bytes_consumed],
             _rx_buffer_bytes - bytes_consumed);
-        _rx_buffer_bytes -= bytes_consumed;
-    }
+    _rx_buffer_bytes -= bytes_consumed;
 
     // If the read buffer is still full after processing, it is an error condition
     // (the client must be sending a frame larger than our fixed-size read buffer).
@@ -238,45 +682,114 @@ void wss::detail::peer::process_buffer_tcp()
     do_wait_rx();
 }
 
-void wss::detail::peer::process_buffer_ws()
+void wss::detail::peer::process_rx_ring()
 {
-    // Process as many WebSocket frames as possible.
     while (true)
     {
-        // Try to decode the WebSocket header.
-        auto header = detail::websocket_protocol::decode_header(
-            _rx_buffer.data(),
-            _rx_buffer_bytes);
+        // Process packets in place in the shared memory ring. At most a receive buffer's worth
+        // of data is processed at a time, so that frames larger than our receive buffer are
+        // rejected just as they would be if they arrived through the socket.
+        auto [data, size] = _rx_ring->readable();
 
-        // If there's not enough data to form a complete frame, we can't process any more.
-        if (!header.header_size)
-            break;
+        if (_rx_ring->corrupt())
+            return abandon_shared_memory();
+
+        std::size_t window = std::min(size, _rx_buffer.size());
 
         boost::system::error_code process_ec;
-        process_websocket_frame(
-            header,
-            _rx_buffer.data() + header.header_size,
-            header.payload_size,
-            process_ec);
+        std::size_t bytes_consumed = process_stream(data, window, process_ec);
 
         if (process_ec)
             return close(process_ec);
 
-        // Consume the handled frame by sliding the remaining data in the read buffer over
-        // to the left. (Can't use std::memcpy() for this because the ranges overlap.)
-        std::memmove(
-            &_rx_buffer[0],
-            &_rx_buffer[header.header_size + header.payload_size],
-            _rx_buffer_bytes - header.header_size + header.payload_size);
-        _rx_buffer_bytes -= header.header_size + header.payload_size;
+        if (_is_closed)
+            return;
+
+        if (_rx_ring->consume(bytes_consumed))
+            wake_ring_writer();
+
+        // If a receive buffer's worth of data, or the whole ring, does not contain a complete
+        // frame, the remote peer is sending a frame larger than we are willing to process.
+        if (!bytes_consumed && (window == _rx_buffer.size() || size == _rx_ring->capacity()))
+            return close(boost::asio::error::no_buffer_space);
+
+        // Sleep until the remote peer writes more data, unless it already has.
+        if (_rx_ring->prepare_wait())
+            break;
     }
 
-    // If the read buffer is still full after processing, it is an error condition
-    // (the client must be sending a frame larger than our fixed-size read buffer).
-    if (_rx_buffer_bytes == _rx_buffer.size())
-        return close(boost::asio::error::no_buffer_space);
+    // The doorbell that woke us may also have announced space in our own transmit ring.
+    resume_tx_ring();
+}
 
-    do_wait_rx();
+std::size_t wss::detail::peer::process_stream(
+    std::uint8_t *data,
+    std::size_t size,
+    boost::system::error_code& ec)
+{
+    // Select the protocol variant once per buffer, so that the per-packet loops below are
+    // specialized at compile time.
+    if (_use_tcp_protocol)
+        return process_stream<detail::raw_framing>(data, size, ec);
+    else
+        return process_stream<detail::websocket_framing>(data, size, ec);
+}
+
+template <typename Framing>
+std::size_t wss::detail::peer::process_stream(
+    std::uint8_t *data,
+    std::size_t size,
+    boost::system::error_code& ec)
+{
+    std::array<detail::streaming_protocol::packet_descriptor, 256> descriptors;
+    std::size_t total_consumed = 0;
+
+    while (!_rx_switch_pending)
+    {
+        // Locate as many packets as possible in a single pass, then dispatch them.
+        auto scan = Framing::scan_packets(
+            data + total_consumed,
+            size - total_consumed,
+            descriptors.data(),
+            descriptors.size());
+
+        for (std::size_t i = 0; i < scan.packet_count; ++i)
+            dispatch_packet<Framing>(descriptors[i], data + total_consumed);
+
+        total_consumed += scan.bytes_scanned;
+
+        if (scan.packet_count)
+            continue;
+
+        // The scan stops at anything other than a simple packet. For WebSocket framing, this
+        // may be a control frame or a masked frame, which we process individually.
+        if constexpr (Framing::is_websocket)
+        {
+            auto header = detail::websocket_protocol::decode_header(
+                data + total_consumed,
+                size - total_consumed);
+
+            // If there's not enough data to form a complete frame, we can't process any more.
+            if (!header.header_size)
+                break;
+
+            process_websocket_frame(
+                header,
+                data + total_consumed + header.header_size,
+                header.payload_size,
+                ec);
+
+            if (ec)
+                break;
+
+            total_consumed += header.header_size + header.payload_size;
+        }
+
+        else
+            break;
+    }
+
+    return total_consumed;
 }
 
 void wss::detail::peer::process_websocket_frame(
@@ -295,6 +808,49 @@ void wss::detail::peer::process_websocket_frame(
         for (std::size_t i = 0; i < size; ++i)
             data[i] ^= header.masking_key[i % 4];
 
+    // A frame with the RSV2 bit set carries a compressed block of frames, which we process as
+    // if they had been received directly. Blocks never contain further compressed blocks.
+    if (header.flags & detail::websocket_protocol::flags::RSV2)
+    {
+        if (!_block_compressor
+                || _is_decompressing
+                || header.opcode != detail::websocket_protocol::opcodes::BINARY
+                || !detail::block_compressor::decompress(data, size, _decompressed))
+        {
+            ec = boost::asio::error::invalid_argument;
+            return;
+        }
+
+        _is_decompressing = true;
+        std::size_t consumed = process_stream<detail::websocket_framing>(
+            _decompressed.data(),
+            _decompressed.size(),
+            ec);
+        _is_decompressing = false;
+
+        if (!ec && consumed != _decompressed.size())
+            ec = boost::asio::error::invalid_argument;
+
+        return;
+    }
+
+    // A message with the RSV1 bit set was compressed with per-message deflate. We process it
+    // decompressed, as if it had been received that way.
+    if (header.flags & detail::websocket_protocol::flags::RSV1)
+    {
+        if (!_inflate_enabled
+                || (header.opcode != detail::websocket_protocol::opcodes::BINARY
+                    && header.opcode != detail::websocket_protocol::opcodes::TEXT)
+                || !inflate_message(data, size))
+        {
+            ec = boost::asio::error::invalid_argument;
+            return;
+        }
+
+        data = _inflated.data();
+        size = _inflated.size();
+    }
+
     // We have a valid and complete WebSocket frame.
     switch (header.opcode)
     {
@@ -323,7 +879,7 @@ void wss::detail::peer::process_websocket_frame(
 
         case detail::websocket_protocol::opcodes::BINARY:
         {
-            process_packet(data, size);
+            process_packet<detail::websocket_framing>(data, size);
             break;
         }
 
@@ -333,36 +889,62 @@ void wss::detail::peer::process_websocket_frame(
     }
 }
 
+template <typename Framing>
 std::size_t wss::detail::peer::process_packet(
     const std::uint8_t *data,
     std::size_t size)
 {
     // Try to decode the WebSocket Streaming Protocol packet.
-    auto header = detail::streaming_protocol::decode_header(data, size, _use_tcp_protocol);
+    auto header = detail::streaming_protocol::decode_header<Framing::byte_order>(data, size);
     if (!header.header_size)
         return 0;
 
-    switch (header.type)
+    dispatch_packet<Framing>(
+        {
+            header.signo,
+            header.type,
+            header.header_size,
+            header.payload_size
+        },
+        data);
+
+    return header.header_size + header.payload_size;
+}
+
+template <typename Framing>
+void wss::detail::peer::dispatch_packet(
+    const detail::streaming_protocol::packet_descriptor& packet,
+    const std::uint8_t *data)
+{
+    switch (packet.type)
     {
         case detail::streaming_protocol::packet_type::DATA:
             process_data_packet(
-                header.signo,
-                data + header.header_size,
-                header.payload_size);
+                packet.signo,
+                data + packet.offset,
+                packet.payload_size);
+            break;
+
+        case detail::streaming_protocol::packet_type::AGGREGATE:
+            detail::streaming_protocol::split_aggregate<Framing::byte_order>(
+                data + packet.offset,
+                packet.payload_size,
+                [this](unsigned signo, const std::uint8_t *data, std::size_t size)
+                {
+                    process_data_packet(signo, data, size);
+                });
             break;
 
         case detail::streaming_protocol::packet_type::METADATA:
-            process_metadata_packet(
-                header.signo,
-                data + header.header_size,
-                header.payload_size);
+            process_metadata_packet<Framing>(
+                packet.signo,
+                data + packet.offset,
+                packet.payload_size);
             break;
 
         default:
             break;
     }
-
-    return header.header_size + header.payload_size;
 }
 
 void wss::detail::peer::process_data_packet(
@@ -373,6 +955,7 @@ void wss::detail::peer::process_data_packet(
     on_data_received(signo, data, size);
 }
 
+template <typename Framing>
 void wss::detail::peer::process_metadata_packet(
     unsigned signo,
     const std::uint8_t *data,
@@ -381,10 +964,10 @@ void wss::detail::peer::process_metadata_packet(
     if (size < sizeof(std::uint32_t))
         return;
 
-    std::uint32_t encoding =
-        _use_tcp_protocol
-            ? (data[3] | (data[2] << 8) | (data[1] << 16) | (data[0] << 24))
-            : (data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+    std::uint32_t encoding = boost::endian::endian_load<
+        std::uint32_t,
+        sizeof(std::uint32_t),
+        Framing::byte_order>(data);
 
     nlohmann::json metadata;
 
@@ -416,12 +999,158 @@ void wss::detail::peer::process_metadata_packet(
     if (metadata.is_object()
             && metadata.contains("method")
             && metadata["method"].is_string())
+    {
+        if (signo == 0
+                && handle_shared_memory_metadata(
+                    metadata["method"],
+                    metadata.contains("params")
+                        ? metadata["params"]
+                        : nlohmann::json{nullptr}))
+            return;
+
         on_metadata_received(
             signo,
             metadata["method"],
             metadata.contains("params")
                 ? metadata["params"]
                 : nlohmann::json{nullptr});
+    }
+}
+
+bool wss::detail::peer::handle_shared_memory_metadata(
+    const std::string& method,
+    const nlohmann::json& params)
+{
+    if (!params.is_object())
+        return false;
+
+    if (method == "sharedMemoryOffer")
+        handle_shared_memory_offer(params);
+    else if (method == "sharedMemoryAccept")
+        handle_shared_memory_accept(params);
+    else if (method == "sharedMemoryReject")
+        handle_shared_memory_reject(params);
+    else if (method == "sharedMemorySwitch")
+        handle_shared_memory_switch(params);
+    else if (method == "sharedMemoryWake")
+        handle_shared_memory_wake(params);
+    else
+        return false;
+
+    return true;
+}
+
+void wss::detail::peer::handle_shared_memory_offer(const nlohmann::json& params)
+{
+    if (!_shared_memory_enabled || !detail::is_same_host(_socket))
+        return;
+
+    if (_rx_ring || !params.contains("name") || !params["name"].is_string()
+            || !params.contains("cookie") || !params["cookie"].is_number_unsigned())
+        return;
+
+    const std::string& name = params["name"];
+
+    try
+    {
+        _rx_ring = std::make_unique<detail::shared_memory_ring>(
+            name,
+            params["cookie"].get<std::uint64_t>());
+    }
+
+    catch (const boost::system::system_error&)
+    {
+        send_metadata(0, "sharedMemoryReject", { { "name", name } });
+        return;
+    }
+
+    send_metadata(0, "sharedMemoryAccept", { { "name", name } });
+}
+
+void wss::detail::peer::handle_shared_memory_accept(const nlohmann::json& params)
+{
+    if (!_tx_ring || _tx_ring_active || _switch_after
+            || !params.contains("name") || params["name"] != _tx_ring->name())
+        return;
+
+    // The remote peer has opened the segment, so nobody else needs to find it by name.
+    _tx_ring->unlink();
+
+    // Tell the remote peer that everything following this packet is written to the ring. If
+    // the packet could not be sent synchronously, switch once it has been flushed.
+    send_metadata(0, "sharedMemorySwitch", { { "name", _tx_ring->name() } });
+
+    if (_waiting_tx)
+        _switch_after = _tx_queue_bytes;
+    else if (!_is_closed)
+        _tx_ring_active = true;
+}
+
+void wss::detail::peer::handle_shared_memory_reject(const nlohmann::json& params)
+{
+    if (!_tx_ring || _tx_ring_active || _switch_after
+            || !params.contains("name") || params["name"] != _tx_ring->name())
+        return;
+
+    _tx_ring.reset();
+}
+
+void wss::detail::peer::handle_shared_memory_switch(const nlohmann::json& params)
+{
+    if (!_rx_ring || _rx_ring_active
+            || !params.contains("name") || params["name"] != _rx_ring->name())
+        return close(boost::asio::error::invalid_argument);
+
+    _rx_switch_pending = true;
+}
+
+void wss::detail::peer::ring_doorbell()
+{
+    // Wake the remote peer by writing a single byte to the socket. If the socket's buffer is
+    // full, the remote peer has unread notifications pending anyway.
+    std::uint8_t doorbell = 0;
+    boost::system::error_code send_ec;
+    _socket.send(boost::asio::buffer(&doorbell, sizeof(doorbell)), 0, send_ec);
+}
+
+void wss::detail::peer::handle_shared_memory_wake(const nlohmann::json& params)
+{
+    if (!_tx_ring || !params.contains("name") || params["name"] != _tx_ring->name())
+        return;
+
+    resume_tx_ring();
+}
+
+void wss::detail::peer::wake_ring_writer()
+{
+    // The remote peer is waiting for space in our receive ring. If our own byte stream has been
+    // moved into a ring, the remote peer treats anything arriving on the socket as a doorbell.
+    // Otherwise, the socket still carries packets, so the wake-up must be sent as metadata.
+    if (_tx_ring_active)
+        ring_doorbell();
+    else
+        send_metadata(0, "sharedMemoryWake", { { "name", _rx_ring->name() } });
+}
+
+void wss::detail::peer::resume_tx_ring()
+{
+    if (!_tx_ring_waiting)
+        return;
+
+    _tx_ring_waiting = false;
+    finish_wait_tx({});
+}
+
+void wss::detail::peer::abandon_shared_memory()
+{
+    // The remote peer has stored inconsistent indices in a shared memory ring, so nothing it
+    // writes can be trusted any longer. The rings themselves stay mapped until destruction,
+    // because packets in the receive ring may still be referenced further up the call stack.
+    _tx_ring_active = false;
+    _rx_ring_active = false;
+    _tx_ring_waiting = false;
+
+    close(boost::asio::error::invalid_argument);
 }
 
 void wss::detail::peer::close(
@@ -435,6 +1164,14 @@ void wss::detail::peer::close(
     boost::system::error_code close_ec;
     _socket.shutdown(_socket.shutdown_both, close_ec);
     _socket.close(close_ec);
+    _tx_ring_waiting = false;
+    _batch_depth = 0;
+    _aggregate_entries.clear();
+    _aggregate_data.clear();
+    _compress_input.clear();
+
+    // Release references to buffers that will now never be sent.
+    _tx_queue.clear();
 
     on_closed(ec);
 }
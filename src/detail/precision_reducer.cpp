@@ -0,0 +1,157 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <boost/endian/conversion.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/endianness.hpp>
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/sample_converter.hpp>
+#include <ws-streaming/transport_formats.hpp>
+#include <ws-streaming/detail/half_float.hpp>
+#include <ws-streaming/detail/precision_reducer.hpp>
+
+// The largest quantized magnitude. The scaledInt16 format uses the symmetric range
+// [-QUANTIZED_MAX, QUANTIZED_MAX], so that the midpoint of the signal's range is exact.
+static constexpr double QUANTIZED_MAX = 32767;
+
+// The loops below have no branches in their bodies (the conditional expressions compile to
+// selects), so that the compiler is free to vectorize them.
+static void floats_to_halves(
+    const float *values,
+    std::size_t count,
+    std::uint16_t *output) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i)
+        output[i] = wss::detail::float_to_half(values[i]);
+}
+
+static void quantize(
+    const double *values,
+    std::size_t count,
+    double low,
+    double inverse_scale,
+    std::int16_t *output) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        // A non-negative level is rounded by adding one half and truncating. NaNs fail the
+        // first comparison and become the lowest level.
+        double level = (values[i] - low) * inverse_scale + 0.5;
+        level = level > 0 ? level : 0;
+        level = level < 2 * QUANTIZED_MAX ? level : 2 * QUANTIZED_MAX;
+        output[i] = static_cast<std::int16_t>(
+            static_cast<std::int32_t>(level) - static_cast<std::int32_t>(QUANTIZED_MAX));
+    }
+}
+
+wss::detail::precision_reducer::precision_reducer() noexcept
+{
+}
+
+wss::detail::precision_reducer::precision_reducer(
+        const metadata& source,
+        const std::string& format)
+    : _converter(source)
+{
+    if (!_converter.valid())
+        return;
+
+    nlohmann::json json = source.json();
+    auto& definition = json["definition"];
+    definition.erase("postScaling");
+    definition.erase("encoding");
+    definition["endian"] = boost::endian::order::native == boost::endian::order::little
+        ? endianness::little
+        : endianness::big;
+
+    if (format == transport_formats::real32)
+    {
+        _format = format_type::real32;
+        definition["dataType"] = data_types::real32_t;
+    }
+
+    else if (format == transport_formats::real16)
+    {
+        _format = format_type::real16;
+        definition["dataType"] = data_types::real16_t;
+    }
+
+    else if (auto range = source.range(); format == transport_formats::scaled_int16
+        && range && range->second > range->first)
+    {
+        double scale = (range->second - range->first) / (2 * QUANTIZED_MAX);
+
+        _format = format_type::scaled_int16;
+        _low = range->first;
+        _inverse_scale = 1 / scale;
+
+        definition["dataType"] = data_types::int16_t;
+        definition["postScaling"] = {
+            { "scale", scale },
+            { "offset", range->first + QUANTIZED_MAX * scale },
+        };
+    }
+
+    else
+        return;
+
+    _metadata = json;
+}
+
+bool wss::detail::precision_reducer::valid() const noexcept
+{
+    return _format != format_type::none;
+}
+
+std::size_t wss::detail::precision_reducer::source_sample_size() const noexcept
+{
+    return _converter.sample_size();
+}
+
+std::size_t wss::detail::precision_reducer::sample_size() const noexcept
+{
+    switch (_format)
+    {
+        case format_type::real32: return sizeof(float);
+        case format_type::real16: return sizeof(std::uint16_t);
+        case format_type::scaled_int16: return sizeof(std::int16_t);
+        default: return 0;
+    }
+}
+
+const wss::metadata& wss::detail::precision_reducer::reduced_metadata() const noexcept
+{
+    return _metadata;
+}
+
+bool wss::detail::precision_reducer::reduce(
+    const void *data,
+    std::size_t sample_count,
+    void *output)
+{
+    switch (_format)
+    {
+        case format_type::real32:
+            _converter.convert(data, sample_count, static_cast<float *>(output));
+            return true;
+
+        case format_type::real16:
+            _floats.resize(sample_count);
+            _converter.convert(data, sample_count, _floats.data());
+            floats_to_halves(_floats.data(), sample_count, static_cast<std::uint16_t *>(output));
+            return true;
+
+        case format_type::scaled_int16:
+            _values.resize(sample_count);
+            _converter.convert(data, sample_count, _values.data());
+            quantize(_values.data(), sample_count, _low, _inverse_scale, static_cast<std::int16_t *>(output));
+            return true;
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,160 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <boost/asio/buffer.hpp>
+
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/detail/const_buffer_span.hpp>
+#include <ws-streaming/detail/precision_reducer.hpp>
+#include <ws-streaming/detail/reduced_signal.hpp>
+
+using namespace std::placeholders;
+
+// Reduced signals currently held by any connection, by reduced signal ID. The ID is used rather
+// than the source's address, which may be reused by another signal once the source is
+// destroyed. Connections may run on different threads, so the registry is guarded by a mutex.
+static std::mutex registry_mutex;
+static std::map<
+    std::string,
+    std::weak_ptr<wss::detail::reduced_signal>
+> registry;
+
+wss::detail::reduced_signal::reduced_signal(
+        local_signal& source,
+        const std::string& format)
+    : _source(source)
+    , _format(format)
+    , _reducer(source.metadata(), format)
+    , _signal(make_id(source.id(), format), _reducer.reduced_metadata())
+{
+    _signal.set_domain_tolerance(source.domain_tolerance());
+
+    _on_subscribed = _signal.on_subscribed.connect(
+        std::bind(&reduced_signal::on_subscribed, this));
+    _on_unsubscribed = _signal.on_unsubscribed.connect(
+        std::bind(&reduced_signal::on_unsubscribed, this));
+}
+
+std::shared_ptr<wss::detail::reduced_signal> wss::detail::reduced_signal::get(
+    local_signal& source,
+    const std::string& format)
+{
+    std::lock_guard lock{registry_mutex};
+
+    for (auto it = registry.begin(); it != registry.end(); )
+        if (it->second.expired())
+            it = registry.erase(it);
+        else
+            ++it;
+
+    // A live entry is only shared if it was derived from this very source, and not from another
+    // signal with the same ID; otherwise it is replaced, and its holders keep their own.
+    auto id = make_id(source.id(), format);
+    auto& entry = registry[id];
+    if (auto signal = entry.lock(); signal && &signal->source() == &source)
+        return signal;
+
+    if (!precision_reducer{source.metadata(), format}.valid())
+    {
+        registry.erase(id);
+        return nullptr;
+    }
+
+    auto signal = std::make_shared<reduced_signal>(source, format);
+    entry = signal;
+    return signal;
+}
+
+std::string wss::detail::reduced_signal::make_id(
+    const std::string& source_id,
+    const std::string& format)
+{
+    return source_id + "/Reduced/" + format;
+}
+
+wss::local_signal& wss::detail::reduced_signal::signal() noexcept
+{
+    return _signal;
+}
+
+wss::local_signal& wss::detail::reduced_signal::source() noexcept
+{
+    return _source;
+}
+
+void wss::detail::reduced_signal::on_subscribed()
+{
+    // The source's metadata may have changed while we were not observing it.
+    on_source_metadata_changed();
+
+    _source_holder = _source.increment_subscribe_count();
+
+    _on_source_metadata_changed = _source.on_metadata_changed.connect(
+        std::bind(&reduced_signal::on_source_metadata_changed, this));
+    _on_source_data_published = _source.on_data_published.connect(
+        std::bind(&reduced_signal::on_source_data_published, this, _1, _2, _3, _4, _5));
+}
+
+void wss::detail::reduced_signal::on_unsubscribed()
+{
+    _on_source_data_published.disconnect();
+    _on_source_metadata_changed.disconnect();
+    _source_holder.close();
+}
+
+void wss::detail::reduced_signal::on_source_metadata_changed()
+{
+    // If the source can no longer be converted, the last valid metadata is kept, and data is
+    // dropped until the source becomes convertible again.
+    _reducer = precision_reducer{_source.metadata(), _format};
+
+    if (_reducer.valid())
+        _signal.set_metadata(_reducer.reduced_metadata());
+}
+
+void wss::detail::reduced_signal::on_source_data_published(
+    std::int64_t domain_value,
+    std::size_t sample_count,
+    const boost::asio::const_buffer *buffers,
+    std::size_t buffer_count,
+    const std::shared_ptr<const void>&)
+{
+    if (!_reducer.valid())
+        return;
+
+    const void *data = buffer_count == 1 ? buffers[0].data() : nullptr;
+    std::size_t size = boost::asio::buffer_size(const_buffer_span{buffers, buffer_count});
+
+    // The reducer requires contiguous input.
+    if (buffer_count != 1)
+    {
+        _data.resize(size);
+        boost::asio::buffer_copy(
+            boost::asio::buffer(_data),
+            const_buffer_span{buffers, buffer_count});
+        data = _data.data();
+    }
+
+    std::size_t count = size / _reducer.source_sample_size();
+    if (sample_count && sample_count < count)
+        count = sample_count;
+
+    if (!count)
+        return;
+
+    // Convert directly into transmit memory, which connections reference instead of copying.
+    auto reservation = _signal.reserve(count * _reducer.sample_size());
+    _reducer.reduce(data, count, reservation.data());
+
+    // Data published without a domain value is republished without one.
+    _signal.commit(
+        domain_value,
+        sample_count ? count : 0,
+        reservation,
+        count * _reducer.sample_size());
+}
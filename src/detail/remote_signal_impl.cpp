@@ -1,13 +1,15 @@
 #include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
 
 #include <boost/endian/conversion.hpp>
-#include <boost/multiprecision/cpp_int.hpp>
 
 #include <nlohmann/json.hpp>
 
 #include <ws-streaming/data_types.hpp>
 #include <ws-streaming/endianness.hpp>
+#include <ws-streaming/fixed_point_time.hpp>
 #include <ws-streaming/metadata_builder.hpp>
 #include <ws-streaming/remote_signal.hpp>
 #include <ws-streaming/rule_types.hpp>
@@ -44,9 +46,25 @@ void wss::detail::remote_signal_impl::handle_data(
     if (!_is_subscribed)
         return;
 
+    // The data of signals declaring a payload encoding is decoded before it is interpreted;
+    // malformed packets are dropped.
+    if (_codec.enabled())
+    {
+        if (!_codec.decode(data, size, _decoded))
+            return;
+
+        data = _decoded.data();
+        size = _decoded.size();
+    }
+
     std::int64_t domain_value = 0;
     std::int64_t sample_count = 0;
 
+    linear_table *domain_table
+        = _domain_table && *_domain_table
+            ? &**_domain_table
+            : nullptr;
+
     if (_tcp_delta)
     {
         if (_sample_size)
@@ -54,6 +72,7 @@ void wss::detail::remote_signal_impl::handle_data(
 
         domain_value = _tcp_time;
         _tcp_time += _tcp_delta * sample_count;
+        _domain_delta = _tcp_delta;
     }
 
     else if (_table)
@@ -69,11 +88,13 @@ void wss::detail::remote_signal_impl::handle_data(
         else if (_metadata.data_type() == data_types::binary_t)
             sample_count = 1;
 
-        auto domain_table = _domain_table.lock();
         if (domain_table)
             domain_value = domain_table->value_at(_value_index);
 
         _value_index += sample_count;
+        _domain_delta = domain_table
+            ? std::optional<std::int64_t>{domain_table->delta()}
+            : std::nullopt;
 
         if (domain_table)
             domain_table->drive_to(_value_index);
@@ -87,8 +108,12 @@ void wss::detail::remote_signal_impl::handle_data(
             size = _sample_size;
         }
 
-        if (auto domain_table = _domain_table.lock(); domain_table)
+        if (domain_table)
             domain_value = domain_table->driven_value();
+
+        _domain_delta = domain_table
+            ? std::optional<std::int64_t>{domain_table->delta()}
+            : std::nullopt;
     }
 
     on_data_received(
@@ -140,6 +165,7 @@ void wss::detail::remote_signal_impl::detach()
     on_unavailable.disconnect_all_slots();
 
     _domain_signal.reset();
+    _domain_table = nullptr;
 }
 
 void wss::detail::remote_signal_impl::signo(unsigned signo)
@@ -170,13 +196,14 @@ void wss::detail::remote_signal_impl::handle_signal(
 {
     _metadata = wss::metadata(params);
     _sample_size = metadata().sample_size();
+    _codec = payload_codec{_metadata};
 
     if (_metadata.rule() == rule_types::linear_rule)
     {
         if (_table)
             _table->update(_metadata);
         else
-            _table = std::make_shared<linear_table>(_metadata);
+            _table.emplace(_metadata);
     }
 
     else
@@ -192,16 +219,13 @@ void wss::detail::remote_signal_impl::handle_signal(
     if (!table_id.empty() && table_id != id())
     {
         _domain_signal = on_signal_sought(table_id).value_or(nullptr);
-        if (_domain_signal)
-            _domain_table = _domain_signal->_table;
-        else
-            _domain_table.reset();
+        _domain_table = _domain_signal ? &_domain_signal->_table : nullptr;
     }
 
     else
     {
         _domain_signal.reset();
-        _domain_table.reset();
+        _domain_table = nullptr;
     }
 
     on_metadata_changed();
@@ -230,6 +254,7 @@ void wss::detail::remote_signal_impl::handle_data(
             .build());
 
     _sample_size = metadata().sample_size();
+    _codec = payload_codec{_metadata};
 
     on_metadata_changed();
 }
@@ -240,9 +265,8 @@ void wss::detail::remote_signal_impl::handle_time(
     std::uint32_t seconds = detail::json_ptr(params, "/stamp/seconds", std::uint32_t{0});
     std::uint32_t fraction = detail::json_ptr(params, "/stamp/fraction", std::uint32_t{0});
 
-    boost::multiprecision::cpp_int two_31 = 1;
-    two_31 <<= 31;
+    // Direct TCP protocol timestamps count seconds since 2000-01-01, offset by half a second.
+    constexpr fixed_point_time offset{946684800, std::uint64_t{1} << 63};
 
-    boost::multiprecision::cpp_rational y{two_31 + fraction, two_31 * 2};
-    _tcp_time = static_cast<std::uint64_t>((y + seconds + 946684800) * 1000000000);
+    _tcp_time = (fixed_point_time::from_ntp(seconds, fraction) + offset).to_ticks(1, 1000000000);
 }
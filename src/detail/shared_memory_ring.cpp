@@ -0,0 +1,241 @@
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <random>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <boost/asio/error.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <ws-streaming/detail/shared_memory_ring.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace
+{
+    constexpr std::uint64_t RING_MAGIC = 0x676e697273737777ull; // "wwssring"
+
+    [[noreturn]] void throw_errno(const char *what)
+    {
+        throw boost::system::system_error(
+            boost::system::error_code(errno, boost::system::system_category()),
+            what);
+    }
+}
+
+wss::detail::shared_memory_ring::shared_memory_ring(std::size_t capacity)
+    : _is_owner(true)
+{
+    std::size_t page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    std::size_t header_size = (sizeof(header) + page_size - 1) / page_size * page_size;
+    _capacity = (capacity + page_size - 1) / page_size * page_size;
+
+    std::random_device random;
+    std::uint64_t cookie = (static_cast<std::uint64_t>(random()) << 32) | random();
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "/wss-%016llx",
+        static_cast<unsigned long long>((static_cast<std::uint64_t>(random()) << 32) | random()));
+    _name = name;
+
+    int fd = ::shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+        throw_errno("shm_open");
+
+    if (::ftruncate(fd, static_cast<off_t>(header_size + _capacity)) < 0)
+    {
+        int saved_errno = errno;
+        ::close(fd);
+        ::shm_unlink(_name.c_str());
+        errno = saved_errno;
+        throw_errno("ftruncate");
+    }
+
+    try
+    {
+        map(fd, header_size);
+    }
+
+    catch (...)
+    {
+        ::close(fd);
+        ::shm_unlink(_name.c_str());
+        throw;
+    }
+
+    ::close(fd);
+
+    _header = new (_mapping) header{};
+    _header->magic = RING_MAGIC;
+    _header->cookie = cookie;
+    _header->capacity = _capacity;
+}
+
+wss::detail::shared_memory_ring::shared_memory_ring(
+        const std::string& name,
+        std::uint64_t cookie)
+    : _name(name)
+    , _is_owner(false)
+{
+    std::size_t page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    std::size_t header_size = (sizeof(header) + page_size - 1) / page_size * page_size;
+
+    int fd = ::shm_open(_name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+        throw_errno("shm_open");
+
+    struct stat st;
+    if (::fstat(fd, &st) < 0)
+    {
+        int saved_errno = errno;
+        ::close(fd);
+        errno = saved_errno;
+        throw_errno("fstat");
+    }
+
+    // Mapping a segment that is shorter than the header would succeed, but reading the header
+    // would then raise SIGBUS, so such segments must be rejected before touching the mapping.
+    if (st.st_size < 0 || static_cast<std::uint64_t>(st.st_size) < header_size)
+    {
+        ::close(fd);
+        throw boost::system::system_error(
+            boost::asio::error::invalid_argument,
+            "shared memory ring");
+    }
+
+    const header *remote_header = static_cast<const header *>(
+        ::mmap(nullptr, sizeof(header), PROT_READ, MAP_SHARED, fd, 0));
+
+    if (remote_header == MAP_FAILED)
+    {
+        int saved_errno = errno;
+        ::close(fd);
+        errno = saved_errno;
+        throw_errno("mmap");
+    }
+
+    bool is_valid = remote_header->magic == RING_MAGIC
+        && remote_header->cookie == cookie
+        && remote_header->capacity % page_size == 0
+        && static_cast<std::uint64_t>(st.st_size) == header_size + remote_header->capacity;
+    _capacity = static_cast<std::size_t>(remote_header->capacity);
+    ::munmap(const_cast<header *>(remote_header), sizeof(header));
+
+    if (!is_valid)
+    {
+        ::close(fd);
+        throw boost::system::system_error(
+            boost::asio::error::invalid_argument,
+            "shared memory ring");
+    }
+
+    try
+    {
+        map(fd, header_size);
+    }
+
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+
+    ::close(fd);
+
+    _header = static_cast<header *>(_mapping);
+    _tail = _header->tail.load(std::memory_order_acquire);
+    _seen_head = _tail;
+}
+
+wss::detail::shared_memory_ring::~shared_memory_ring()
+{
+    if (_is_owner)
+        unlink();
+
+    if (_mapping)
+        ::munmap(_mapping, _mapping_size);
+}
+
+void wss::detail::shared_memory_ring::unlink() noexcept
+{
+    if (_is_owner && !_name.empty())
+        ::shm_unlink(_name.c_str());
+
+    _is_owner = false;
+}
+
+void wss::detail::shared_memory_ring::map(int fd, std::size_t header_size)
+{
+    // Reserve address space for the header followed by two copies of the data area, then map
+    // the segment over it such that the data area appears twice, back to back. Reads and writes
+    // that wrap around the end of the ring then see contiguous memory.
+    _mapping_size = header_size + 2 * _capacity;
+
+    _mapping = ::mmap(nullptr, _mapping_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (_mapping == MAP_FAILED)
+    {
+        _mapping = nullptr;
+        throw_errno("mmap");
+    }
+
+    std::uint8_t *base = static_cast<std::uint8_t *>(_mapping);
+
+    if (::mmap(base, header_size + _capacity,
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+            || ::mmap(base + header_size + _capacity, _capacity,
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd,
+                static_cast<off_t>(header_size)) == MAP_FAILED)
+    {
+        int saved_errno = errno;
+        ::munmap(_mapping, _mapping_size);
+        _mapping = nullptr;
+        errno = saved_errno;
+        throw_errno("mmap");
+    }
+
+    _data = base + header_size;
+}
+
+#else
+
+wss::detail::shared_memory_ring::shared_memory_ring(std::size_t capacity)
+    : _is_owner(false)
+{
+    throw boost::system::system_error(
+        boost::asio::error::operation_not_supported,
+        "shared memory ring");
+}
+
+wss::detail::shared_memory_ring::shared_memory_ring(
+        const std::string& name,
+        std::uint64_t cookie)
+    : _is_owner(false)
+{
+    throw boost::system::system_error(
+        boost::asio::error::operation_not_supported,
+        "shared memory ring");
+}
+
+wss::detail::shared_memory_ring::~shared_memory_ring()
+{
+}
+
+void wss::detail::shared_memory_ring::unlink() noexcept
+{
+}
+
+void wss::detail::shared_memory_ring::map(int fd, std::size_t header_size)
+{
+}
+
+#endif
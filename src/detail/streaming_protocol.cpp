@@ -1,6 +1,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <boost/endian/conversion.hpp>
+
 #include <ws-streaming/detail/streaming_protocol.hpp>
 
 wss::detail::streaming_protocol::decoded_header
@@ -9,45 +11,8 @@ wss::detail::streaming_protocol::decode_header(
     std::size_t size,
     bool use_tcp_protocol) noexcept
 {
-    decoded_header header { };
-    const std::uint8_t *data_begin = data;
-
-    if (size < sizeof(std::uint32_t))
-        return header;
-
     if (use_tcp_protocol)
-    {
-        header.type = data[0] >> 4;
-        header.signo = ((data[1] & 0xFu) << 16) | (data[2] << 8) | data[3];
-        header.payload_size = ((data[0] & 0xFu) << 4) | (data[1] >> 4);
-    }
-
+        return decode_header<boost::endian::order::big>(data, size);
     else
-    {
-        header.type = data[3] >> 4;
-        header.signo = ((data[2] & 0xFu) << 16) | (data[1] << 8) | data[0];
-        header.payload_size = ((data[3] & 0xFu) << 4) | (data[2] >> 4);
-    }
-
-    data += sizeof(std::uint32_t);
-    size -= sizeof(std::uint32_t);
-
-    if (header.payload_size == 0)
-    {
-        if (size < sizeof(std::uint32_t))
-            return header;
-
-        if (use_tcp_protocol)
-            header.payload_size = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
-        else
-            header.payload_size = (data[3] << 24) | (data[2] << 16) | (data[1] << 8) | data[0];
-
-        data += sizeof(std::uint32_t);
-        size -= sizeof(std::uint32_t);
-    }
-
-    if (size >= header.payload_size)
-        header.header_size = data - data_begin;
-
-    return header;
-}
\ No newline at end of file
+        return decode_header<boost::endian::order::little>(data, size);
+}
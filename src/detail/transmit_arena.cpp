@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <ws-streaming/detail/transmit_arena.hpp>
+
+struct wss::detail::transmit_arena::slab
+{
+    explicit slab(std::size_t size)
+        : data(new std::uint8_t[size])
+        , size(size)
+    {
+    }
+
+    std::unique_ptr<std::uint8_t[]> data;
+    std::size_t size;
+    slab *next = nullptr;
+
+    // Storage for the control block of the shared pointer through which the slab is handed out.
+    alignas(std::max_align_t) unsigned char control_block[96];
+};
+
+struct wss::detail::transmit_arena::slab_list
+{
+    ~slab_list()
+    {
+        for (slab *s = head.load(std::memory_order_acquire); s; )
+            delete std::exchange(s, s->next);
+    }
+
+    void push(slab *s) noexcept
+    {
+        s->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(
+                s->next, s,
+                std::memory_order_release,
+                std::memory_order_relaxed));
+    }
+
+    slab *pop_all() noexcept
+    {
+        return head.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    std::atomic<slab *> head = nullptr;
+};
+
+// Places the control block of a slab's shared pointer inside the slab, and returns the slab to
+// the arena's list of released slabs once the control block has been destroyed. This is the
+// last access a shared pointer makes to the slab, so the arena may reuse it immediately.
+template <typename T>
+struct wss::detail::transmit_arena::slab_allocator
+{
+    using value_type = T;
+
+    slab_allocator(slab *owner, std::shared_ptr<slab_list> released) noexcept
+        : owner(owner)
+        , released(std::move(released))
+    {
+    }
+
+    template <typename U>
+    slab_allocator(const slab_allocator<U>& other) noexcept
+        : owner(other.owner)
+        , released(other.released)
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        static_assert(sizeof(T) <= sizeof(slab::control_block),
+            "shared pointer control block does not fit in a slab");
+        static_assert(alignof(T) <= alignof(std::max_align_t));
+
+        if (n != 1)
+            throw std::bad_alloc();
+
+        return reinterpret_cast<T *>(owner->control_block);
+    }
+
+    void deallocate(T *, std::size_t) noexcept
+    {
+        released->push(owner);
+    }
+
+    template <typename U>
+    bool operator==(const slab_allocator<U>& rhs) const noexcept
+    {
+        return owner == rhs.owner;
+    }
+
+    template <typename U>
+    bool operator!=(const slab_allocator<U>& rhs) const noexcept
+    {
+        return owner != rhs.owner;
+    }
+
+    slab *owner;
+    std::shared_ptr<slab_list> released;
+};
+
+wss::detail::transmit_arena::transmit_arena(std::size_t slab_size)
+    : _slab_size(slab_size)
+{
+}
+
+wss::detail::transmit_arena::~transmit_arena()
+{
+}
+
+std::shared_ptr<std::uint8_t> wss::detail::transmit_arena::allocate(std::size_t size)
+{
+    std::size_t aligned_size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    if (!_current || _offset + aligned_size > _current->size)
+    {
+        _current.reset();
+        _current = acquire_slab(aligned_size);
+        _offset = 0;
+    }
+
+    std::shared_ptr<std::uint8_t> allocation{_current, _current->data.get() + _offset};
+    _offset += aligned_size;
+
+    return allocation;
+}
+
+void wss::detail::transmit_arena::trim(
+    const std::uint8_t *allocation,
+    std::size_t old_size,
+    std::size_t new_size) noexcept
+{
+    std::size_t aligned_old_size = (old_size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    std::size_t aligned_new_size = (new_size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    if (_current && allocation + aligned_old_size == _current->data.get() + _offset)
+        _offset -= aligned_old_size - aligned_new_size;
+}
+
+std::shared_ptr<wss::detail::transmit_arena::slab>
+wss::detail::transmit_arena::acquire_slab(std::size_t size)
+{
+    if (!_released)
+    {
+        _released = std::make_shared<slab_list>();
+        _spare.reserve(MAX_SPARE_SLABS);
+    }
+
+    // Take back the slabs released since the last call. Dedicated slabs for large requests, and
+    // slabs beyond the retention limit, are freed.
+    for (slab *released = _released->pop_all(); released; )
+    {
+        std::unique_ptr<slab> s{std::exchange(released, released->next)};
+        if (s->size == _slab_size && _spare.size() < MAX_SPARE_SLABS)
+            _spare.push_back(std::move(s));
+    }
+
+    std::unique_ptr<slab> acquired;
+
+    // Reuse a slab that is large enough.
+    auto it = std::find_if(_spare.begin(), _spare.end(),
+        [size](const auto& candidate) { return candidate->size >= size; });
+
+    if (it != _spare.end())
+    {
+        acquired = std::move(*it);
+        _spare.erase(it);
+    }
+
+    else
+        acquired = std::make_unique<slab>(std::max(size, _slab_size));
+
+    slab *raw = acquired.release();
+
+    return std::shared_ptr<slab>(
+        raw,
+        [](slab *) noexcept { },
+        slab_allocator<slab>{raw, _released});
+}
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/rfc7230.hpp>
+
+#include <ws-streaming/detail/websocket_extensions.hpp>
+
+static void append_extension(std::string& header, const std::string& extension)
+{
+    if (!header.empty())
+        header += ", ";
+
+    header += extension;
+}
+
+// Parses a window size parameter value, which may be quoted. Values outside the range
+// permitted by RFC 7692 yield zero.
+static unsigned parse_window_bits(boost::beast::string_view value)
+{
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+        value = value.substr(1, value.size() - 2);
+
+    if (value.empty() || value.size() > 2
+            || !std::all_of(value.begin(), value.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        return 0;
+
+    unsigned bits = std::stoul(std::string(value));
+    return bits >= 8 && bits <= wss::detail::websocket_extensions::MAX_WINDOW_BITS ? bits : 0;
+}
+
+// Parses the parameters of a per-message deflate offer or response into the specified object,
+// recording which window size parameters were present. Returns false if any parameter is
+// unknown, repeated or invalid, in which case the offer must be declined (or, for a response,
+// the connection failed).
+static bool parse_deflate_params(
+    const boost::beast::http::param_list& params,
+    wss::detail::websocket_extensions& extensions,
+    bool& has_server_max_window_bits,
+    bool& has_client_max_window_bits)
+{
+    bool has_server_no_context_takeover = false;
+    bool has_client_no_context_takeover = false;
+
+    has_server_max_window_bits = false;
+    has_client_max_window_bits = false;
+
+    for (const auto& [name, value] : params)
+    {
+        if (boost::beast::iequals(name, "server_no_context_takeover")
+                && !has_server_no_context_takeover
+                && value.empty())
+            has_server_no_context_takeover = extensions.server_no_context_takeover = true;
+
+        else if (boost::beast::iequals(name, "client_no_context_takeover")
+                && !has_client_no_context_takeover
+                && value.empty())
+            has_client_no_context_takeover = extensions.client_no_context_takeover = true;
+
+        else if (boost::beast::iequals(name, "server_max_window_bits")
+                && !has_server_max_window_bits
+                && (extensions.server_max_window_bits = parse_window_bits(value)))
+            has_server_max_window_bits = true;
+
+        // The client may offer this parameter without a value, to indicate only that it
+        // supports it.
+        else if (boost::beast::iequals(name, "client_max_window_bits")
+                && !has_client_max_window_bits
+                && (value.empty() || (extensions.client_max_window_bits = parse_window_bits(value))))
+            has_client_max_window_bits = true;
+
+        else
+            return false;
+    }
+
+    return true;
+}
+
+std::string wss::detail::websocket_extensions::offer() const
+{
+    std::string header;
+
+    if (block_compression)
+        append_extension(header, BLOCK_COMPRESSION);
+
+    if (permessage_deflate)
+    {
+        std::string extension = PERMESSAGE_DEFLATE;
+
+        if (server_no_context_takeover)
+            extension += "; server_no_context_takeover";
+        if (client_no_context_takeover)
+            extension += "; client_no_context_takeover";
+        if (server_max_window_bits < MAX_WINDOW_BITS)
+            extension += "; server_max_window_bits=" + std::to_string(server_max_window_bits);
+
+        // We always accept a limit on the window size we use.
+        extension += "; client_max_window_bits";
+        if (client_max_window_bits < MAX_WINDOW_BITS)
+            extension += "=" + std::to_string(client_max_window_bits);
+
+        append_extension(header, extension);
+    }
+
+    return header;
+}
+
+wss::detail::websocket_extensions wss::detail::websocket_extensions::negotiate(
+    const std::string& offer,
+    const websocket_extensions& supported,
+    std::string& response)
+{
+    websocket_extensions agreed;
+    response.clear();
+
+    for (const auto& [name, params] : boost::beast::http::ext_list{offer})
+    {
+        // The block compression extension has no parameters; offers with parameters are from
+        // some other version of it, which we do not understand.
+        if (boost::beast::iequals(name, BLOCK_COMPRESSION)
+                && supported.block_compression
+                && !agreed.block_compression
+                && params.begin() == params.end())
+        {
+            agreed.block_compression = true;
+            append_extension(response, BLOCK_COMPRESSION);
+        }
+
+        // A client may make several per-message deflate offers in order of preference; we
+        // accept the first one we can satisfy.
+        else if (boost::beast::iequals(name, PERMESSAGE_DEFLATE)
+                && supported.permessage_deflate
+                && !agreed.permessage_deflate)
+        {
+            websocket_extensions requested;
+            bool has_server_max_window_bits;
+            bool has_client_max_window_bits;
+
+            if (!parse_deflate_params(params, requested, has_server_max_window_bits, has_client_max_window_bits)
+                    || requested.server_max_window_bits < MIN_WINDOW_BITS)
+                continue;
+
+            agreed.permessage_deflate = true;
+            agreed.server_no_context_takeover = requested.server_no_context_takeover || supported.server_no_context_takeover;
+            agreed.client_no_context_takeover = requested.client_no_context_takeover || supported.client_no_context_takeover;
+            agreed.server_max_window_bits = std::min(requested.server_max_window_bits, supported.server_max_window_bits);
+            agreed.client_max_window_bits = has_client_max_window_bits
+                ? std::min(requested.client_max_window_bits, supported.client_max_window_bits)
+                : MAX_WINDOW_BITS;
+
+            std::string extension = PERMESSAGE_DEFLATE;
+
+            if (agreed.server_no_context_takeover)
+                extension += "; server_no_context_takeover";
+            if (agreed.client_no_context_takeover)
+                extension += "; client_no_context_takeover";
+
+            // A limit the client asked for must be acknowledged, even if we do not lower it.
+            if (has_server_max_window_bits || agreed.server_max_window_bits < MAX_WINDOW_BITS)
+                extension += "; server_max_window_bits=" + std::to_string(agreed.server_max_window_bits);
+            if (agreed.client_max_window_bits < MAX_WINDOW_BITS)
+                extension += "; client_max_window_bits=" + std::to_string(agreed.client_max_window_bits);
+
+            append_extension(response, extension);
+        }
+    }
+
+    return agreed;
+}
+
+std::optional<wss::detail::websocket_extensions> wss::detail::websocket_extensions::accept(
+    const std::string& response,
+    const websocket_extensions& offered)
+{
+    websocket_extensions agreed;
+
+    for (const auto& [name, params] : boost::beast::http::ext_list{response})
+    {
+        if (boost::beast::iequals(name, BLOCK_COMPRESSION)
+                && offered.block_compression
+                && !agreed.block_compression
+                && params.begin() == params.end())
+            agreed.block_compression = true;
+
+        else if (boost::beast::iequals(name, PERMESSAGE_DEFLATE)
+                && offered.permessage_deflate
+                && !agreed.permessage_deflate)
+        {
+            bool has_server_max_window_bits;
+            bool has_client_max_window_bits;
+
+            if (!parse_deflate_params(params, agreed, has_server_max_window_bits, has_client_max_window_bits)
+                    || agreed.server_max_window_bits > offered.server_max_window_bits)
+                return std::nullopt;
+
+            // We honor the limits we asked for ourselves, even if the server did not repeat them.
+            agreed.permessage_deflate = true;
+            agreed.client_no_context_takeover = agreed.client_no_context_takeover || offered.client_no_context_takeover;
+            agreed.client_max_window_bits = std::min(agreed.client_max_window_bits, offered.client_max_window_bits);
+        }
+
+        else
+            return std::nullopt;
+    }
+
+    return agreed;
+}
@@ -0,0 +1,80 @@
+#include <cstdint>
+#include <limits>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include <ws-streaming/fixed_point_time.hpp>
+
+// Intermediate products of a 128-bit time value and a 64-bit tick resolution need up to 192
+// bits. Fixed-width cpp_int types are stored inline and never allocate.
+using uint256 = boost::multiprecision::uint256_t;
+
+static constexpr std::uint64_t MAX_UINT64 = std::numeric_limits<std::uint64_t>::max();
+
+static uint256 to_uint256(const wss::fixed_point_time& time)
+{
+    return (uint256{time.seconds()} << 64) | time.fraction();
+}
+
+static std::uint64_t saturate(const uint256& value) noexcept
+{
+    return value > MAX_UINT64
+        ? MAX_UINT64
+        : static_cast<std::uint64_t>(value);
+}
+
+static std::uint64_t convert_to_ticks(
+    const wss::fixed_point_time& time,
+    std::uint64_t numerator,
+    std::uint64_t denominator,
+    std::uint64_t divisor,
+    bool round) noexcept
+{
+    if (!numerator || !divisor)
+        return 0;
+
+    // ticks = (time / divisor) / (numerator / denominator)
+    //       = (time_2_64 * denominator) / (2^64 * numerator * divisor)
+    uint256 dividend = to_uint256(time) * denominator;
+    uint256 quotient_divisor = (uint256{numerator} * divisor) << 64;
+
+    if (round)
+        dividend += quotient_divisor >> 1;
+
+    return saturate(dividend / quotient_divisor);
+}
+
+wss::fixed_point_time wss::fixed_point_time::from_ticks(
+    std::uint64_t ticks,
+    std::uint64_t numerator,
+    std::uint64_t denominator) noexcept
+{
+    if (!denominator)
+        return { };
+
+    uint256 value = ((uint256{ticks} * numerator) << 64) / denominator;
+
+    if (value >> 128)
+        return { MAX_UINT64, MAX_UINT64 };
+
+    return {
+        static_cast<std::uint64_t>(value >> 64),
+        static_cast<std::uint64_t>(value & MAX_UINT64)
+    };
+}
+
+std::uint64_t wss::fixed_point_time::to_ticks(
+    std::uint64_t numerator,
+    std::uint64_t denominator,
+    std::uint64_t divisor) const noexcept
+{
+    return convert_to_ticks(*this, numerator, denominator, divisor, false);
+}
+
+std::uint64_t wss::fixed_point_time::to_ticks_rounded(
+    std::uint64_t numerator,
+    std::uint64_t denominator,
+    std::uint64_t divisor) const noexcept
+{
+    return convert_to_ticks(*this, numerator, denominator, divisor, true);
+}
@@ -1,9 +1,18 @@
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
 
+#include <boost/asio/buffer.hpp>
+
 #include <ws-streaming/local_signal.hpp>
 #include <ws-streaming/metadata.hpp>
+#include <ws-streaming/detail/broadcast_ring.hpp>
+#include <ws-streaming/detail/deadband_filter.hpp>
+#include <ws-streaming/detail/last_value_cache.hpp>
 
 wss::local_signal::local_signal(
         const std::string& id,
@@ -16,6 +25,10 @@ wss::local_signal::local_signal(
 void wss::local_signal::set_metadata(const wss::metadata& metadata)
 {
     _metadata = metadata;
+
+    if (_deadband)
+        _deadband->update(_metadata);
+
     on_metadata_changed();
 }
 
@@ -24,7 +37,8 @@ void wss::local_signal::publish_data(
     std::size_t size)
     noexcept
 {
-    on_data_published(0, 0, data, size);
+    boost::asio::const_buffer buffer{data, size};
+    publish(0, 0, &buffer, 1, nullptr);
 }
 
 void wss::local_signal::publish_data(
@@ -34,7 +48,166 @@ void wss::local_signal::publish_data(
     std::size_t size)
     noexcept
 {
-    on_data_published(domain_value, sample_count, data, size);
+    boost::asio::const_buffer buffer{data, size};
+    publish(domain_value, sample_count, &buffer, 1, nullptr);
+}
+
+void wss::local_signal::publish_data(
+    const std::shared_ptr<const void>& data,
+    std::size_t size)
+    noexcept
+{
+    boost::asio::const_buffer buffer{data.get(), size};
+    publish(0, 0, &buffer, 1, data);
+}
+
+void wss::local_signal::publish_data(
+    std::int64_t domain_value,
+    std::size_t sample_count,
+    const std::shared_ptr<const void>& data,
+    std::size_t size)
+    noexcept
+{
+    boost::asio::const_buffer buffer{data.get(), size};
+    publish(domain_value, sample_count, &buffer, 1, data);
+}
+
+wss::local_signal::reservation wss::local_signal::reserve(std::size_t size)
+{
+    reservation result;
+    result._data = _arena.allocate(size);
+    result._size = size;
+    return result;
+}
+
+void wss::local_signal::commit(
+    reservation& reservation,
+    std::size_t size)
+    noexcept
+{
+    commit(0, 0, reservation, size);
+}
+
+void wss::local_signal::commit(
+    std::int64_t domain_value,
+    std::size_t sample_count,
+    reservation& reservation,
+    std::size_t size)
+    noexcept
+{
+    _arena.trim(reservation._data.get(), reservation._size, size);
+
+    std::shared_ptr<const void> data = std::move(reservation._data);
+    reservation._size = 0;
+
+    boost::asio::const_buffer buffer{data.get(), size};
+    publish(domain_value, sample_count, &buffer, 1, data);
+}
+
+void wss::local_signal::set_domain_tolerance(std::uint64_t ticks) noexcept
+{
+    _domain_tolerance.store(ticks, std::memory_order_relaxed);
+}
+
+std::uint64_t wss::local_signal::domain_tolerance() const noexcept
+{
+    return _domain_tolerance.load(std::memory_order_relaxed);
+}
+
+wss::domain_sync_statistics wss::local_signal::domain_statistics() const noexcept
+{
+    return {
+        _domain_blocks.load(std::memory_order_relaxed),
+        _domain_resyncs.load(std::memory_order_relaxed),
+        _domain_max_error.load(std::memory_order_relaxed),
+    };
+}
+
+void wss::local_signal::record_domain_sync(std::uint64_t error, bool resynced) noexcept
+{
+    _domain_blocks.fetch_add(1, std::memory_order_relaxed);
+
+    if (resynced)
+    {
+        _domain_resyncs.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    std::uint64_t max_error = _domain_max_error.load(std::memory_order_relaxed);
+    while (error > max_error
+            && !_domain_max_error.compare_exchange_weak(
+                max_error,
+                error,
+                std::memory_order_relaxed));
+}
+
+void wss::local_signal::set_deadband(
+    double absolute,
+    double relative,
+    std::chrono::steady_clock::duration heartbeat)
+{
+    _deadband.emplace(_metadata, absolute, relative, heartbeat);
+    _has_deadband.store(true, std::memory_order_relaxed);
+}
+
+void wss::local_signal::clear_deadband() noexcept
+{
+    _deadband.reset();
+    _has_deadband.store(false, std::memory_order_relaxed);
+}
+
+bool wss::local_signal::has_deadband() const noexcept
+{
+    return _has_deadband.load(std::memory_order_relaxed);
+}
+
+void wss::local_signal::set_last_value_cache(bool enable)
+{
+    _last_value.enable(enable);
+}
+
+std::optional<wss::detail::last_value_cache::block> wss::local_signal::last_value() const
+{
+    return _last_value.load();
+}
+
+void wss::local_signal::enable_broadcast_ring(std::size_t capacity)
+{
+    _broadcast_ring = std::make_shared<detail::broadcast_ring>(capacity);
+}
+
+const std::shared_ptr<wss::detail::broadcast_ring>& wss::local_signal::broadcast_ring() const noexcept
+{
+    return _broadcast_ring;
+}
+
+void wss::local_signal::publish(
+    std::int64_t domain_value,
+    std::size_t sample_count,
+    const boost::asio::const_buffer *buffers,
+    std::size_t buffer_count,
+    const std::shared_ptr<const void>& owner)
+    noexcept
+{
+    if (_deadband && !_deadband->admit(buffers, buffer_count, std::chrono::steady_clock::now()))
+        return;
+
+    // Blocks are numbered so that a subscribing endpoint can tell which of them it has already
+    // transmitted from the last-value cache. Ring blocks are numbered by the position following
+    // them, where an endpoint must start reading to receive only newer blocks.
+    if (_broadcast_ring)
+    {
+        _broadcast_ring->append(domain_value, sample_count, buffers, buffer_count);
+        _last_value.store(
+            _broadcast_ring->head(), domain_value, sample_count, buffers, buffer_count, owner);
+    }
+
+    else
+    {
+        _last_value.store(
+            ++_publish_sequence, domain_value, sample_count, buffers, buffer_count, owner);
+        on_data_published(domain_value, sample_count, buffers, buffer_count, owner);
+    }
 }
 
 const std::string& wss::local_signal::id() const noexcept
@@ -4,32 +4,17 @@
 #include <string>
 #include <utility>
 
-#include <boost/multiprecision/cpp_int.hpp>
-
 #include <nlohmann/json.hpp>
 
 #include <ws-streaming/data_types.hpp>
 #include <ws-streaming/endianness.hpp>
+#include <ws-streaming/fixed_point_time.hpp>
 #include <ws-streaming/metadata.hpp>
 #include <ws-streaming/rule_types.hpp>
+#include <ws-streaming/struct_layout.hpp>
+#include <ws-streaming/detail/data_type_size.hpp>
 #include <ws-streaming/detail/json.hpp>
 
-static std::size_t get_primitive_size(const std::string& type)
-{
-    if (type == wss::data_types::int8_t) return sizeof(std::int8_t);
-    if (type == wss::data_types::int16_t) return sizeof(std::int16_t);
-    if (type == wss::data_types::int32_t) return sizeof(std::int32_t);
-    if (type == wss::data_types::int64_t) return sizeof(std::int64_t);
-    if (type == wss::data_types::uint8_t) return sizeof(std::uint8_t);
-    if (type == wss::data_types::uint16_t) return sizeof(std::uint16_t);
-    if (type == wss::data_types::uint32_t) return sizeof(std::uint32_t);
-    if (type == wss::data_types::uint64_t) return sizeof(std::uint64_t);
-    if (type == wss::data_types::real32_t) return 4;
-    if (type == wss::data_types::real64_t) return 8;
-
-    return 0;
-}
-
 wss::metadata::metadata()
     : _json(nlohmann::json::object())
 {
@@ -40,6 +25,17 @@ wss::metadata::metadata(const nlohmann::json& json)
 {
 }
 
+std::string wss::metadata::encoding() const
+{
+    if (_json.contains("definition")
+            && _json["definition"].is_object()
+            && _json["definition"].contains("encoding")
+            && _json["definition"]["encoding"].is_string())
+        return _json["definition"]["encoding"];
+
+    return "";
+}
+
 std::string wss::metadata::endian() const
 {
     if (_json.contains("definition")
@@ -130,25 +126,13 @@ std::uint64_t wss::metadata::tcp_signal_rate_ticks(
     std::uint32_t sub_fraction = detail::json_ptr(signal_rate, "/delta/subFraction", std::uint32_t{0});
     std::uint32_t samples = detail::json_ptr(signal_rate, "/samples", std::uint32_t{1});
 
-    boost::multiprecision::cpp_int ticks_2_64 = seconds;
-    ticks_2_64 <<= 32;
-    ticks_2_64 += fraction;
-    ticks_2_64 <<= 32;
-    ticks_2_64 += sub_fraction;
-
-    boost::multiprecision::cpp_int two_64 = 1;
-    two_64 <<= 64;
-
-    // This represents half a quantum, and adding this term below causes the resulting value to be
-    // rounded to the nearest integer tick value instead of truncating (rounding down).
-    boost::multiprecision::cpp_rational half{
-        two_64 * numerator,
-        boost::multiprecision::cpp_int{denominator} * 2};
-
-    return static_cast<std::uint64_t>(
-        boost::multiprecision::cpp_rational(
-            ticks_2_64 * denominator + half * samples,
-            two_64 * samples * numerator));
+    // The interval is a 32.64 fixed-point number of seconds spanning the specified number of
+    // samples. Round to the nearest tick rather than truncating.
+    fixed_point_time delta{
+        seconds,
+        (std::uint64_t{fraction} << 32) | sub_fraction};
+
+    return delta.to_ticks_rounded(numerator, denominator, samples);
 }
 
 std::string wss::metadata::origin() const
@@ -168,6 +152,30 @@ std::string wss::metadata::origin() const
     return "";
 }
 
+std::optional<std::pair<double, double>>
+wss::metadata::post_scaling() const
+{
+    if (_json.contains("definition")
+        && _json["definition"].is_object()
+        && _json["definition"].contains("postScaling")
+        && _json["definition"]["postScaling"].is_object())
+    {
+        const auto& post_scaling = _json["definition"]["postScaling"];
+
+        double scale = 1, offset = 0;
+
+        if (post_scaling.contains("scale") && post_scaling["scale"].is_number())
+            scale = post_scaling["scale"];
+
+        if (post_scaling.contains("offset") && post_scaling["offset"].is_number())
+            offset = post_scaling["offset"];
+
+        return std::make_pair(scale, offset);
+    }
+
+    return std::nullopt;
+}
+
 std::optional<std::pair<double, double>>
 wss::metadata::range() const
 {
@@ -207,47 +215,10 @@ std::size_t wss::metadata::sample_size() const
 {
     std::string type = data_type();
 
-    std::size_t size = get_primitive_size(type);
-
-    if (!size && type == data_types::struct_t)
-    {
-        if (_json.contains("definition")
-            && _json["definition"].is_object()
-            && _json["definition"].contains("struct")
-            && _json["definition"]["struct"].is_array())
-        {
-            const auto& struct_array = _json["definition"]["struct"];
-
-            for (const auto& field : struct_array)
-            {
-                if (!field.is_object())
-                    continue;
-                if (!field.contains("dataType") || !field["dataType"].is_string())
-                    continue;
-
-                std::size_t field_size = get_primitive_size(field["dataType"]);
-
-                if (field.contains("dimensions")
-                    && field["dimensions"].is_array()
-                    && field["dimensions"].size() >= 1
-                    && field["dimensions"][0].is_object()
-                    && field["dimensions"][0].contains("linear")
-                    && field["dimensions"][0]["linear"].is_object())
-                {
-                    const auto& linear = field["dimensions"][0]["linear"];
-
-                    std::size_t count = 1;
-                    if (linear.contains("size") && linear["size"].is_number_integer())
-                        count = linear["size"];
-                    field_size *= count;
-                }
-
-                size += field_size;
-            }
-        }
-    }
+    if (type == data_types::struct_t)
+        return struct_layout{*this}.sample_size();
 
-    return size;
+    return detail::data_type_size(type);
 }
 
 std::string wss::metadata::table_id() const
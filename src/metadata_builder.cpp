@@ -65,6 +65,14 @@ wss::metadata_builder& wss::metadata_builder::data_type(
     return *this;
 }
 
+wss::metadata_builder& wss::metadata_builder::encoding(
+    const std::string& encoding)
+{
+    _metadata["definition"]["encoding"] = encoding;
+
+    return *this;
+}
+
 wss::metadata_builder& wss::metadata_builder::endian(
     const std::string& endian)
 {
@@ -113,6 +121,18 @@ wss::metadata_builder& wss::metadata_builder::origin(
     return *this;
 }
 
+wss::metadata_builder& wss::metadata_builder::post_scaling(
+    double scale,
+    double offset)
+{
+    _metadata["definition"]["postScaling"] = {
+        { "scale", scale },
+        { "offset", offset }
+    };
+
+    return *this;
+}
+
 wss::metadata_builder& wss::metadata_builder::range(
     double low,
     double high)
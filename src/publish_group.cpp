@@ -0,0 +1,66 @@
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/asio/buffer.hpp>
+
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/publish_group.hpp>
+
+void wss::publish_group::add(
+    local_signal& signal,
+    const void *data,
+    std::size_t size)
+{
+    _entries.push_back({ &signal, 0, 0, boost::asio::const_buffer{data, size} });
+}
+
+void wss::publish_group::add(
+    local_signal& signal,
+    std::int64_t domain_value,
+    std::size_t sample_count,
+    const void *data,
+    std::size_t size)
+{
+    _entries.push_back({ &signal, domain_value, sample_count, boost::asio::const_buffer{data, size} });
+}
+
+void wss::publish_group::reserve(std::size_t count)
+{
+    _entries.reserve(count);
+}
+
+void wss::publish_group::publish() noexcept
+{
+    // Announce the group to every signal's subscribers first, so that no connection transmits
+    // any of the group's data until all of it has been published. Connections count nested
+    // begin/end events, so signals appearing more than once are harmless. Signals with
+    // broadcast rings are skipped: connections drain every ring in a single batch anyway, and
+    // raising events is not real-time-safe.
+    for (const auto& entry : _entries)
+        if (!entry.signal->broadcast_ring())
+            entry.signal->on_group_begin();
+
+    for (const auto& entry : _entries)
+        entry.signal->publish(
+            entry.domain_value,
+            entry.sample_count,
+            &entry.buffer,
+            1,
+            nullptr);
+
+    for (const auto& entry : _entries)
+        if (!entry.signal->broadcast_ring())
+            entry.signal->on_group_end();
+
+    _entries.clear();
+}
+
+void wss::publish_group::clear() noexcept
+{
+    _entries.clear();
+}
+
+bool wss::publish_group::empty() const noexcept
+{
+    return _entries.empty();
+}
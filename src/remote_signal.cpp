@@ -1,3 +1,6 @@
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
 
 #include <nlohmann/json.hpp>
@@ -24,6 +27,30 @@ const wss::metadata& wss::remote_signal::metadata() const noexcept
     return _metadata;
 }
 
+std::optional<std::int64_t> wss::remote_signal::domain_delta() const noexcept
+{
+    return _domain_delta;
+}
+
+bool wss::remote_signal::domain_values(
+    std::int64_t domain_value,
+    std::size_t sample_count,
+    std::int64_t *output) const noexcept
+{
+    if (!_domain_delta)
+        return false;
+
+    // Written as an induction so that the compiler can vectorize it; unsigned arithmetic
+    // gives the same wrap-around behavior as the domain signal's own counters.
+    std::uint64_t value = domain_value;
+    std::uint64_t delta = *_domain_delta;
+
+    for (std::size_t i = 0; i < sample_count; ++i, value += delta)
+        output[i] = static_cast<std::int64_t>(value);
+
+    return true;
+}
+
 wss::remote_signal::remote_signal(const std::string& id)
     : _id(id)
 {
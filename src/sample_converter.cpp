@@ -0,0 +1,164 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+
+#include <boost/endian/conversion.hpp>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/endianness.hpp>
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/sample_converter.hpp>
+#include <ws-streaming/detail/half_float.hpp>
+
+template <std::size_t Size> struct unsigned_of;
+template <> struct unsigned_of<1> { using type = std::uint8_t; };
+template <> struct unsigned_of<2> { using type = std::uint16_t; };
+template <> struct unsigned_of<4> { using type = std::uint32_t; };
+template <> struct unsigned_of<8> { using type = std::uint64_t; };
+
+// Half-precision samples are loaded as bit patterns and widened when they are used.
+struct half
+{
+    std::uint16_t bits;
+
+    operator float() const noexcept
+    {
+        return wss::detail::half_to_float(bits);
+    }
+};
+
+template <typename Raw, bool Swap>
+static inline Raw load(const std::uint8_t *data) noexcept
+{
+    Raw value;
+
+    if constexpr (Swap)
+    {
+        typename unsigned_of<sizeof(Raw)>::type bits;
+        std::memcpy(&bits, data, sizeof(bits));
+        bits = boost::endian::endian_reverse(bits);
+        std::memcpy(&value, &bits, sizeof(value));
+    }
+
+    else
+        std::memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+// Each combination of raw type, output type, byte order and scaling gets its own loop with no
+// branches in its body, so that the compiler is free to vectorize it.
+template <typename Raw, typename Output, bool Swap, bool Scale>
+static void convert_samples(
+    const void *data,
+    std::size_t sample_count,
+    Output *output,
+    double scale,
+    double offset) noexcept
+{
+    const auto *input = static_cast<const std::uint8_t *>(data);
+
+    for (std::size_t i = 0; i < sample_count; ++i)
+    {
+        Raw value = load<Raw, Swap>(input + i * sizeof(Raw));
+
+        if constexpr (Scale)
+            output[i] = static_cast<Output>(value * scale + offset);
+        else
+            output[i] = static_cast<Output>(value);
+    }
+}
+
+template <typename Raw, typename Output, bool Swap>
+static auto select_conversion(bool scale) noexcept
+{
+    return scale
+        ? &convert_samples<Raw, Output, Swap, true>
+        : &convert_samples<Raw, Output, Swap, false>;
+}
+
+template <typename Raw, typename ToDouble, typename ToFloat>
+static std::size_t select_conversions(
+    ToDouble& to_double,
+    ToFloat& to_float,
+    bool swap,
+    bool scale) noexcept
+{
+    to_double = swap
+        ? select_conversion<Raw, double, true>(scale)
+        : select_conversion<Raw, double, false>(scale);
+
+    to_float = swap
+        ? select_conversion<Raw, float, true>(scale)
+        : select_conversion<Raw, float, false>(scale);
+
+    return sizeof(Raw);
+}
+
+wss::sample_converter::sample_converter() noexcept
+{
+}
+
+wss::sample_converter::sample_converter(
+    const metadata& metadata,
+    bool apply_post_scaling)
+{
+    if (auto post_scaling = metadata.post_scaling(); apply_post_scaling && post_scaling)
+        std::tie(_scale, _offset) = *post_scaling;
+
+    bool scale = _scale != 1 || _offset != 0;
+
+    bool is_big_endian = metadata.endian() == endianness::big;
+    bool swap = is_big_endian != (boost::endian::order::native == boost::endian::order::big);
+
+    std::string type = metadata.data_type();
+
+    if (type == data_types::int8_t)
+        _sample_size = select_conversions<std::int8_t>(_to_double, _to_float, swap, scale);
+    else if (type == data_types::int16_t)
+        _sample_size = select_conversions<std::int16_t>(_to_double, _to_float, swap, scale);
+    else if (type == data_types::int32_t)
+        _sample_size = select_conversions<std::int32_t>(_to_double, _to_float, swap, scale);
+    else if (type == data_types::int64_t)
+        _sample_size = select_conversions<std::int64_t>(_to_double, _to_float, swap, scale);
+    else if (type == data_types::uint8_t)
+        _sample_size = select_conversions<std::uint8_t>(_to_double, _to_float, swap, scale);
+    else if (type == data_types::uint16_t)
+        _sample_size = select_conversions<std::uint16_t>(_to_double, _to_float, swap, scale);
+    else if (type == data_types::uint32_t)
+        _sample_size = select_conversions<std::uint32_t>(_to_double, _to_float, swap, scale);
+    else if (type == data_types::uint64_t)
+        _sample_size = select_conversions<std::uint64_t>(_to_double, _to_float, swap, scale);
+    else if (type == data_types::real16_t)
+        _sample_size = select_conversions<half>(_to_double, _to_float, swap, scale);
+    else if (type == data_types::real32_t)
+        _sample_size = select_conversions<float>(_to_double, _to_float, swap, scale);
+    else if (type == data_types::real64_t)
+        _sample_size = select_conversions<double>(_to_double, _to_float, swap, scale);
+}
+
+bool wss::sample_converter::convert(
+    const void *data,
+    std::size_t sample_count,
+    double *output) const noexcept
+{
+    if (!_to_double)
+        return false;
+
+    _to_double(data, sample_count, output, _scale, _offset);
+    return true;
+}
+
+bool wss::sample_converter::convert(
+    const void *data,
+    std::size_t sample_count,
+    float *output) const noexcept
+{
+    if (!_to_float)
+        return false;
+
+    _to_float(data, sample_count, output, _scale, _offset);
+    return true;
+}
@@ -1,11 +1,22 @@
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
 #include <functional>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
 #include <boost/system/error_code.hpp>
+#include <boost/system/system_error.hpp>
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+#include <sys/stat.h>
+#endif
 
 #include <nlohmann/json.hpp>
 
@@ -14,6 +25,7 @@
 #include <ws-streaming/server.hpp>
 #include <ws-streaming/detail/http_client_servicer.hpp>
 #include <ws-streaming/detail/streaming_protocol.hpp>
+#include <ws-streaming/detail/websocket_extensions.hpp>
 
 using namespace std::placeholders;
 
@@ -40,10 +52,79 @@ void wss::server::add_listener(
         listener,
         listener->on_accept.connect(
             std::bind(
-                &server::on_listener_accept,
+                &server::on_listener_accept<boost::asio::ip::tcp::socket>,
+                this,
+                _1)));
+}
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+// Removes a stale UNIX domain socket left behind by a process that exited without removing it.
+// Anything else at the path, including a socket another process is listening on, is left alone
+// and reported as an error.
+static void remove_stale_socket(const std::string& path)
+{
+    struct stat status;
+
+    if (::lstat(path.c_str(), &status) != 0)
+    {
+        if (errno == ENOENT)
+            return;
+
+        throw boost::system::system_error(
+            errno,
+            boost::system::system_category(),
+            "cannot inspect " + path);
+    }
+
+    if (!S_ISSOCK(status.st_mode))
+        throw boost::system::system_error(
+            EEXIST,
+            boost::system::system_category(),
+            path + " exists and is not a socket");
+
+    boost::asio::io_context context;
+    boost::asio::local::stream_protocol::socket socket{context};
+    boost::system::error_code ec;
+
+    socket.connect(boost::asio::local::stream_protocol::endpoint{path}, ec);
+    if (!ec)
+        throw boost::system::system_error(
+            EADDRINUSE,
+            boost::system::system_category(),
+            path + " is in use by another server");
+
+    // Only a refused connection proves that nobody is listening. Other errors, such as a lack
+    // of permission or a server too busy to accept, say nothing about the socket's owner.
+    if (ec != boost::asio::error::connection_refused)
+        throw boost::system::system_error(
+            ec,
+            "cannot determine whether " + path + " is in use");
+
+    std::remove(path.c_str());
+}
+
+void wss::server::add_local_listener(const std::string& path)
+{
+    remove_stale_socket(path);
+
+    add_listener(
+        std::make_shared<listener<boost::asio::local::stream_protocol>>(
+            _executor,
+            boost::asio::local::stream_protocol::endpoint(path)));
+}
+
+void wss::server::add_listener(
+    std::shared_ptr<listener<boost::asio::local::stream_protocol>> listener)
+{
+    _listeners.emplace_back(
+        listener,
+        listener->on_accept.connect(
+            std::bind(
+                &server::on_listener_accept<boost::asio::local::stream_protocol::socket>,
                 this,
                 _1)));
 }
+#endif
 
 void wss::server::add_default_listeners()
 {
@@ -55,7 +136,7 @@ void wss::server::run()
 {
     for (const auto& listener : _listeners)
     {
-        listener.l->run();
+        listener.run();
     }
 }
 
@@ -65,7 +146,7 @@ void wss::server::close()
         return;
 
     for (const auto& listener : _listeners)
-        listener.l->stop();
+        listener.stop();
     _listeners.clear();
 
     for (const auto& client : _clients)
@@ -99,17 +180,19 @@ void wss::server::remove_local_signal(local_signal& signal)
     }
 }
 
-void wss::server::on_listener_accept(
-    boost::asio::ip::tcp::socket& socket)
+template <typename Socket>
+void wss::server::on_listener_accept(Socket& socket)
 {
     if (!socket.is_open())
         return;
 
-    auto client = std::make_shared<detail::http_client_servicer>(std::move(socket));
+    auto client = std::make_shared<detail::http_client_servicer>(
+        boost::asio::generic::stream_protocol::socket{std::move(socket)},
+        _extensions);
     _sessions.emplace_back(
         client,
         client->on_command_interface_request.connect(std::bind(&server::on_servicer_command_interface_request, this, client, _1, _2)),
-        client->on_websocket_upgrade.connect(std::bind(&server::on_servicer_websocket_upgrade, this, client, _1)),
+        client->on_websocket_upgrade.connect(std::bind(&server::on_servicer_websocket_upgrade, this, client, _1, _2)),
         client->on_closed.connect(std::bind(&server::on_servicer_closed, this, client, _1)));
 
     client->run();
@@ -140,11 +223,15 @@ nlohmann::json wss::server::on_servicer_command_interface_request(
 
 void wss::server::on_servicer_websocket_upgrade(
     const std::shared_ptr<detail::http_client_servicer>& servicer,
-    boost::asio::ip::tcp::socket& socket)
+    boost::asio::generic::stream_protocol::socket& socket,
+    const detail::websocket_extensions& extensions)
 {
     auto connection = std::make_shared<wss::connection>(
         std::move(socket),
-        false);
+        false,
+        false,
+        extensions,
+        _deflate_pool);
 
     if (_command_interface_port)
         connection->register_external_command_interface(
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/struct_layout.hpp>
+#include <ws-streaming/detail/data_type_size.hpp>
+
+// extract_columns() transposes blocks of at most this many bytes at a time, so that the source
+// structures are still in the L1 cache when subsequent fields are gathered from them.
+static constexpr std::size_t EXTRACT_BLOCK_SIZE = 16384;
+
+template <std::size_t Size>
+static void gather(
+    const std::uint8_t *source,
+    std::size_t stride,
+    std::size_t count,
+    std::uint8_t *destination) noexcept
+{
+    // A fixed-size memcpy() compiles to a single unaligned load and store.
+    for (std::size_t i = 0; i < count; ++i, source += stride, destination += Size)
+        std::memcpy(destination, source, Size);
+}
+
+static void gather(
+    const std::uint8_t *source,
+    std::size_t stride,
+    std::size_t count,
+    std::uint8_t *destination,
+    std::size_t size) noexcept
+{
+    switch (size)
+    {
+        case 0: return;
+        case 1: return gather<1>(source, stride, count, destination);
+        case 2: return gather<2>(source, stride, count, destination);
+        case 4: return gather<4>(source, stride, count, destination);
+        case 8: return gather<8>(source, stride, count, destination);
+        case 16: return gather<16>(source, stride, count, destination);
+    }
+
+    for (std::size_t i = 0; i < count; ++i, source += stride, destination += size)
+        std::memcpy(destination, source, size);
+}
+
+wss::struct_layout::struct_layout()
+{
+}
+
+wss::struct_layout::struct_layout(const metadata& metadata)
+{
+    const auto& json = metadata.json();
+
+    if (!json.contains("definition")
+            || !json["definition"].is_object()
+            || json["definition"].value("dataType", "") != data_types::struct_t
+            || !json["definition"].contains("struct")
+            || !json["definition"]["struct"].is_array())
+        return;
+
+    for (const auto& field_json : json["definition"]["struct"])
+    {
+        if (!field_json.is_object())
+            continue;
+        if (!field_json.contains("dataType") || !field_json["dataType"].is_string())
+            continue;
+
+        field f;
+        f.name = field_json.value("name", "");
+        f.data_type = field_json["dataType"];
+        f.element_size = detail::data_type_size(f.data_type);
+        f.count = 1;
+        f.offset = _sample_size;
+
+        if (field_json.contains("dimensions")
+                && field_json["dimensions"].is_array()
+                && field_json["dimensions"].size() >= 1
+                && field_json["dimensions"][0].is_object()
+                && field_json["dimensions"][0].contains("linear")
+                && field_json["dimensions"][0]["linear"].is_object())
+        {
+            const auto& linear = field_json["dimensions"][0]["linear"];
+
+            if (linear.contains("size") && linear["size"].is_number_unsigned())
+                f.count = linear["size"];
+        }
+
+        f.size = f.element_size * f.count;
+        _sample_size += f.size;
+        _fields.push_back(std::move(f));
+    }
+}
+
+std::optional<std::size_t> wss::struct_layout::find(const std::string& name) const noexcept
+{
+    for (std::size_t i = 0; i < _fields.size(); ++i)
+        if (_fields[i].name == name)
+            return i;
+
+    return std::nullopt;
+}
+
+void wss::struct_layout::extract(
+    std::size_t field_index,
+    const void *samples,
+    std::size_t sample_count,
+    void *column) const noexcept
+{
+    const auto& f = _fields[field_index];
+
+    gather(
+        static_cast<const std::uint8_t *>(samples) + f.offset,
+        _sample_size,
+        sample_count,
+        static_cast<std::uint8_t *>(column),
+        f.size);
+}
+
+void wss::struct_layout::extract_columns(
+    const void *samples,
+    std::size_t sample_count,
+    void *const *columns) const noexcept
+{
+    if (!_sample_size)
+        return;
+
+    const std::uint8_t *source = static_cast<const std::uint8_t *>(samples);
+    std::size_t block = std::max<std::size_t>(1, EXTRACT_BLOCK_SIZE / _sample_size);
+
+    for (std::size_t done = 0; done < sample_count; done += block)
+    {
+        std::size_t count = std::min(block, sample_count - done);
+
+        for (std::size_t i = 0; i < _fields.size(); ++i)
+        {
+            if (!columns[i])
+                continue;
+
+            const auto& f = _fields[i];
+
+            gather(
+                source + done * _sample_size + f.offset,
+                _sample_size,
+                count,
+                static_cast<std::uint8_t *>(columns[i]) + done * f.size,
+                f.size);
+        }
+    }
+}
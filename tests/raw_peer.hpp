@@ -0,0 +1,231 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/endian/conversion.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <ws-streaming/detail/streaming_protocol.hpp>
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+/**
+ * Speaks the direct TCP protocol over a plain socket, so that tests can observe exactly which
+ * packets a connection transmits. Received packets are appended to the packets member.
+ */
+class raw_peer
+{
+    public:
+
+        struct packet
+        {
+            unsigned signo;
+            unsigned type;
+            std::vector<std::uint8_t> payload;
+        };
+
+        explicit raw_peer(boost::asio::local::stream_protocol::socket&& socket)
+            : _socket(std::move(socket))
+        {
+        }
+
+        void send_metadata(const std::string& method, const nlohmann::json& params)
+        {
+            auto payload = nlohmann::json::to_msgpack({ { "method", method }, { "params", params } });
+
+            std::vector<std::uint8_t> packet(
+                wss::detail::streaming_protocol::MAX_HEADER_SIZE + sizeof(std::uint32_t));
+            std::size_t header_size = wss::detail::streaming_protocol::generate_header<boost::endian::order::big>(
+                packet.data(),
+                0,
+                wss::detail::streaming_protocol::packet_type::METADATA,
+                sizeof(std::uint32_t) + payload.size());
+            boost::endian::endian_store<std::uint32_t, sizeof(std::uint32_t), boost::endian::order::big>(
+                packet.data() + header_size,
+                wss::detail::streaming_protocol::metadata_encoding::MSGPACK);
+            packet.resize(header_size + sizeof(std::uint32_t));
+            packet.insert(packet.end(), payload.begin(), payload.end());
+
+            boost::asio::write(_socket, boost::asio::buffer(packet));
+        }
+
+        /**
+         * Reads whatever has arrived and appends the complete packets it contains to packets.
+         */
+        void receive()
+        {
+            std::size_t available = _socket.available();
+            std::size_t old_size = _buffer.size();
+            _buffer.resize(old_size + available);
+            if (available)
+                _socket.read_some(boost::asio::buffer(_buffer.data() + old_size, available));
+
+            wss::detail::streaming_protocol::packet_descriptor descriptors[16];
+
+            while (true)
+            {
+                auto result = wss::detail::streaming_protocol::scan_packets<boost::endian::order::big>(
+                    _buffer.data(), _buffer.size(), descriptors, std::size(descriptors));
+
+                if (!result.packet_count)
+                    break;
+
+                for (std::size_t i = 0; i < result.packet_count; ++i)
+                    packets.push_back({
+                        descriptors[i].signo,
+                        descriptors[i].type,
+                        {
+                            _buffer.begin() + descriptors[i].offset,
+                            _buffer.begin() + descriptors[i].offset + descriptors[i].payload_size
+                        }
+                    });
+
+                _buffer.erase(_buffer.begin(), _buffer.begin() + result.bytes_scanned);
+            }
+        }
+
+        /**
+         * Runs @p ioc and receives packets until @p predicate returns true or @p timeout
+         * elapses.
+         *
+         * @return The last value returned by @p predicate.
+         */
+        template <typename Predicate>
+        bool run_until(
+            boost::asio::io_context& ioc,
+            Predicate&& predicate,
+            std::chrono::milliseconds timeout = std::chrono::seconds(5))
+        {
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+
+            do
+            {
+                ioc.run_for(std::chrono::milliseconds(1));
+                receive();
+
+                if (predicate())
+                    return true;
+            } while (std::chrono::steady_clock::now() < deadline);
+
+            return false;
+        }
+
+        /**
+         * Waits for the connection's greeting and answers it.
+         *
+         * @return The connection's stream ID, or an empty string if no greeting arrived.
+         */
+        std::string greet(boost::asio::io_context& ioc, const nlohmann::json& capabilities)
+        {
+            std::string stream_id;
+
+            run_until(ioc, [&]
+            {
+                for (const auto& packet : packets)
+                    if (packet.type == wss::detail::streaming_protocol::packet_type::METADATA)
+                        if (auto metadata = decode_metadata(packet); metadata["method"] == "init")
+                            stream_id = metadata["params"]["streamId"];
+                return !stream_id.empty();
+            });
+
+            send_metadata("apiVersion", { { "version", "2.0.0" } });
+            send_metadata("init", { { "streamId", "client" }, { "capabilities", capabilities } });
+
+            return stream_id;
+        }
+
+        /**
+         * Subscribes to signals through the in-band command interface and waits until the
+         * connection has announced each of them.
+         *
+         * @return The signal numbers of the subscribed signals, by signal ID.
+         */
+        std::map<std::string, unsigned> subscribe(
+            boost::asio::io_context& ioc,
+            const std::string& stream_id,
+            const std::vector<std::string>& signal_ids)
+        {
+            send_metadata("request", {
+                { "jsonrpc", "2.0" },
+                { "id", 1 },
+                { "method", stream_id + ".subscribe" },
+                { "params", signal_ids },
+            });
+
+            std::map<std::string, unsigned> signos;
+
+            run_until(ioc, [&]
+            {
+                for (const auto& packet : packets)
+                    if (packet.signo && packet.type == wss::detail::streaming_protocol::packet_type::METADATA)
+                        if (auto metadata = decode_metadata(packet); metadata["method"] == "subscribe")
+                            signos[metadata["params"]["signalId"]] = packet.signo;
+                return signos.size() == signal_ids.size();
+            });
+
+            return signos;
+        }
+
+        /**
+         * Sends a command interface request and waits for the connection's response.
+         *
+         * @return The params of the response, or null if no response arrived.
+         */
+        nlohmann::json request(
+            boost::asio::io_context& ioc,
+            const std::string& method,
+            const nlohmann::json& params)
+        {
+            unsigned id = ++_request_id;
+
+            send_metadata("request", {
+                { "jsonrpc", "2.0" },
+                { "id", id },
+                { "method", method },
+                { "params", params },
+            });
+
+            nlohmann::json response;
+
+            run_until(ioc, [&]
+            {
+                for (const auto& packet : packets)
+                    if (!packet.signo && packet.type == wss::detail::streaming_protocol::packet_type::METADATA)
+                        if (auto metadata = decode_metadata(packet); metadata["method"] == "response"
+                                && metadata["params"]["id"] == id)
+                            response = metadata["params"];
+                return !response.is_null();
+            });
+
+            return response;
+        }
+
+        static nlohmann::json decode_metadata(const packet& packet)
+        {
+            return nlohmann::json::from_msgpack(
+                packet.payload.begin() + sizeof(std::uint32_t),
+                packet.payload.end());
+        }
+
+        std::vector<packet> packets;
+
+    private:
+
+        boost::asio::local::stream_protocol::socket _socket;
+        std::vector<std::uint8_t> _buffer;
+        unsigned _request_id = 1;
+};
+
+#endif
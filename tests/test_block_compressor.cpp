@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/detail/block_compressor.hpp>
+
+using namespace testing;
+using namespace wss::detail;
+
+static std::vector<std::uint8_t> repetitive_data(std::size_t size)
+{
+    std::vector<std::uint8_t> data;
+    std::string text = "{\"method\":\"signal\",\"params\":{\"valueIndex\":";
+
+    for (std::size_t i = 0; data.size() < size; ++i)
+    {
+        std::string line = text + std::to_string(i) + "}}";
+        data.insert(data.end(), line.begin(), line.end());
+    }
+
+    data.resize(size);
+    return data;
+}
+
+static std::vector<std::uint8_t> random_data(std::size_t size)
+{
+    std::mt19937 generator{42};
+    std::vector<std::uint8_t> data(size);
+
+    for (auto& byte : data)
+        byte = static_cast<std::uint8_t>(generator());
+
+    return data;
+}
+
+TEST(BlockCompressorTest, RoundTrip)
+{
+    block_compressor compressor;
+    std::vector<std::uint8_t> compressed, decompressed;
+
+    for (std::size_t size : { std::size_t{1000}, std::size_t{4096}, std::size_t{65536 + 1000}, block_compressor::MAX_BLOCK_SIZE })
+    {
+        auto data = repetitive_data(size);
+
+        ASSERT_TRUE(compressor.compress(data.data(), data.size(), compressed));
+        EXPECT_LT(compressed.size(), data.size() / 2);
+
+        ASSERT_TRUE(block_compressor::decompress(compressed.data(), compressed.size(), decompressed));
+        EXPECT_EQ(decompressed, data);
+    }
+}
+
+TEST(BlockCompressorTest, OverlappingMatches)
+{
+    block_compressor compressor;
+    std::vector<std::uint8_t> compressed, decompressed;
+    std::vector<std::uint8_t> data(10000, 0xAA);
+
+    ASSERT_TRUE(compressor.compress(data.data(), data.size(), compressed));
+    EXPECT_LT(compressed.size(), 100);
+
+    ASSERT_TRUE(block_compressor::decompress(compressed.data(), compressed.size(), decompressed));
+    EXPECT_EQ(decompressed, data);
+}
+
+TEST(BlockCompressorTest, Backoff)
+{
+    block_compressor compressor;
+    std::vector<std::uint8_t> output;
+    auto incompressible = random_data(4096);
+    auto compressible = repetitive_data(4096);
+
+    // Each failed attempt doubles the number of blocks skipped before the next one.
+    EXPECT_FALSE(compressor.compress(incompressible.data(), incompressible.size(), output));
+    EXPECT_FALSE(compressor.compress(compressible.data(), compressible.size(), output));
+    EXPECT_TRUE(output.empty());
+
+    EXPECT_FALSE(compressor.compress(incompressible.data(), incompressible.size(), output));
+    EXPECT_FALSE(compressor.compress(compressible.data(), compressible.size(), output));
+    EXPECT_FALSE(compressor.compress(compressible.data(), compressible.size(), output));
+
+    EXPECT_TRUE(compressor.compress(compressible.data(), compressible.size(), output));
+}
+
+TEST(BlockCompressorTest, Malformed)
+{
+    block_compressor compressor;
+    std::vector<std::uint8_t> compressed, decompressed;
+    auto data = repetitive_data(4096);
+
+    ASSERT_TRUE(compressor.compress(data.data(), data.size(), compressed));
+
+    // Truncated blocks.
+    for (std::size_t size : { std::size_t{0}, std::size_t{3}, std::size_t{4}, compressed.size() - 1 })
+        EXPECT_FALSE(block_compressor::decompress(compressed.data(), size, decompressed));
+
+    // A block whose declared size does not match its contents.
+    auto wrong_size = compressed;
+    ++wrong_size[0];
+    EXPECT_FALSE(block_compressor::decompress(wrong_size.data(), wrong_size.size(), decompressed));
+
+    // A block larger than the maximum size.
+    std::vector<std::uint8_t> too_large = { 0x01, 0x00, 0x04, 0x00, 0x00 };
+    EXPECT_FALSE(block_compressor::decompress(too_large.data(), too_large.size(), decompressed));
+
+    // A match that refers to data before the start of the block.
+    std::vector<std::uint8_t> bad_offset = { 0x08, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00 };
+    EXPECT_FALSE(block_compressor::decompress(bad_offset.data(), bad_offset.size(), decompressed));
+}
@@ -0,0 +1,114 @@
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/detail/broadcast_ring.hpp>
+
+using namespace testing;
+using namespace wss::detail;
+
+static void append(broadcast_ring& ring, std::int64_t domain_value, std::size_t size)
+{
+    std::vector<std::uint8_t> data(size);
+    std::iota(data.begin(), data.end(), static_cast<std::uint8_t>(domain_value));
+
+    boost::asio::const_buffer buffer{data.data(), data.size()};
+    ASSERT_TRUE(ring.append(domain_value, size, &buffer, 1));
+}
+
+static void expect_record(
+    broadcast_ring& ring,
+    std::uint64_t& cursor,
+    std::int64_t domain_value,
+    std::size_t size)
+{
+    broadcast_ring::record_header header;
+    std::vector<std::uint8_t> data;
+
+    ASSERT_EQ(ring.read(cursor, header, data), broadcast_ring::read_result::record);
+    EXPECT_EQ(header.domain_value, domain_value);
+    EXPECT_EQ(header.sample_count, size);
+    ASSERT_EQ(data.size(), size);
+
+    for (std::size_t i = 0; i < size; ++i)
+        EXPECT_EQ(data[i], static_cast<std::uint8_t>(domain_value + i));
+}
+
+TEST(BroadcastRingTest, ConsumersReadIndependently)
+{
+    broadcast_ring ring{1024};
+    std::uint64_t early = ring.head();
+
+    append(ring, 1, 10);
+    std::uint64_t late = ring.head();
+    append(ring, 2, 20);
+
+    expect_record(ring, early, 1, 10);
+    expect_record(ring, early, 2, 20);
+    expect_record(ring, late, 2, 20);
+
+    broadcast_ring::record_header header;
+    std::vector<std::uint8_t> data;
+    EXPECT_EQ(ring.read(early, header, data), broadcast_ring::read_result::empty);
+    EXPECT_EQ(ring.read(late, header, data), broadcast_ring::read_result::empty);
+}
+
+TEST(BroadcastRingTest, RecordsWrapAround)
+{
+    broadcast_ring ring{256};
+    std::uint64_t cursor = ring.head();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        append(ring, i, 50 + i % 30);
+        expect_record(ring, cursor, i, 50 + i % 30);
+    }
+}
+
+TEST(BroadcastRingTest, SampleIndexAccumulates)
+{
+    broadcast_ring ring{1024};
+    std::uint64_t cursor = ring.head();
+
+    append(ring, 0, 3);
+    append(ring, 0, 5);
+
+    broadcast_ring::record_header header;
+    std::vector<std::uint8_t> data;
+    ring.read(cursor, header, data);
+    EXPECT_EQ(header.sample_index, 0);
+    ring.read(cursor, header, data);
+    EXPECT_EQ(header.sample_index, 3);
+}
+
+TEST(BroadcastRingTest, DetectsOverrun)
+{
+    broadcast_ring ring{256};
+    std::uint64_t cursor = ring.head();
+
+    for (int i = 0; i < 10; ++i)
+        append(ring, i, 50);
+
+    broadcast_ring::record_header header;
+    std::vector<std::uint8_t> data;
+    EXPECT_EQ(ring.read(cursor, header, data), broadcast_ring::read_result::overrun);
+    EXPECT_EQ(cursor, ring.head());
+
+    // After resynchronizing, new records are read normally.
+    append(ring, 42, 50);
+    expect_record(ring, cursor, 42, 50);
+}
+
+TEST(BroadcastRingTest, RejectsOversizedRecords)
+{
+    broadcast_ring ring{256};
+    std::vector<std::uint8_t> data(256);
+    boost::asio::const_buffer buffer{data.data(), data.size()};
+
+    EXPECT_FALSE(ring.append(0, 0, &buffer, 1));
+}
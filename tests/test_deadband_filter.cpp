@@ -0,0 +1,106 @@
+#include <chrono>
+#include <cstdint>
+
+#include <boost/asio/buffer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/detail/deadband_filter.hpp>
+
+using namespace std::chrono_literals;
+using namespace testing;
+using namespace wss::detail;
+
+static const wss::metadata int16_metadata{
+    wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::int16_t)
+        .build()};
+
+static bool admit(deadband_filter& filter, std::int16_t value, std::chrono::steady_clock::time_point now = { })
+{
+    boost::asio::const_buffer buffer{&value, sizeof(value)};
+    return filter.admit(&buffer, 1, now);
+}
+
+TEST(DeadbandFilterTest, Absolute)
+{
+    deadband_filter filter{int16_metadata, 2, 0, { }};
+
+    EXPECT_TRUE(admit(filter, 100));
+    EXPECT_FALSE(admit(filter, 102));
+    EXPECT_FALSE(admit(filter, 98));
+    EXPECT_TRUE(admit(filter, 103));
+
+    // The reference is the most recently transmitted sample.
+    EXPECT_FALSE(admit(filter, 101));
+    EXPECT_TRUE(admit(filter, 100));
+}
+
+TEST(DeadbandFilterTest, RawValuesOfPostScaledSignal)
+{
+    // The band applies to raw values; post-scaled, each step here would be 100 units wide.
+    deadband_filter filter{
+        wss::metadata{wss::metadata_builder{"Value"}
+            .data_type(wss::data_types::int16_t)
+            .post_scaling(100, 5000)
+            .build()},
+        2, 0, { }};
+
+    EXPECT_TRUE(admit(filter, 100));
+    EXPECT_FALSE(admit(filter, 102));
+    EXPECT_TRUE(admit(filter, 103));
+
+    filter.update(wss::metadata{wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::int16_t)
+        .post_scaling(0.001, 0)
+        .build()});
+
+    EXPECT_TRUE(admit(filter, 103));
+    EXPECT_FALSE(admit(filter, 105));
+    EXPECT_TRUE(admit(filter, 106));
+}
+
+TEST(DeadbandFilterTest, Relative)
+{
+    deadband_filter filter{int16_metadata, 0, 0.1, { }};
+
+    EXPECT_TRUE(admit(filter, 1000));
+    EXPECT_FALSE(admit(filter, 1100));
+    EXPECT_TRUE(admit(filter, 1101));
+    EXPECT_FALSE(admit(filter, 1000));
+}
+
+TEST(DeadbandFilterTest, Heartbeat)
+{
+    deadband_filter filter{int16_metadata, 10, 0, 1s};
+    std::chrono::steady_clock::time_point start{ };
+
+    EXPECT_TRUE(admit(filter, 0, start));
+    EXPECT_FALSE(admit(filter, 0, start + 999ms));
+    EXPECT_TRUE(admit(filter, 0, start + 1s));
+    EXPECT_FALSE(admit(filter, 0, start + 1500ms));
+}
+
+TEST(DeadbandFilterTest, BlocksAndSplitSamples)
+{
+    deadband_filter filter{int16_metadata, 5, 0, { }};
+
+    std::int16_t block[] = { 0, 1, 2 };
+    boost::asio::const_buffer whole{block, sizeof(block)};
+    EXPECT_TRUE(filter.admit(&whole, 1, { }));
+
+    // A sample split across buffers is reassembled; any sample outside the deadband causes
+    // the whole block to be transmitted, and the last sample becomes the reference.
+    std::int16_t changed[] = { 3, 9, 12 };
+    const auto *bytes = reinterpret_cast<const std::uint8_t *>(changed);
+    boost::asio::const_buffer split[] = { { bytes, 3 }, { bytes + 3, 3 } };
+    EXPECT_TRUE(filter.admit(split, 2, { }));
+    EXPECT_FALSE(admit(filter, 8));
+
+    // Updating the metadata causes the next block to be transmitted.
+    filter.update(int16_metadata);
+    EXPECT_TRUE(admit(filter, 12));
+}
@@ -0,0 +1,197 @@
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/connection.hpp>
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/transport_formats.hpp>
+#include <ws-streaming/detail/reduced_signal.hpp>
+#include <ws-streaming/detail/streaming_protocol.hpp>
+
+#include "raw_peer.hpp"
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+using namespace testing;
+
+class DerivedSignalTest : public Test
+{
+    protected:
+
+        void start(std::int64_t delta)
+        {
+            boost::asio::local::stream_protocol::socket server_socket{ioc};
+            boost::asio::local::stream_protocol::socket client_socket{ioc};
+            boost::asio::local::connect_pair(server_socket, client_socket);
+
+            time = std::make_unique<wss::local_signal>("/Time", wss::metadata_builder{"Time"}
+                .data_type(wss::data_types::int64_t)
+                .linear_rule(0, delta)
+                .tick_resolution(1, 1000)
+                .table("/Time")
+                .build());
+            value = std::make_unique<wss::local_signal>("/Value", wss::metadata_builder{"Value"}
+                .data_type(wss::data_types::real64_t)
+                .table("/Time")
+                .build());
+
+            connection = std::make_shared<wss::connection>(std::move(server_socket), false, true);
+            connection->add_local_signal(*time);
+            connection->add_local_signal(*value);
+            connection->run();
+
+            client = std::make_unique<raw_peer>(std::move(client_socket));
+            stream_id = client->greet(ioc, nlohmann::json::array());
+            ASSERT_FALSE(stream_id.empty());
+        }
+
+        void TearDown() override
+        {
+            if (connection)
+                connection->close();
+            ioc.run_for(std::chrono::milliseconds(10));
+        }
+
+        nlohmann::json subscribe(const nlohmann::json& params)
+        {
+            return client->request(ioc, stream_id + ".subscribe", params);
+        }
+
+        nlohmann::json unsubscribe(const nlohmann::json& params)
+        {
+            return client->request(ioc, stream_id + ".unsubscribe", params);
+        }
+
+        std::vector<std::string> unavailable_signal_ids()
+        {
+            std::vector<std::string> ids;
+
+            for (const auto& packet : client->packets)
+                if (!packet.signo && packet.type == wss::detail::streaming_protocol::packet_type::METADATA)
+                    if (auto metadata = raw_peer::decode_metadata(packet); metadata["method"] == "unavailable")
+                        for (const auto& id : metadata["params"]["signalIds"])
+                            ids.push_back(id);
+
+            return ids;
+        }
+
+        boost::asio::io_context ioc;
+        std::unique_ptr<wss::local_signal> time;
+        std::unique_ptr<wss::local_signal> value;
+        std::shared_ptr<wss::connection> connection;
+        std::unique_ptr<raw_peer> client;
+        std::string stream_id;
+};
+
+TEST_F(DerivedSignalTest, RejectsExcessiveDecimation)
+{
+    start(10);
+
+    auto response = subscribe({ { "signalId", "/Value" }, { "decimation", 1000001 } });
+    EXPECT_TRUE(response.contains("error"));
+
+    response = subscribe({ { "signalId", "/Value" }, { "decimation", 1000000 } });
+    EXPECT_EQ(response["result"], "/Value/Decimated/1000000");
+}
+
+TEST_F(DerivedSignalTest, RejectsOverflowingDomainDelta)
+{
+    start(std::numeric_limits<std::int64_t>::max() / 2);
+
+    auto response = subscribe({ { "signalId", "/Value" }, { "decimation", 3 } });
+    EXPECT_TRUE(response.contains("error"));
+
+    response = subscribe({ { "signalId", "/Value" }, { "decimation", 2 } });
+    EXPECT_EQ(response["result"], "/Value/Decimated/2");
+}
+
+TEST_F(DerivedSignalTest, DecimationFromTargetRate)
+{
+    // Millisecond ticks with a delta of 10 make a 100 Hz signal.
+    start(10);
+
+    EXPECT_EQ(subscribe({ { "signalId", "/Value" }, { "targetRate", 10 } })["result"], "/Value/Decimated/10");
+    EXPECT_EQ(subscribe({ { "signalId", "/Value" }, { "targetRate", 1000 } })["result"], "/Value/Decimated/1");
+    EXPECT_EQ(subscribe({ { "signalId", "/Value" }, { "targetRate", 1e-4 } })["result"], "/Value/Decimated/1000000");
+
+    // Target rates requiring more than the maximum decimation are rejected, however small.
+    EXPECT_TRUE(subscribe({ { "signalId", "/Value" }, { "targetRate", 5e-5 } }).contains("error"));
+    EXPECT_TRUE(subscribe({ { "signalId", "/Value" }, { "targetRate", 1e-300 } }).contains("error"));
+}
+
+TEST_F(DerivedSignalTest, RemovesDecimatedSignalOnUnsubscribe)
+{
+    start(10);
+
+    EXPECT_EQ(subscribe({ { "signalId", "/Value" }, { "decimation", 10 } })["result"], "/Value/Decimated/10");
+    EXPECT_EQ(subscribe({ { "signalId", "/Value" }, { "decimation", 20 } })["result"], "/Value/Decimated/20");
+
+    // The decimated domain is removed with the last decimated signal using it.
+    EXPECT_EQ(unsubscribe("/Value/Decimated/10")["result"], true);
+    EXPECT_EQ(unavailable_signal_ids(), (std::vector<std::string>{
+        "/Value/Decimated/10",
+        "/Time/Decimated/10",
+    }));
+
+    client->packets.clear();
+    EXPECT_EQ(unsubscribe(nlohmann::json::array({ "/Value/Decimated/20" }))["result"], nlohmann::json::array({ true }));
+    EXPECT_EQ(unavailable_signal_ids(), (std::vector<std::string>{
+        "/Value/Decimated/20",
+        "/Time/Decimated/20",
+    }));
+
+    // A removed signal can be created again.
+    EXPECT_EQ(subscribe({ { "signalId", "/Value" }, { "decimation", 10 } })["result"], "/Value/Decimated/10");
+}
+
+TEST_F(DerivedSignalTest, RemovesReducedSignalOnUnsubscribe)
+{
+    start(10);
+
+    auto response = subscribe({ { "signalId", "/Value" }, { "format", wss::transport_formats::real32 } });
+    ASSERT_EQ(response["result"], "/Value/Reduced/real32");
+
+    // The connection held the only reference to the shared reduced signal.
+    std::weak_ptr<wss::detail::reduced_signal> reduced
+        = wss::detail::reduced_signal::get(*value, wss::transport_formats::real32);
+    EXPECT_FALSE(reduced.expired());
+
+    EXPECT_EQ(unsubscribe("/Value/Reduced/real32")["result"], true);
+    EXPECT_EQ(unavailable_signal_ids(), (std::vector<std::string>{ "/Value/Reduced/real32" }));
+    EXPECT_TRUE(reduced.expired());
+}
+
+TEST(ReducedSignalTest, SharedOnlyForSameSource)
+{
+    auto metadata = wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::real64_t)
+        .build();
+
+    wss::local_signal first{"/Value", metadata};
+    wss::local_signal second{"/Value", metadata};
+
+    auto reduced = wss::detail::reduced_signal::get(first, wss::transport_formats::real32);
+    ASSERT_TRUE(reduced);
+    EXPECT_EQ(wss::detail::reduced_signal::get(first, wss::transport_formats::real32), reduced);
+
+    // Another signal with the same ID gets its own reduced signal.
+    auto other = wss::detail::reduced_signal::get(second, wss::transport_formats::real32);
+    ASSERT_TRUE(other);
+    EXPECT_NE(other, reduced);
+    EXPECT_EQ(&other->source(), &second);
+}
+
+#endif
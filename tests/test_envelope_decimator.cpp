@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/detail/envelope_decimator.hpp>
+
+using namespace testing;
+using namespace wss::detail;
+
+TEST(EnvelopeDecimatorTest, WindowsSpanBlocks)
+{
+    std::vector<double> values;
+    for (int i = 0; i < 100; ++i)
+        values.push_back((i * 37) % 101 - 50.5);
+
+    // Decimate the whole stream at once, and again split into irregular blocks.
+    envelope_decimator whole{10};
+    std::vector<envelope_decimator::envelope> expected;
+    EXPECT_EQ(whole.process(values.data(), values.size(), 1000, 5, expected), 1000);
+    ASSERT_EQ(expected.size(), 10);
+
+    envelope_decimator split{10};
+    std::vector<envelope_decimator::envelope> actual;
+    EXPECT_EQ(split.process(values.data(), 7, 1000, 5, actual), 0);
+    EXPECT_TRUE(actual.empty());
+    EXPECT_EQ(split.process(values.data() + 7, 31, 1035, 5, actual), 1000);
+    EXPECT_EQ(actual.size(), 3);
+    EXPECT_EQ(split.process(values.data() + 38, 62, 1190, 5, actual), 1150);
+    ASSERT_EQ(actual.size(), 10);
+
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        double min = values[i * 10], max = values[i * 10], sum = 0;
+        for (std::size_t j = i * 10; j < i * 10 + 10; ++j)
+        {
+            min = std::min(min, values[j]);
+            max = std::max(max, values[j]);
+            sum += values[j];
+        }
+
+        EXPECT_EQ(expected[i].min, min);
+        EXPECT_EQ(expected[i].max, max);
+        EXPECT_DOUBLE_EQ(expected[i].mean, sum / 10);
+
+        EXPECT_EQ(actual[i].min, expected[i].min);
+        EXPECT_EQ(actual[i].max, expected[i].max);
+        EXPECT_DOUBLE_EQ(actual[i].mean, expected[i].mean);
+    }
+}
+
+TEST(EnvelopeDecimatorTest, Reset)
+{
+    double values[] = { 1, 2, 3, 4, 5 };
+
+    envelope_decimator decimator{4};
+    std::vector<envelope_decimator::envelope> output;
+    decimator.process(values, 3, 0, 1, output);
+    decimator.reset();
+    EXPECT_EQ(decimator.process(values + 1, 4, 1, 1, output), 1);
+
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_EQ(output[0].min, 2);
+    EXPECT_EQ(output[0].max, 5);
+    EXPECT_EQ(output[0].mean, 3.5);
+}
@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <limits>
+#include <random>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/fixed_point_time.hpp>
+
+using namespace testing;
+using wss::fixed_point_time;
+
+TEST(FixedPointTimeTest, Arithmetic)
+{
+    fixed_point_time a{1, std::uint64_t{3} << 62};
+    fixed_point_time b{2, std::uint64_t{1} << 63};
+
+    EXPECT_EQ(a + b, (fixed_point_time{4, std::uint64_t{1} << 62}));
+    EXPECT_EQ((a + b) - b, a);
+    EXPECT_LT(a, b);
+    EXPECT_EQ(fixed_point_time::from_ntp(5, 0x80000000u), (fixed_point_time{5, std::uint64_t{1} << 63}));
+}
+
+TEST(FixedPointTimeTest, ToTicks)
+{
+    fixed_point_time t{2, std::uint64_t{1} << 63};
+
+    EXPECT_EQ(t.to_ticks(1, 1000000000), 2500000000);
+    EXPECT_EQ(t.to_ticks(1, 1000), 2500);
+    EXPECT_EQ(t.to_ticks(1, 1, 2), 1);
+    EXPECT_EQ(t.to_ticks_rounded(1, 1, 2), 1);
+    EXPECT_EQ(t.to_ticks(1, 1), 2);
+    EXPECT_EQ(t.to_ticks_rounded(1, 1), 3);
+    EXPECT_EQ(t.to_ticks(2, 1), 1);
+
+    EXPECT_EQ(t.to_ticks(0, 1), 0);
+    EXPECT_EQ(t.to_ticks(1, 1, 0), 0);
+    EXPECT_EQ(
+        fixed_point_time(std::numeric_limits<std::uint64_t>::max()).to_ticks(1, 1000),
+        std::numeric_limits<std::uint64_t>::max());
+}
+
+TEST(FixedPointTimeTest, FromTicks)
+{
+    EXPECT_EQ(fixed_point_time::from_ticks(2500, 1, 1000), (fixed_point_time{2, std::uint64_t{1} << 63}));
+    EXPECT_EQ(fixed_point_time::from_ticks(2500, 1, 0), fixed_point_time{});
+
+    auto t = fixed_point_time::from_ticks(123456789, 1, 1000000000);
+    EXPECT_EQ(t.seconds(), 0);
+    EXPECT_EQ(t.to_ticks_rounded(1, 1000000000), 123456789);
+}
+
+TEST(FixedPointTimeTest, SignalRateRounding)
+{
+    // A 1 kHz sample interval expressed as a direct TCP protocol delta: 1/1000 seconds, which is
+    // slightly less than 1 ms after truncation to 2^-64 seconds.
+    fixed_point_time delta{0, 18446744073709551ull};
+
+    EXPECT_EQ(delta.to_ticks(1, 1000000000), 999999);
+    EXPECT_EQ(delta.to_ticks_rounded(1, 1000000000), 1000000);
+
+    // The same interval spanning 100 samples.
+    EXPECT_EQ(fixed_point_time(0, 1844674407370955161ull).to_ticks_rounded(1, 1000000000, 100), 1000000);
+}
+
+TEST(FixedPointTimeTest, MatchesRationalArithmetic)
+{
+    using boost::multiprecision::cpp_int;
+    using boost::multiprecision::cpp_rational;
+
+    std::mt19937 random;
+    std::uniform_int_distribution<std::uint32_t> distribution;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::uint32_t seconds = distribution(random);
+        std::uint32_t fraction = distribution(random);
+
+        cpp_rational expected{(cpp_int{seconds} << 32) + fraction, cpp_int{1} << 32};
+        expected *= 1000000000;
+
+        EXPECT_EQ(
+            fixed_point_time::from_ntp(seconds, fraction).to_ticks(1, 1000000000),
+            static_cast<std::uint64_t>(expected));
+    }
+}
@@ -0,0 +1,220 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/connection.hpp>
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/detail/last_value_cache.hpp>
+#include <ws-streaming/detail/streaming_protocol.hpp>
+
+#include "raw_peer.hpp"
+
+using namespace testing;
+using namespace wss::detail;
+
+TEST(LastValueCacheTest, Disabled)
+{
+    last_value_cache cache;
+
+    std::int32_t value = 42;
+    boost::asio::const_buffer buffer{&value, sizeof(value)};
+    cache.store(1, 0, 1, &buffer, 1, nullptr);
+
+    EXPECT_FALSE(cache.enabled());
+    EXPECT_FALSE(cache.load());
+}
+
+TEST(LastValueCacheTest, CopiesGatheredBlocks)
+{
+    last_value_cache cache;
+    cache.enable(true);
+    EXPECT_FALSE(cache.load());
+
+    std::int32_t values[] = { 1, 2, 3 };
+    std::int32_t expected[] = { 1, 2, 3 };
+    boost::asio::const_buffer buffers[] = {
+        { &values[0], sizeof(std::int32_t) },
+        { &values[1], 2 * sizeof(std::int32_t) },
+    };
+    cache.store(1, 1000, 3, buffers, 2, nullptr);
+    values[0] = 99;
+
+    auto block = cache.load();
+    ASSERT_TRUE(block);
+    EXPECT_EQ(block->sequence, 1);
+    EXPECT_EQ(block->domain_value, 1000);
+    EXPECT_EQ(block->sample_count, 3);
+    ASSERT_EQ(block->size, sizeof(values));
+    EXPECT_EQ(std::memcmp(block->data.get(), expected, sizeof(values)), 0);
+
+    // A block still referenced by an endpoint is not overwritten by the next one.
+    std::int32_t next = 4;
+    boost::asio::const_buffer buffer{&next, sizeof(next)};
+    cache.store(2, 2000, 1, &buffer, 1, nullptr);
+
+    EXPECT_EQ(static_cast<const std::int32_t *>(block->data.get())[0], 1);
+    EXPECT_EQ(static_cast<const std::int32_t *>(cache.load()->data.get())[0], 4);
+
+    cache.enable(false);
+    EXPECT_FALSE(cache.load());
+}
+
+TEST(LastValueCacheTest, ReferencesOwnedBlocks)
+{
+    last_value_cache cache;
+    cache.enable(true);
+
+    auto owner = std::make_shared<std::int32_t>(7);
+    boost::asio::const_buffer buffer{owner.get(), sizeof(std::int32_t)};
+    cache.store(1, 0, 0, &buffer, 1, owner);
+
+    EXPECT_EQ(cache.load()->data.get(), owner.get());
+    EXPECT_EQ(owner.use_count(), 2);
+}
+
+TEST(LastValueCacheTest, LocalSignal)
+{
+    wss::local_signal signal{"/Value", wss::metadata_builder{"Value"}.build()};
+
+    std::int32_t value = 5;
+    signal.publish_data(&value, sizeof(value));
+    EXPECT_FALSE(signal.last_value());
+
+    signal.set_last_value_cache(true);
+    signal.publish_data(100, 1, &value, sizeof(value));
+
+    auto block = signal.last_value();
+    ASSERT_TRUE(block);
+    EXPECT_EQ(block->domain_value, 100);
+    EXPECT_EQ(*static_cast<const std::int32_t *>(block->data.get()), 5);
+}
+
+TEST(LastValueCacheTest, HandlersMayUseCache)
+{
+    wss::local_signal signal{"/Value", wss::metadata_builder{"Value"}.build()};
+    signal.set_last_value_cache(true);
+
+    // Handlers run without the cache locked, so they may use it, and they see the published
+    // block's sequence number on the signal and on the cached block alike.
+    std::vector<std::uint64_t> sequences;
+    signal.on_data_published.connect(
+        [&](
+            std::int64_t,
+            std::size_t,
+            const boost::asio::const_buffer *,
+            std::size_t,
+            const std::shared_ptr<const void>&)
+        {
+            auto last = signal.last_value();
+            ASSERT_TRUE(last);
+            EXPECT_EQ(last->sequence, signal.publish_sequence());
+            sequences.push_back(last->sequence);
+        });
+
+    std::int32_t value = 1;
+    signal.publish_data(&value, sizeof(value));
+    signal.publish_data(&value, sizeof(value));
+
+    std::vector<std::uint64_t> expected{ 1, 2 };
+    EXPECT_EQ(sequences, expected);
+
+    signal.on_data_published.disconnect_all_slots();
+    signal.on_data_published.connect(
+        [&](
+            std::int64_t,
+            std::size_t,
+            const boost::asio::const_buffer *,
+            std::size_t,
+            const std::shared_ptr<const void>&)
+        {
+            signal.set_last_value_cache(false);
+        });
+
+    signal.publish_data(&value, sizeof(value));
+    EXPECT_FALSE(signal.last_value());
+}
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+TEST(LastValueCacheTest, ConnectionTransmitsCachedBlockOnSubscribe)
+{
+    boost::asio::io_context ioc;
+    boost::asio::local::stream_protocol::socket server_socket{ioc};
+    boost::asio::local::stream_protocol::socket client_socket{ioc};
+    boost::asio::local::connect_pair(server_socket, client_socket);
+
+    wss::local_signal signal{"/Value", wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::int32_t).build()};
+    signal.set_last_value_cache(true);
+
+    std::int32_t value = 5;
+    signal.publish_data(&value, sizeof(value));
+
+    auto connection = std::make_shared<wss::connection>(std::move(server_socket), false, true);
+    connection->add_local_signal(signal);
+    connection->run();
+
+    raw_peer client{std::move(client_socket)};
+    std::string stream_id = client.greet(ioc, nlohmann::json::array());
+    ASSERT_FALSE(stream_id.empty());
+
+    auto signos = client.subscribe(ioc, stream_id, { "/Value" });
+    ASSERT_EQ(signos.size(), 1);
+    unsigned signo = signos["/Value"];
+
+    auto data_packets = [&]
+    {
+        std::vector<std::int32_t> values;
+        for (const auto& packet : client.packets)
+            if (packet.signo == signo
+                    && packet.type == wss::detail::streaming_protocol::packet_type::DATA)
+            {
+                EXPECT_EQ(packet.payload.size(), sizeof(std::int32_t));
+                std::int32_t received;
+                std::memcpy(&received, packet.payload.data(), sizeof(received));
+                values.push_back(received);
+            }
+        return values;
+    };
+
+    ASSERT_TRUE(client.run_until(ioc, [&] { return !data_packets().empty(); }));
+
+    // The cached block immediately follows the signal's metadata.
+    std::vector<std::string> sequence;
+    for (const auto& packet : client.packets)
+        if (packet.signo == signo)
+            sequence.push_back(packet.type == wss::detail::streaming_protocol::packet_type::METADATA
+                ? raw_peer::decode_metadata(packet)["method"].get<std::string>()
+                : "data");
+
+    std::vector<std::string> expected_sequence{ "subscribe", "signal", "data" };
+    EXPECT_EQ(sequence, expected_sequence);
+
+    // Later blocks are transmitted live, after the cached one, and the cached one only once.
+    value = 6;
+    signal.publish_data(&value, sizeof(value));
+    client.run_until(ioc, [&] { return data_packets().size() >= 2; });
+    client.run_until(ioc, [] { return false; }, std::chrono::milliseconds(10));
+
+    std::vector<std::int32_t> expected_values{ 5, 6 };
+    EXPECT_EQ(data_packets(), expected_values);
+
+    connection->close();
+    ioc.run_for(std::chrono::milliseconds(10));
+}
+
+#endif
@@ -0,0 +1,146 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/client.hpp>
+#include <ws-streaming/connection.hpp>
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/remote_signal.hpp>
+#include <ws-streaming/server.hpp>
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+#include <unistd.h>
+
+using namespace testing;
+
+class LocalListenerTest : public Test
+{
+    protected:
+
+        void SetUp() override
+        {
+            path = (std::filesystem::temp_directory_path()
+                / ("wss-test-" + std::to_string(::getpid()) + ".sock")).string();
+            std::filesystem::remove(path);
+        }
+
+        void TearDown() override
+        {
+            std::filesystem::remove(path);
+        }
+
+        std::string path;
+};
+
+TEST_F(LocalListenerTest, ConnectsAndStreams)
+{
+    boost::asio::io_context ioc;
+
+    wss::local_signal signal{"/Value", wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::real64_t)
+        .build()};
+
+    wss::server server{ioc.get_executor()};
+    server.add_local_listener(path);
+    server.add_local_signal(signal);
+    server.run();
+
+    signal.on_subscribed.connect([&]
+    {
+        boost::asio::post(ioc, [&]
+        {
+            double values[] = { 1, 2, 3 };
+            signal.publish_data(values, sizeof(values));
+        });
+    });
+
+    wss::client client{ioc.get_executor()};
+    wss::connection_ptr connection;
+    std::size_t received = 0;
+
+    client.async_connect(
+        std::string{wss::client::unix_scheme_prefix} + path,
+        [&](const boost::system::error_code& ec, wss::connection_ptr c)
+        {
+            ASSERT_FALSE(ec) << ec.message();
+            connection = c;
+
+            connection->on_available.connect([&](wss::remote_signal_ptr remote)
+            {
+                remote->on_data_received.connect(
+                    [&](std::int64_t, std::size_t, const void *data, std::size_t size)
+                    {
+                        received += size;
+                        EXPECT_EQ(static_cast<const double *>(data)[2], 3);
+                        connection->close();
+                        server.close();
+                    });
+
+                remote->subscribe();
+            });
+        });
+
+    ioc.run_for(std::chrono::seconds(5));
+    EXPECT_EQ(received, 3 * sizeof(double));
+}
+
+TEST_F(LocalListenerTest, KeepsRegularFile)
+{
+    std::ofstream{path} << "configuration";
+
+    boost::asio::io_context ioc;
+    wss::server server{ioc.get_executor()};
+
+    EXPECT_THROW(server.add_local_listener(path), boost::system::system_error);
+    EXPECT_TRUE(std::filesystem::is_regular_file(path));
+}
+
+TEST_F(LocalListenerTest, KeepsLiveSocket)
+{
+    boost::asio::io_context ioc;
+    boost::asio::local::stream_protocol::acceptor acceptor{
+        ioc,
+        boost::asio::local::stream_protocol::endpoint{path}};
+
+    wss::server server{ioc.get_executor()};
+
+    EXPECT_THROW(server.add_local_listener(path), boost::system::system_error);
+    EXPECT_TRUE(std::filesystem::is_socket(path));
+}
+
+TEST_F(LocalListenerTest, RemovesStaleSocket)
+{
+    boost::asio::io_context ioc;
+
+    {
+        // Closing a listening socket does not remove its path.
+        boost::asio::local::stream_protocol::acceptor acceptor{
+            ioc,
+            boost::asio::local::stream_protocol::endpoint{path}};
+    }
+
+    ASSERT_TRUE(std::filesystem::is_socket(path));
+
+    wss::server server{ioc.get_executor()};
+    EXPECT_NO_THROW(server.add_local_listener(path));
+
+    boost::asio::local::stream_protocol::socket socket{ioc};
+    boost::system::error_code ec;
+    socket.connect(boost::asio::local::stream_protocol::endpoint{path}, ec);
+    EXPECT_FALSE(ec) << ec.message();
+}
+
+#endif
@@ -0,0 +1,215 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/encodings.hpp>
+#include <ws-streaming/endianness.hpp>
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/detail/payload_codec.hpp>
+
+using namespace testing;
+
+static wss::detail::payload_codec make_codec(
+    const std::string& data_type,
+    const std::string& encoding,
+    const std::string& endian = wss::endianness::little)
+{
+    return wss::detail::payload_codec{wss::metadata{
+        wss::metadata_builder{"Value"}
+            .data_type(data_type)
+            .endian(endian)
+            .encoding(encoding)
+            .build()}};
+}
+
+static std::vector<std::uint8_t> round_trip(
+    const wss::detail::payload_codec& codec,
+    const std::vector<std::uint8_t>& data,
+    std::size_t& encoded_size)
+{
+    std::vector<std::uint8_t> encoded, decoded;
+
+    codec.encode(data.data(), data.size(), encoded);
+    encoded_size = encoded.size();
+    EXPECT_TRUE(codec.decode(encoded.data(), encoded.size(), decoded));
+
+    return decoded;
+}
+
+TEST(PayloadCodecTest, Selection)
+{
+    EXPECT_TRUE(make_codec(wss::data_types::int32_t, wss::encodings::delta).enabled());
+    EXPECT_TRUE(make_codec(wss::data_types::uint64_t, wss::encodings::delta_of_delta).enabled());
+    EXPECT_TRUE(make_codec(wss::data_types::real64_t, wss::encodings::xor_float).enabled());
+    EXPECT_FALSE(make_codec(wss::data_types::real64_t, wss::encodings::delta).enabled());
+    EXPECT_FALSE(make_codec(wss::data_types::int32_t, wss::encodings::xor_float).enabled());
+    EXPECT_FALSE(make_codec(wss::data_types::int32_t, "").enabled());
+    EXPECT_FALSE(wss::detail::payload_codec{}.enabled());
+}
+
+TEST(PayloadCodecTest, DeltaOfDeltaTimestamps)
+{
+    auto codec = make_codec(wss::data_types::uint64_t, wss::encodings::delta_of_delta);
+
+    // Timestamps with a constant period and a little jitter.
+    std::vector<std::uint8_t> data(1000 * 8);
+    for (int i = 0; i < 1000; ++i)
+        boost::endian::store_little_u64(&data[i * 8], 1'700'000'000'000'000ull + i * 1000 + (i % 7 == 0));
+
+    std::size_t encoded_size;
+    EXPECT_EQ(round_trip(codec, data, encoded_size), data);
+    EXPECT_LT(encoded_size, data.size() / 20);
+}
+
+TEST(PayloadCodecTest, DeltaBigEndianWraparound)
+{
+    auto codec = make_codec(wss::data_types::int16_t, wss::encodings::delta, wss::endianness::big);
+
+    std::vector<std::uint8_t> data(300 * 2);
+    for (int i = 0; i < 300; ++i)
+        boost::endian::store_big_s16(&data[i * 2], static_cast<std::int16_t>(32700 + i));
+
+    std::size_t encoded_size;
+    EXPECT_EQ(round_trip(codec, data, encoded_size), data);
+    EXPECT_LT(encoded_size, data.size() / 4);
+}
+
+TEST(PayloadCodecTest, XorFloats)
+{
+    for (const char *type : { wss::data_types::real32_t, wss::data_types::real64_t })
+    {
+        auto codec = make_codec(type, wss::encodings::xor_float);
+        bool is_double = std::string{type} == wss::data_types::real64_t;
+        std::size_t size = is_double ? 8 : 4;
+
+        // A slowly changing quantized signal, with repeated values and a few special values.
+        std::vector<std::uint8_t> data(1000 * size);
+        for (int i = 0; i < 1000; ++i)
+        {
+            double value = std::round(std::sin(i / 100.0) * 1000) / 8;
+            if (i == 500) value = -0.0;
+            if (i == 501) value = NAN;
+            if (i == 502) value = INFINITY;
+
+            if (is_double)
+                std::memcpy(&data[i * size], &value, size);
+            else
+            {
+                float f = static_cast<float>(value);
+                std::memcpy(&data[i * size], &f, size);
+            }
+        }
+
+        std::size_t encoded_size;
+        EXPECT_EQ(round_trip(codec, data, encoded_size), data);
+        EXPECT_LT(encoded_size, data.size() / 2);
+    }
+}
+
+TEST(PayloadCodecTest, RawFallback)
+{
+    auto codec = make_codec(wss::data_types::uint32_t, wss::encodings::delta);
+
+    // Random data does not compress; a trailing partial sample is not transmitted.
+    std::vector<std::uint8_t> data(400 * 4 + 3);
+    std::uint32_t state = 12345;
+    for (auto& byte : data)
+        byte = static_cast<std::uint8_t>((state = state * 1103515245 + 12345) >> 24);
+
+    std::size_t encoded_size;
+    auto decoded = round_trip(codec, data, encoded_size);
+
+    EXPECT_EQ(encoded_size, 1 + 400 * 4);
+    EXPECT_EQ(decoded, std::vector<std::uint8_t>(data.begin(), data.begin() + 400 * 4));
+}
+
+TEST(PayloadCodecTest, EncodeFitsMaxEncodedSize)
+{
+    // Alternating differences that never fit the previous window of meaningful bits are the
+    // worst case of the floating-point encodings.
+    for (const auto *type : { wss::data_types::real32_t, wss::data_types::real64_t })
+    {
+        auto codec = make_codec(type, wss::encodings::xor_float);
+        bool is_real32 = std::string{type} == wss::data_types::real32_t;
+        std::size_t sample_size = is_real32 ? 4 : 8;
+
+        std::vector<std::uint8_t> data(1000 * sample_size);
+        std::uint32_t value32 = 0;
+        std::uint64_t value64 = 0;
+        for (std::size_t i = 0; i < 1000; ++i)
+        {
+            value32 ^= i % 2 ? ~std::uint32_t{1} : ~std::uint32_t{0} >> 1;
+            value64 ^= i % 2 ? ~std::uint64_t{1} : ~std::uint64_t{0} >> 1;
+            if (is_real32)
+                boost::endian::store_little_u32(&data[i * 4], value32);
+            else
+                boost::endian::store_little_u64(&data[i * 8], value64);
+        }
+
+        std::vector<std::uint8_t> encoded;
+        encoded.reserve(wss::detail::payload_codec::max_encoded_size(data.size()));
+        const auto *reserved = encoded.data();
+
+        codec.encode(data.data(), data.size(), encoded);
+        EXPECT_EQ(encoded.data(), reserved) << type;
+        EXPECT_EQ(encoded[0], wss::detail::payload_codec::MODE_RAW) << type;
+    }
+}
+
+TEST(PayloadCodecTest, MalformedInput)
+{
+    auto codec = make_codec(wss::data_types::int32_t, wss::encodings::delta);
+
+    std::vector<std::uint8_t> data(200 * 4);
+    for (int i = 0; i < 200; ++i)
+        boost::endian::store_little_s32(&data[i * 4], i * i);
+
+    std::vector<std::uint8_t> encoded, decoded;
+    codec.encode(data.data(), data.size(), encoded);
+
+    for (std::size_t size = 0; size < encoded.size(); ++size)
+        EXPECT_FALSE(codec.decode(encoded.data(), size, decoded)) << size;
+
+    // An unknown mode byte, an excessive bit width and an implausible sample count.
+    std::uint8_t bad_mode[] = { 7, 1, 0 };
+    std::uint8_t bad_width[] = { wss::detail::payload_codec::MODE_ENCODED, 2, 0, 0, 0, 0, 33, 0, 0, 0, 0, 0 };
+    std::uint8_t bad_count[] = { wss::detail::payload_codec::MODE_ENCODED, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0 };
+    EXPECT_FALSE(codec.decode(bad_mode, sizeof(bad_mode), decoded));
+    EXPECT_FALSE(codec.decode(bad_width, sizeof(bad_width), decoded));
+    EXPECT_FALSE(codec.decode(bad_count, sizeof(bad_count), decoded));
+}
+
+TEST(PayloadCodecTest, MaxDecodedSize)
+{
+    constexpr std::size_t max_samples = wss::detail::payload_codec::MAX_DECODED_SIZE / 4;
+
+    auto codec = make_codec(wss::data_types::int32_t, wss::encodings::delta);
+
+    // Packets up to the limit are encoded; larger packets are transmitted raw.
+    std::vector<std::uint8_t> data(max_samples * 4);
+    std::size_t encoded_size;
+    EXPECT_EQ(round_trip(codec, data, encoded_size), data);
+    EXPECT_LT(encoded_size, data.size() / 100);
+
+    data.resize(data.size() + 4);
+    EXPECT_EQ(round_trip(codec, data, encoded_size), data);
+    EXPECT_EQ(encoded_size, 1 + data.size());
+
+    // A small packet claiming more samples is rejected before any output is allocated.
+    std::vector<std::uint8_t> packet = { wss::detail::payload_codec::MODE_ENCODED };
+    for (std::size_t count = max_samples + 1; count; count >>= 7)
+        packet.push_back(static_cast<std::uint8_t>((count & 0x7F) | (count >= 0x80 ? 0x80 : 0)));
+    packet.resize(packet.size() + max_samples / wss::detail::payload_codec::GROUP_SIZE + 1);
+
+    std::vector<std::uint8_t> decoded;
+    EXPECT_FALSE(codec.decode(packet.data(), packet.size(), decoded));
+    EXPECT_EQ(decoded.capacity(), 0);
+}
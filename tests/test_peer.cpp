@@ -0,0 +1,105 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/socket_base.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/detail/peer.hpp>
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+using namespace testing;
+using namespace wss::detail;
+
+class PeerTest : public TestWithParam<bool>
+{
+};
+
+TEST_P(PeerTest, OwnedBlocksAreReferencedUnderBackpressure)
+{
+    constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+    constexpr std::size_t FILLER_BLOCKS = 16;
+    constexpr std::size_t OWNED_BLOCKS = 8;
+
+    boost::asio::io_context ioc;
+    boost::asio::local::stream_protocol::socket socket_a{ioc};
+    boost::asio::local::stream_protocol::socket socket_b{ioc};
+    boost::asio::local::connect_pair(socket_a, socket_b);
+
+    socket_b.set_option(boost::asio::socket_base::receive_buffer_size{16 * 1024});
+
+    auto a = std::make_shared<peer>(std::move(socket_a), false, GetParam());
+    auto b = std::make_shared<peer>(std::move(socket_b), true, GetParam());
+
+    // The peer enlarges the socket's send buffer to match its transmit buffer; shrink it again
+    // so that the socket fills up quickly.
+    a->socket().set_option(boost::asio::socket_base::send_buffer_size{16 * 1024});
+
+    std::vector<std::vector<std::uint8_t>> received;
+    b->on_data_received.connect([&](unsigned signo, const std::uint8_t *data, std::size_t size)
+    {
+        EXPECT_EQ(signo, received.size() < FILLER_BLOCKS ? 1 : 2);
+        received.emplace_back(data, data + size);
+    });
+
+    // Fill the socket while the receiving peer is not reading.
+    a->run();
+
+    for (std::size_t i = 0; i < FILLER_BLOCKS; ++i)
+    {
+        std::vector<std::uint8_t> filler(BLOCK_SIZE, static_cast<std::uint8_t>(i));
+        a->send_data(1, boost::asio::buffer(filler));
+    }
+
+    // Blocks sent now cannot be written synchronously, so the peer keeps a reference to their
+    // owners instead of copying them.
+    std::vector<std::shared_ptr<std::vector<std::uint8_t>>> owners;
+
+    for (std::size_t i = 0; i < OWNED_BLOCKS; ++i)
+    {
+        auto owner = std::make_shared<std::vector<std::uint8_t>>(BLOCK_SIZE);
+        for (std::size_t j = 0; j < BLOCK_SIZE; ++j)
+            (*owner)[j] = static_cast<std::uint8_t>(i * 31 + j);
+
+        a->send_data(2, boost::asio::buffer(*owner), owner);
+        owners.push_back(owner);
+    }
+
+    for (const auto& owner : owners)
+        EXPECT_EQ(owner.use_count(), 2);
+
+    // Drain the socket; each reference is dropped once its block has been sent.
+    b->run();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (received.size() < FILLER_BLOCKS + OWNED_BLOCKS)
+        ASSERT_TRUE(ioc.run_one_until(deadline));
+
+    for (std::size_t i = 0; i < FILLER_BLOCKS; ++i)
+        EXPECT_EQ(received[i], std::vector<std::uint8_t>(BLOCK_SIZE, static_cast<std::uint8_t>(i))) << i;
+
+    for (std::size_t i = 0; i < OWNED_BLOCKS; ++i)
+    {
+        EXPECT_EQ(received[FILLER_BLOCKS + i], *owners[i]) << i;
+        EXPECT_EQ(owners[i].use_count(), 1) << i;
+    }
+
+    a->stop();
+    b->stop();
+    ioc.run_for(std::chrono::milliseconds(10));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TcpAndWebSocketFraming,
+    PeerTest,
+    Values(true, false));
+
+#endif
@@ -0,0 +1,126 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/sample_converter.hpp>
+#include <ws-streaming/transport_formats.hpp>
+#include <ws-streaming/detail/precision_reducer.hpp>
+
+using namespace testing;
+
+// Reduces the values with the specified format, then converts the result back to values using
+// the reduced metadata, as a receiving peer would.
+static std::vector<double> round_trip(
+    const wss::metadata& metadata,
+    const char *format,
+    const std::vector<double>& values)
+{
+    wss::detail::precision_reducer reducer{metadata, format};
+    EXPECT_TRUE(reducer.valid());
+
+    std::vector<std::uint8_t> reduced(values.size() * reducer.sample_size());
+    EXPECT_TRUE(reducer.reduce(values.data(), values.size(), reduced.data()));
+
+    std::vector<double> output(values.size());
+    EXPECT_TRUE(wss::sample_converter{reducer.reduced_metadata()}.convert(
+        reduced.data(), output.size(), output.data()));
+
+    return output;
+}
+
+TEST(PrecisionReducerTest, Real32)
+{
+    wss::metadata metadata = wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::real64_t)
+        .post_scaling(2, 1)
+        .build();
+
+    auto output = round_trip(metadata, wss::transport_formats::real32, { 0.25, -3, 1e10 });
+
+    // Values are post-scaled before conversion, so the reduced signal has no post-scaling.
+    EXPECT_EQ(output[0], 1.5);
+    EXPECT_EQ(output[1], -5);
+    EXPECT_EQ(output[2], static_cast<float>(2e10 + 1));
+}
+
+TEST(PrecisionReducerTest, Real16)
+{
+    wss::metadata metadata = wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::real64_t)
+        .build();
+
+    double infinity = std::numeric_limits<double>::infinity();
+
+    auto output = round_trip(metadata, wss::transport_formats::real16, {
+        0, -2.25, 65504, 65520, 1e6, -infinity,
+        1 + 1.0 / 2048,             // Halfway between 1 and the next half; rounds to even.
+        1 + 3.0 / 2048,             // Halfway between two halves; rounds to even (up).
+        std::ldexp(3.0, -24),       // Subnormal.
+        std::ldexp(1.0, -26),       // Underflows to zero.
+    });
+
+    EXPECT_EQ(output[0], 0);
+    EXPECT_EQ(output[1], -2.25);
+    EXPECT_EQ(output[2], 65504);
+    EXPECT_EQ(output[3], infinity);
+    EXPECT_EQ(output[4], infinity);
+    EXPECT_EQ(output[5], -infinity);
+    EXPECT_EQ(output[6], 1);
+    EXPECT_EQ(output[7], 1 + 4.0 / 2048);
+    EXPECT_EQ(output[8], std::ldexp(3.0, -24));
+    EXPECT_EQ(output[9], 0);
+
+    auto nan = round_trip(metadata, wss::transport_formats::real16, { std::nan("") });
+    EXPECT_TRUE(std::isnan(nan[0]));
+}
+
+TEST(PrecisionReducerTest, ScaledInt16)
+{
+    wss::metadata metadata = wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::real64_t)
+        .range(-10, 30)
+        .build();
+
+    double step = 40.0 / 65534;
+
+    std::vector<double> values;
+    for (int i = 0; i <= 1000; ++i)
+        values.push_back(-10 + i * 0.04);
+
+    auto output = round_trip(metadata, wss::transport_formats::scaled_int16, values);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        ASSERT_NEAR(output[i], values[i], step / 2 + 1e-12);
+
+    // Values outside the range are clamped to it.
+    output = round_trip(metadata, wss::transport_formats::scaled_int16, { -1e9, 1e9, std::nan("") });
+    EXPECT_NEAR(output[0], -10, 1e-9);
+    EXPECT_NEAR(output[1], 30, 1e-9);
+    EXPECT_NEAR(output[2], -10, 1e-9);
+}
+
+TEST(PrecisionReducerTest, Invalid)
+{
+    wss::metadata value = wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::real64_t)
+        .build();
+
+    wss::metadata structure = wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::struct_t)
+        .build();
+
+    EXPECT_FALSE((wss::detail::precision_reducer{value, "real8"}.valid()));
+    EXPECT_FALSE((wss::detail::precision_reducer{structure, wss::transport_formats::real32}.valid()));
+
+    // Quantization requires a non-empty range.
+    EXPECT_FALSE((wss::detail::precision_reducer{value, wss::transport_formats::scaled_int16}.valid()));
+
+    std::int16_t output;
+    EXPECT_FALSE(wss::detail::precision_reducer{}.reduce(nullptr, 0, &output));
+}
@@ -0,0 +1,143 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/endian/conversion.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/connection.hpp>
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/publish_group.hpp>
+#include <ws-streaming/typed_local_signal.hpp>
+#include <ws-streaming/detail/streaming_protocol.hpp>
+
+#include "raw_peer.hpp"
+
+using namespace testing;
+
+static void record_events(wss::local_signal& signal, std::vector<std::string>& events)
+{
+    signal.on_group_begin.connect([&]() { events.push_back("begin " + signal.id()); });
+    signal.on_group_end.connect([&]() { events.push_back("end " + signal.id()); });
+
+    signal.on_data_published.connect(
+        [&](
+            std::int64_t domain_value,
+            std::size_t sample_count,
+            const boost::asio::const_buffer *buffers,
+            std::size_t buffer_count,
+            const std::shared_ptr<const void>& owner)
+        {
+            events.push_back("data " + signal.id()
+                + " " + std::to_string(domain_value)
+                + " " + std::to_string(sample_count)
+                + " " + std::to_string(buffers->size()));
+        });
+}
+
+TEST(PublishGroupTest, PublishesTogether)
+{
+    wss::typed_local_signal<std::uint64_t> time{"/Time", wss::metadata_builder{"Time"}};
+    wss::local_signal value{"/Value", wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::real64_t).build()};
+
+    std::vector<std::string> events;
+    record_events(time, events);
+    record_events(value, events);
+
+    std::uint64_t timestamp = 1000;
+    double samples[4] = { };
+
+    wss::publish_group group;
+    group.add(time, timestamp);
+    group.add(value, 5, 4, samples, sizeof(samples));
+    EXPECT_FALSE(group.empty());
+
+    group.publish();
+    EXPECT_TRUE(group.empty());
+
+    std::vector<std::string> expected
+    {
+        "begin /Time",
+        "begin /Value",
+        "data /Time 0 0 8",
+        "data /Value 5 4 32",
+        "end /Time",
+        "end /Value",
+    };
+
+    EXPECT_EQ(events, expected);
+
+    events.clear();
+    group.publish();
+    EXPECT_TRUE(events.empty());
+}
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+TEST(PublishGroupTest, ConnectionTransmitsOneAggregatePacket)
+{
+    boost::asio::io_context ioc;
+    boost::asio::local::stream_protocol::socket server_socket{ioc};
+    boost::asio::local::stream_protocol::socket client_socket{ioc};
+    boost::asio::local::connect_pair(server_socket, client_socket);
+
+    wss::local_signal first{"/First", wss::metadata_builder{"First"}
+        .data_type(wss::data_types::real64_t).build()};
+    wss::local_signal second{"/Second", wss::metadata_builder{"Second"}
+        .data_type(wss::data_types::real64_t).build()};
+
+    auto connection = std::make_shared<wss::connection>(std::move(server_socket), false, true);
+    connection->add_local_signal(first);
+    connection->add_local_signal(second);
+    connection->run();
+
+    raw_peer client{std::move(client_socket)};
+    std::string stream_id = client.greet(ioc, { wss::detail::streaming_protocol::AGGREGATE_CAPABILITY });
+    ASSERT_FALSE(stream_id.empty());
+
+    auto signos = client.subscribe(ioc, stream_id, { "/First", "/Second" });
+    ASSERT_EQ(signos.size(), 2);
+
+    client.packets.clear();
+
+    double values[] = { 1, 2 };
+    wss::publish_group group;
+    group.add(first, &values[0], sizeof(double));
+    group.add(second, &values[1], sizeof(double));
+    group.publish();
+
+    ASSERT_TRUE(client.run_until(ioc, [&] { return !client.packets.empty(); }));
+    client.run_until(ioc, [] { return false; }, std::chrono::milliseconds(10));
+
+    ASSERT_EQ(client.packets.size(), 1);
+    ASSERT_EQ(client.packets[0].type, wss::detail::streaming_protocol::packet_type::AGGREGATE);
+
+    std::vector<unsigned> aggregated;
+    EXPECT_TRUE(wss::detail::streaming_protocol::split_aggregate<boost::endian::order::big>(
+        client.packets[0].payload.data(),
+        client.packets[0].payload.size(),
+        [&](unsigned signo, const std::uint8_t *, std::size_t size)
+        {
+            aggregated.push_back(signo);
+            EXPECT_EQ(size, sizeof(double));
+        }));
+
+    std::vector<unsigned> expected{ signos["/First"], signos["/Second"] };
+    EXPECT_EQ(aggregated, expected);
+
+    connection->close();
+    ioc.run_for(std::chrono::milliseconds(10));
+}
+
+#endif
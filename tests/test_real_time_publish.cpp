@@ -0,0 +1,210 @@
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/publish_group.hpp>
+#include <ws-streaming/typed_local_signal.hpp>
+
+using namespace testing;
+
+// Every heap allocation made while tracking is enabled is counted. C++ allocations are
+// intercepted portably by replacing the global allocation functions; on glibc, C allocations
+// are intercepted as well by interposing malloc() and friends.
+
+static std::atomic<bool> tracking = false;
+static std::atomic<std::size_t> allocations = 0;
+
+static void count_allocation() noexcept
+{
+    if (tracking)
+        ++allocations;
+}
+
+#ifdef __GLIBC__
+extern "C" void *__libc_malloc(std::size_t size);
+extern "C" void *__libc_calloc(std::size_t count, std::size_t size);
+extern "C" void *__libc_realloc(void *ptr, std::size_t size);
+extern "C" void __libc_free(void *ptr);
+
+extern "C" void *malloc(std::size_t size) noexcept
+{
+    count_allocation();
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(std::size_t count, std::size_t size) noexcept
+{
+    count_allocation();
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, std::size_t size) noexcept
+{
+    count_allocation();
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void *ptr) noexcept
+{
+    count_allocation();
+    __libc_free(ptr);
+}
+#endif
+
+void *operator new(std::size_t size)
+{
+    count_allocation();
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    count_allocation();
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+TEST(RealTimePublishTest, PublishDoesNotAllocate)
+{
+    wss::local_signal raw{"/Raw", wss::metadata_builder{"Raw"}
+        .data_type(wss::data_types::uint8_t).build()};
+    wss::typed_local_signal<double> value{"/Value", wss::metadata_builder{"Value"}};
+    wss::typed_local_signal<std::uint64_t> time{"/Time", wss::metadata_builder{"Time"}};
+
+    raw.enable_broadcast_ring(64 * 1024);
+    value.enable_broadcast_ring(64 * 1024);
+    time.enable_broadcast_ring(64 * 1024);
+
+    // Slots attached to on_data_published are not invoked once a broadcast ring is enabled.
+    raw.on_data_published.connect(
+        [](
+            std::int64_t,
+            std::size_t,
+            const boost::asio::const_buffer *,
+            std::size_t,
+            const std::shared_ptr<const void>&)
+        {
+            count_allocation();
+        });
+
+    std::array<std::uint8_t, 100> bytes { };
+    std::array<double, 16> samples { };
+    std::array<boost::asio::const_buffer, 2> buffers
+    {
+        boost::asio::buffer(bytes.data(), 10),
+        boost::asio::buffer(bytes.data() + 50, 50),
+    };
+    std::uint64_t timestamp = 0;
+
+    wss::publish_group group;
+    group.reserve(2);
+
+    tracking = true;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        raw.publish_data(bytes.data(), bytes.size());
+        raw.publish_data(i, bytes.size(), bytes.data(), bytes.size());
+        raw.publish_data(buffers);
+        value.publish_data(samples);
+        value.publish_data(i, samples);
+
+        ++timestamp;
+        group.add(time, timestamp);
+        group.add(value, samples[0]);
+        group.publish();
+    }
+
+    tracking = false;
+
+    EXPECT_EQ(allocations, 0);
+}
+
+TEST(RealTimePublishTest, ReserveAndCommitDoNotAllocate)
+{
+    wss::local_signal raw{"/Raw", wss::metadata_builder{"Raw"}
+        .data_type(wss::data_types::uint8_t).build()};
+
+    raw.enable_broadcast_ring(64 * 1024);
+
+    // Reserving from a slab that is still referenced elsewhere, or from a fresh arena, must
+    // allocate. Once the arena has cycled through its slabs, released slabs are reused.
+    auto cycle = [&](int iterations)
+    {
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto reservation = raw.reserve(1000);
+            static_cast<std::uint8_t *>(reservation.data())[0] = static_cast<std::uint8_t>(i);
+
+            if (i % 2)
+                raw.commit(reservation, 500);
+            else
+                raw.commit(i, 1, reservation, 1000);
+        }
+    };
+
+    cycle(10000);
+
+    allocations = 0;
+    tracking = true;
+    cycle(10000);
+    tracking = false;
+
+    EXPECT_EQ(allocations, 0);
+}
+
+TEST(RealTimePublishTest, OwnedBlocksDoNotAllocate)
+{
+    wss::local_signal raw{"/Raw", wss::metadata_builder{"Raw"}
+        .data_type(wss::data_types::uint8_t).build()};
+
+    raw.enable_broadcast_ring(64 * 1024);
+
+    auto block = std::make_shared<std::array<std::uint8_t, 100>>();
+    std::shared_ptr<const void> owner = block;
+
+    allocations = 0;
+    tracking = true;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        raw.publish_data(owner, block->size());
+        raw.publish_data(i, block->size(), owner, block->size());
+    }
+
+    tracking = false;
+
+    EXPECT_EQ(allocations, 0);
+}
@@ -0,0 +1,199 @@
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/endianness.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/detail/remote_signal_impl.hpp>
+
+using namespace testing;
+using namespace wss::detail;
+
+class RemoteSignalTest : public Test
+{
+    protected:
+
+        RemoteSignalTest()
+            : time(std::make_shared<remote_signal_impl>("/Time"))
+            , value(std::make_shared<remote_signal_impl>("/Value"))
+        {
+            value->on_signal_sought.connect([this](const std::string& id)
+            {
+                return id == time->id() ? time : nullptr;
+            });
+        }
+
+        void announce_time(std::int64_t start, std::int64_t delta)
+        {
+            time->handle_metadata("signal", wss::metadata_builder{"Time"}
+                .data_type(wss::data_types::int64_t)
+                .linear_rule(start, delta)
+                .build());
+        }
+
+        void announce_value()
+        {
+            value->handle_metadata("signal", wss::metadata_builder{"Value"}
+                .data_type(wss::data_types::real64_t)
+                .endian(wss::endianness::little)
+                .table(time->id())
+                .build());
+        }
+
+        void receive_values(std::size_t count)
+        {
+            double samples[16] = { };
+            ASSERT_LE(count, std::size(samples));
+
+            value->handle_metadata("subscribe", nullptr);
+            value->handle_data(samples, count * sizeof(double));
+        }
+
+        std::shared_ptr<remote_signal_impl> time;
+        std::shared_ptr<remote_signal_impl> value;
+};
+
+TEST_F(RemoteSignalTest, NoDomainTable)
+{
+    std::int64_t output[3] = { 1, 2, 3 };
+
+    EXPECT_FALSE(value->domain_delta());
+    EXPECT_FALSE(value->domain_values(0, 3, output));
+
+    // A signal without a table still has no delta after receiving data.
+    value->handle_metadata("signal", wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::real64_t)
+        .endian(wss::endianness::little)
+        .build());
+    receive_values(3);
+
+    EXPECT_FALSE(value->domain_delta());
+    EXPECT_FALSE(value->domain_values(0, 3, output));
+    EXPECT_EQ(output[0], 1);
+}
+
+TEST_F(RemoteSignalTest, LinearDomainWithExplicitDelta)
+{
+    announce_time(1000, 25);
+    announce_value();
+    receive_values(4);
+
+    ASSERT_EQ(value->domain_delta(), std::optional<std::int64_t>{25});
+
+    std::int64_t output[4] = { };
+    ASSERT_TRUE(value->domain_values(1000, 4, output));
+    EXPECT_EQ(output[0], 1000);
+    EXPECT_EQ(output[1], 1025);
+    EXPECT_EQ(output[2], 1050);
+    EXPECT_EQ(output[3], 1075);
+}
+
+TEST_F(RemoteSignalTest, TcpSignalRate)
+{
+    // Half a second per sample, as a 32.64 fixed-point interval.
+    value->handle_metadata("signalRate", {
+        { "delta", { { "seconds", 0 }, { "fraction", 0x80000000u }, { "subFraction", 0 } } },
+        { "samples", 1 },
+    });
+    value->handle_metadata("data", {
+        { "valueType", wss::data_types::real64_t },
+        { "endian", wss::endianness::little },
+    });
+    receive_values(3);
+
+    ASSERT_EQ(value->domain_delta(), std::optional<std::int64_t>{500000000});
+
+    std::int64_t output[3] = { };
+    ASSERT_TRUE(value->domain_values(0, 3, output));
+    EXPECT_EQ(output[0], 0);
+    EXPECT_EQ(output[1], 500000000);
+    EXPECT_EQ(output[2], 1000000000);
+}
+
+TEST_F(RemoteSignalTest, WrapsAroundAtInt64Boundary)
+{
+    announce_time(0, 10);
+    announce_value();
+    receive_values(1);
+
+    constexpr auto max = std::numeric_limits<std::int64_t>::max();
+    constexpr auto min = std::numeric_limits<std::int64_t>::min();
+
+    std::int64_t output[3] = { };
+    ASSERT_TRUE(value->domain_values(max - 10, 3, output));
+    EXPECT_EQ(output[0], max - 10);
+    EXPECT_EQ(output[1], max);
+    EXPECT_EQ(output[2], min + 9);
+}
+
+TEST_F(RemoteSignalTest, DomainDetachedWhileValuePublishing)
+{
+    announce_time(1000, 25);
+    announce_value();
+    receive_values(2);
+
+    // The value signal keeps the domain signal's table alive after the domain signal is
+    // detached and released.
+    time->detach();
+    time.reset();
+
+    std::int64_t domain_value = 0;
+    value->on_data_received.connect([&](std::int64_t domain, std::size_t, const void *, std::size_t)
+    {
+        domain_value = domain;
+    });
+
+    receive_values(1);
+    EXPECT_EQ(domain_value, 1050);
+    EXPECT_EQ(value->domain_delta(), std::optional<std::int64_t>{25});
+}
+
+TEST_F(RemoteSignalTest, ValueAnnouncedBeforeDomain)
+{
+    announce_value();
+    announce_time(1000, 25);
+    receive_values(3);
+
+    ASSERT_EQ(value->domain_delta(), std::optional<std::int64_t>{25});
+
+    std::int64_t output[3] = { };
+    ASSERT_TRUE(value->domain_values(1000, 3, output));
+    EXPECT_EQ(output[2], 1050);
+}
+
+TEST_F(RemoteSignalTest, DomainRuleChangedThroughMetadata)
+{
+    announce_time(1000, 25);
+    announce_value();
+    receive_values(1);
+    ASSERT_EQ(value->domain_delta(), std::optional<std::int64_t>{25});
+
+    // Without a linear rule the domain signal has no table.
+    time->handle_metadata("signal", wss::metadata_builder{"Time"}
+        .data_type(wss::data_types::int64_t)
+        .build());
+    receive_values(1);
+    EXPECT_FALSE(value->domain_delta());
+
+    // A linear rule added again gets a new table, which the value signal uses at once.
+    announce_time(5000, 10);
+
+    std::int64_t domain_value = 0;
+    value->on_data_received.connect([&](std::int64_t domain, std::size_t, const void *, std::size_t)
+    {
+        domain_value = domain;
+    });
+
+    receive_values(1);
+    EXPECT_EQ(value->domain_delta(), std::optional<std::int64_t>{10});
+    EXPECT_EQ(domain_value, 5000 + 2 * 10);
+}
@@ -0,0 +1,101 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/endianness.hpp>
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/sample_converter.hpp>
+
+using namespace testing;
+
+TEST(SampleConverterTest, LittleEndian)
+{
+    wss::sample_converter converter{wss::metadata{
+        wss::metadata_builder{"Value"}
+            .data_type(wss::data_types::int16_t)
+            .endian(wss::endianness::little)
+            .build()}};
+
+    ASSERT_TRUE(converter.valid());
+    EXPECT_EQ(converter.sample_size(), 2);
+
+    // Use an odd offset to verify that unaligned input is accepted.
+    std::vector<std::uint8_t> data(1 + 1000 * 2);
+    for (int i = 0; i < 1000; ++i)
+        boost::endian::store_little_s16(&data[1 + i * 2], static_cast<std::int16_t>(i * 31 - 15000));
+
+    std::vector<double> output(1000);
+    ASSERT_TRUE(converter.convert(&data[1], output.size(), output.data()));
+
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(output[i], i * 31 - 15000);
+}
+
+TEST(SampleConverterTest, BigEndianFloat)
+{
+    wss::sample_converter converter{wss::metadata{
+        wss::metadata_builder{"Value"}
+            .data_type(wss::data_types::real32_t)
+            .endian(wss::endianness::big)
+            .build()}};
+
+    float values[] = { 1.5f, -2.25f, 1e10f };
+    std::uint8_t data[sizeof(values)];
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        boost::endian::store_big_u32(&data[i * 4], bits);
+    }
+
+    double output_double[3];
+    float output_float[3];
+    ASSERT_TRUE(converter.convert(data, 3, output_double));
+    ASSERT_TRUE(converter.convert(data, 3, output_float));
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(output_double[i], values[i]);
+        EXPECT_EQ(output_float[i], values[i]);
+    }
+}
+
+TEST(SampleConverterTest, PostScaling)
+{
+    wss::metadata metadata{
+        wss::metadata_builder{"Value"}
+            .data_type(wss::data_types::uint32_t)
+            .post_scaling(0.5, -10)
+            .build()};
+
+    std::uint8_t data[8];
+    boost::endian::store_little_u32(&data[0], 100);
+    boost::endian::store_little_u32(&data[4], 0xFFFFFFFF);
+
+    double output[2];
+    ASSERT_TRUE(wss::sample_converter(metadata).convert(data, 2, output));
+    EXPECT_EQ(output[0], 40);
+    EXPECT_EQ(output[1], 0xFFFFFFFF * 0.5 - 10);
+
+    ASSERT_TRUE(wss::sample_converter(metadata, false).convert(data, 2, output));
+    EXPECT_EQ(output[0], 100);
+}
+
+TEST(SampleConverterTest, Unsupported)
+{
+    wss::sample_converter converter{wss::metadata{
+        wss::metadata_builder{"Value"}
+            .data_type(wss::data_types::struct_t)
+            .build()}};
+
+    double output;
+    EXPECT_FALSE(converter.valid());
+    EXPECT_FALSE(converter.convert(nullptr, 0, &output));
+    EXPECT_FALSE(wss::sample_converter{}.valid());
+}
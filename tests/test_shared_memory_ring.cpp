@@ -0,0 +1,340 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/connection.hpp>
+#include <ws-streaming/detail/peer.hpp>
+#include <ws-streaming/detail/shared_memory_ring.hpp>
+#include <ws-streaming/detail/streaming_protocol.hpp>
+
+#include "raw_peer.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace testing;
+using namespace wss::detail;
+
+TEST(SharedMemoryRingTest, WrapsAroundThroughDoubleMapping)
+{
+    shared_memory_ring writer{1};
+    shared_memory_ring reader{writer.name(), writer.cookie()};
+    std::size_t capacity = writer.capacity();
+
+    ASSERT_EQ(reader.capacity(), capacity);
+
+    // Move the indices close to the end of the data area.
+    std::vector<std::uint8_t> filler(capacity - 10);
+    EXPECT_EQ(writer.write(boost::asio::buffer(filler)).first, filler.size());
+    EXPECT_EQ(reader.readable().second, filler.size());
+    reader.consume(filler.size());
+
+    // This write wraps around, but is read back as one contiguous region.
+    std::vector<std::uint8_t> data(100);
+    std::iota(data.begin(), data.end(), 0);
+    EXPECT_EQ(writer.write(boost::asio::buffer(data)).first, data.size());
+
+    auto [readable, size] = reader.readable();
+    ASSERT_EQ(size, data.size());
+    EXPECT_EQ(std::memcmp(readable, data.data(), data.size()), 0);
+}
+
+TEST(SharedMemoryRingTest, RejectsCookieMismatch)
+{
+    shared_memory_ring writer{1};
+
+    EXPECT_THROW(
+        (shared_memory_ring{writer.name(), writer.cookie() + 1}),
+        boost::system::system_error);
+}
+
+TEST(SharedMemoryRingTest, RejectsMagicMismatch)
+{
+    shared_memory_ring writer{1};
+
+    // Overwrite the magic number at the beginning of the segment.
+    int fd = ::shm_open(writer.name().c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    std::uint64_t bogus = 0;
+    EXPECT_EQ(::pwrite(fd, &bogus, sizeof(bogus), 0), static_cast<ssize_t>(sizeof(bogus)));
+    ::close(fd);
+
+    EXPECT_THROW(
+        (shared_memory_ring{writer.name(), writer.cookie()}),
+        boost::system::system_error);
+}
+
+TEST(SharedMemoryRingTest, RejectsTruncatedSegment)
+{
+    // Reading the header of an empty segment would raise SIGBUS rather than fail cleanly.
+    // The writer's own header becomes inaccessible as well, so its name and cookie are read
+    // before the segment is truncated.
+    shared_memory_ring writer{1};
+    std::string name = writer.name();
+    std::uint64_t cookie = writer.cookie();
+
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(::ftruncate(fd, 0), 0);
+    ::close(fd);
+
+    EXPECT_THROW(
+        (shared_memory_ring{name, cookie}),
+        boost::system::system_error);
+}
+
+TEST(SharedMemoryRingTest, FullRingWriterIsWoken)
+{
+    shared_memory_ring writer{1};
+    shared_memory_ring reader{writer.name(), writer.cookie()};
+    std::size_t capacity = writer.capacity();
+
+    std::vector<std::uint8_t> data(capacity + 100);
+    EXPECT_EQ(writer.write(boost::asio::buffer(data)).first, capacity);
+    EXPECT_EQ(writer.write(boost::asio::buffer(data)).first, 0);
+
+    // The ring is full, so the writer may wait, and the next consume() must wake it.
+    EXPECT_TRUE(writer.prepare_wait_for_space());
+    EXPECT_TRUE(reader.consume(10));
+    EXPECT_FALSE(reader.consume(10));
+
+    EXPECT_EQ(writer.write(boost::asio::buffer(data)).first, 20);
+    EXPECT_FALSE(writer.corrupt());
+
+    // With space available, the writer should retry instead of waiting.
+    reader.consume(1);
+    EXPECT_FALSE(writer.prepare_wait_for_space());
+    EXPECT_FALSE(writer.corrupt());
+}
+
+TEST(SharedMemoryRingTest, DetectsCorruptIndices)
+{
+    shared_memory_ring writer{1};
+    shared_memory_ring reader{writer.name(), writer.cookie()};
+
+    std::uint8_t byte = 0;
+    EXPECT_EQ(writer.write(boost::asio::buffer(&byte, 1)).first, 1);
+
+    // A misbehaving reader moves the tail past the head.
+    reader.consume(2);
+
+    EXPECT_EQ(writer.write(boost::asio::buffer(&byte, 1)).first, 0);
+    EXPECT_TRUE(writer.corrupt());
+    EXPECT_FALSE(writer.prepare_wait_for_space());
+}
+
+class SharedMemoryPeerTest : public TestWithParam<bool>
+{
+};
+
+TEST_P(SharedMemoryPeerTest, SwitchesAndStreams)
+{
+    constexpr std::size_t PACKET_SIZE = 1000;
+    constexpr std::size_t PACKETS_PER_ROUND = 6;
+    constexpr std::size_t ROUNDS = 50;
+
+    boost::asio::io_context ioc;
+    boost::asio::local::stream_protocol::socket socket_a{ioc};
+    boost::asio::local::stream_protocol::socket socket_b{ioc};
+    boost::asio::local::connect_pair(socket_a, socket_b);
+
+    // Rings are sized like the receive buffer. A ring of a single page fills up after a few
+    // packets, so the writer must repeatedly wait for the reader to free space.
+    auto a = std::make_shared<peer>(std::move(socket_a), false, false, 4096, 64 * 1024);
+    auto b = std::make_shared<peer>(std::move(socket_b), true, false, 4096, 64 * 1024);
+
+    std::uint8_t next_sent = 0;
+    std::uint8_t next_received = 0;
+    std::size_t packets_received = 0;
+    std::size_t rounds_acknowledged = 0;
+
+    auto send_round = [&]
+    {
+        for (std::size_t i = 0; i < PACKETS_PER_ROUND; ++i)
+        {
+            std::vector<std::uint8_t> packet(PACKET_SIZE, next_sent++);
+            a->send_data(1, boost::asio::buffer(packet));
+        }
+    };
+
+    b->on_data_received.connect([&](unsigned signo, const std::uint8_t *data, std::size_t size)
+    {
+        EXPECT_EQ(signo, 1);
+        ASSERT_EQ(size, PACKET_SIZE);
+        EXPECT_EQ(data[0], next_received);
+        EXPECT_EQ(data[size - 1], next_received);
+        ++next_received;
+
+        if (++packets_received % PACKETS_PER_ROUND == 0)
+        {
+            std::uint8_t ack = 0;
+            b->send_data(2, boost::asio::buffer(&ack, 1));
+        }
+    });
+
+    a->on_data_received.connect([&](unsigned signo, const std::uint8_t *, std::size_t)
+    {
+        EXPECT_EQ(signo, 2);
+        if (++rounds_acknowledged < ROUNDS)
+            send_round();
+        else
+        {
+            a->stop();
+            b->stop();
+        }
+    });
+
+    a->enable_shared_memory();
+    b->enable_shared_memory();
+    a->run();
+    b->run();
+    a->offer_shared_memory();
+    if (GetParam())
+        b->offer_shared_memory();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!a->is_using_shared_memory() || (GetParam() && !b->is_using_shared_memory()))
+        ASSERT_TRUE(ioc.run_one_until(deadline));
+
+    EXPECT_EQ(b->is_using_shared_memory(), GetParam());
+
+    send_round();
+    ioc.run_until(deadline);
+
+    EXPECT_EQ(rounds_acknowledged, ROUNDS);
+    EXPECT_EQ(packets_received, ROUNDS * PACKETS_PER_ROUND);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    BothDirections,
+    SharedMemoryPeerTest,
+    Values(true, false));
+
+TEST(SharedMemoryOfferTest, IgnoredUnlessEnabled)
+{
+    boost::asio::io_context ioc;
+    boost::asio::local::stream_protocol::socket socket_a{ioc};
+    boost::asio::local::stream_protocol::socket socket_b{ioc};
+    boost::asio::local::connect_pair(socket_a, socket_b);
+
+    auto a = std::make_shared<peer>(std::move(socket_a), false, false, 64 * 1024, 4096);
+    auto b = std::make_shared<peer>(std::move(socket_b), true, false, 64 * 1024, 4096);
+
+    // Peer b has not advertised the capability, so it must not open the offered segment.
+    a->enable_shared_memory();
+    a->run();
+    b->run();
+    a->offer_shared_memory();
+
+    ioc.run_for(std::chrono::milliseconds(100));
+
+    EXPECT_FALSE(a->is_using_shared_memory());
+
+    a->stop();
+    b->stop();
+    ioc.run_for(std::chrono::milliseconds(10));
+}
+
+TEST(SharedMemoryOfferTest, RejectsFramesLargerThanReceiveBuffer)
+{
+    boost::asio::io_context ioc;
+    boost::asio::local::stream_protocol::socket socket_a{ioc};
+    boost::asio::local::stream_protocol::socket socket_b{ioc};
+    boost::asio::local::connect_pair(socket_a, socket_b);
+
+    // Peer a's ring is sized like its own, larger, receive buffer, so it can hold a frame that
+    // peer b would reject if it arrived through the socket.
+    auto a = std::make_shared<peer>(std::move(socket_a), false, false, 64 * 1024, 64 * 1024);
+    auto b = std::make_shared<peer>(std::move(socket_b), true, false, 4096, 64 * 1024);
+
+    boost::system::error_code closed_ec;
+    b->on_closed.connect([&](const boost::system::error_code& ec) { closed_ec = ec; });
+
+    a->enable_shared_memory();
+    b->enable_shared_memory();
+    a->run();
+    b->run();
+    a->offer_shared_memory();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!a->is_using_shared_memory())
+        ASSERT_TRUE(ioc.run_one_until(deadline));
+
+    std::vector<std::uint8_t> packet(16 * 1024);
+    a->send_data(1, boost::asio::buffer(packet));
+
+    while (!closed_ec)
+        ASSERT_TRUE(ioc.run_one_until(deadline));
+
+    EXPECT_EQ(closed_ec, boost::asio::error::no_buffer_space);
+
+    a->stop();
+    b->stop();
+    ioc.run_for(std::chrono::milliseconds(10));
+}
+
+class SharedMemoryConnectionTest : public TestWithParam<bool>
+{
+};
+
+TEST_P(SharedMemoryConnectionTest, OffersOnlyWhenAdvertised)
+{
+    boost::asio::io_context ioc;
+    boost::asio::local::stream_protocol::socket server_socket{ioc};
+    boost::asio::local::stream_protocol::socket client_socket{ioc};
+    boost::asio::local::connect_pair(server_socket, client_socket);
+
+    auto connection = std::make_shared<wss::connection>(std::move(server_socket), false, true);
+    connection->run();
+
+    auto capabilities = nlohmann::json::array();
+    if (GetParam())
+        capabilities.push_back(streaming_protocol::SHARED_MEMORY_CAPABILITY);
+
+    raw_peer client{std::move(client_socket)};
+    ASSERT_FALSE(client.greet(ioc, capabilities).empty());
+
+    bool offered = false;
+    client.run_until(ioc, [&]
+    {
+        for (const auto& packet : client.packets)
+            if (!packet.signo && packet.type == streaming_protocol::packet_type::METADATA)
+                if (raw_peer::decode_metadata(packet)["method"] == "sharedMemoryOffer")
+                    offered = true;
+        return offered;
+    }, std::chrono::milliseconds(500));
+
+    // A peer that does not advertise the capability would ignore the offer, leaving the
+    // segment mapped for the lifetime of the connection, so none is made.
+    EXPECT_EQ(offered, GetParam());
+
+    connection->close();
+    ioc.run_for(std::chrono::milliseconds(10));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    WithAndWithoutCapability,
+    SharedMemoryConnectionTest,
+    Values(true, false));
+
+#endif
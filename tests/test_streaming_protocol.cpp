@@ -0,0 +1,506 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/endian/conversion.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/connection.hpp>
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/local_signal.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/detail/streaming_protocol.hpp>
+
+#include "raw_peer.hpp"
+
+using namespace testing;
+using namespace wss::detail;
+
+template <boost::endian::order Order>
+static void test_round_trip(unsigned signo, unsigned type, std::size_t payload_size)
+{
+    std::array<std::uint8_t, streaming_protocol::MAX_HEADER_SIZE> header { };
+
+    std::size_t header_size = streaming_protocol::generate_header<Order>(
+        header.data(), signo, type, payload_size);
+
+    // Without the payload, the packet is truncated.
+    auto truncated = streaming_protocol::decode_header<Order>(header.data(), header_size);
+    if (payload_size)
+    {
+        EXPECT_EQ(truncated.header_size, 0u);
+    }
+
+    auto decoded = streaming_protocol::decode_header<Order>(header.data(), header_size + payload_size);
+    EXPECT_EQ(decoded.header_size, header_size);
+    EXPECT_EQ(decoded.signo, signo);
+    EXPECT_EQ(decoded.type, type);
+    EXPECT_EQ(decoded.payload_size, payload_size);
+}
+
+TEST(StreamingProtocolTest, RoundTripLittleEndian)
+{
+    test_round_trip<boost::endian::order::little>(1, streaming_protocol::packet_type::DATA, 0);
+    test_round_trip<boost::endian::order::little>(0xFFFFF, streaming_protocol::packet_type::DATA, 255);
+    test_round_trip<boost::endian::order::little>(42, streaming_protocol::packet_type::METADATA, 256);
+    test_round_trip<boost::endian::order::little>(7, streaming_protocol::packet_type::DATA, 1000000);
+}
+
+TEST(StreamingProtocolTest, RoundTripBigEndian)
+{
+    test_round_trip<boost::endian::order::big>(1, streaming_protocol::packet_type::DATA, 0);
+    test_round_trip<boost::endian::order::big>(0xFFFFF, streaming_protocol::packet_type::DATA, 255);
+    test_round_trip<boost::endian::order::big>(42, streaming_protocol::packet_type::METADATA, 256);
+    test_round_trip<boost::endian::order::big>(7, streaming_protocol::packet_type::DATA, 1000000);
+}
+
+TEST(StreamingProtocolTest, DecodeKnownBytes)
+{
+    // signo 0x12345, 16-byte payload, data packet
+    const std::uint8_t little[] = { 0x45, 0x23, 0x01, 0x11 };
+    const std::uint8_t big[] = { 0x11, 0x01, 0x23, 0x45 };
+
+    std::array<std::uint8_t, 4 + 16> packet { };
+
+    std::copy(std::begin(little), std::end(little), packet.begin());
+    auto decoded = streaming_protocol::decode_header(packet.data(), packet.size(), false);
+    EXPECT_EQ(decoded.header_size, 4u);
+    EXPECT_EQ(decoded.signo, 0x12345u);
+    EXPECT_EQ(decoded.type, streaming_protocol::packet_type::DATA);
+    EXPECT_EQ(decoded.payload_size, 16u);
+
+    std::copy(std::begin(big), std::end(big), packet.begin());
+    decoded = streaming_protocol::decode_header(packet.data(), packet.size(), true);
+    EXPECT_EQ(decoded.header_size, 4u);
+    EXPECT_EQ(decoded.signo, 0x12345u);
+    EXPECT_EQ(decoded.type, streaming_protocol::packet_type::DATA);
+    EXPECT_EQ(decoded.payload_size, 16u);
+}
+
+TEST(StreamingProtocolTest, DecodeTruncated)
+{
+    std::array<std::uint8_t, streaming_protocol::MAX_HEADER_SIZE> header;
+
+    streaming_protocol::generate_header(header.data(), 1, streaming_protocol::packet_type::DATA, 1000);
+
+    for (std::size_t size = 0; size <= header.size(); ++size)
+        EXPECT_EQ(streaming_protocol::decode_header(header.data(), size).header_size, 0u);
+}
+
+TEST(StreamingProtocolTest, ScanPackets)
+{
+    constexpr auto order = boost::endian::order::little;
+    const std::size_t payload_sizes[] = { 0, 16, 300, 8 };
+
+    std::vector<std::uint8_t> stream;
+    for (std::size_t i = 0; i < std::size(payload_sizes); ++i)
+    {
+        std::array<std::uint8_t, streaming_protocol::MAX_HEADER_SIZE> header;
+        std::size_t header_size = streaming_protocol::generate_header<order>(
+            header.data(),
+            i + 1,
+            i == 2 ? streaming_protocol::packet_type::METADATA : streaming_protocol::packet_type::DATA,
+            payload_sizes[i]);
+        stream.insert(stream.end(), header.begin(), header.begin() + header_size);
+        stream.insert(stream.end(), payload_sizes[i], std::uint8_t(i));
+    }
+
+    std::array<streaming_protocol::packet_descriptor, 8> descriptors;
+
+    // Scanning stops after the metadata packet.
+    auto result = streaming_protocol::scan_packets<order>(
+        stream.data(), stream.size(), descriptors.data(), descriptors.size());
+    ASSERT_EQ(result.packet_count, 3u);
+    EXPECT_EQ(result.bytes_scanned, stream.size() - 4 - 8);
+
+    EXPECT_EQ(descriptors[0].signo, 1u);
+    EXPECT_EQ(descriptors[0].offset, 8u);
+    EXPECT_EQ(descriptors[0].payload_size, 0u);
+    EXPECT_EQ(descriptors[1].signo, 2u);
+    EXPECT_EQ(descriptors[1].offset, 12u);
+    EXPECT_EQ(descriptors[1].payload_size, 16u);
+    EXPECT_EQ(descriptors[2].signo, 3u);
+    EXPECT_EQ(descriptors[2].type, streaming_protocol::packet_type::METADATA);
+    EXPECT_EQ(descriptors[2].offset, 36u);
+    EXPECT_EQ(descriptors[2].payload_size, 300u);
+
+    // The remaining packet is found by a subsequent scan, but not if it is truncated.
+    result = streaming_protocol::scan_packets<order>(
+        stream.data() + 336, stream.size() - 336 - 1, descriptors.data(), descriptors.size());
+    EXPECT_EQ(result.packet_count, 0u);
+    EXPECT_EQ(result.bytes_scanned, 0u);
+
+    result = streaming_protocol::scan_packets<order>(
+        stream.data() + 336, stream.size() - 336, descriptors.data(), 1);
+    ASSERT_EQ(result.packet_count, 1u);
+    EXPECT_EQ(result.bytes_scanned, 12u);
+    EXPECT_EQ(descriptors[0].signo, 4u);
+    EXPECT_EQ(descriptors[0].offset, 4u);
+}
+
+TEST(StreamingProtocolTest, AggregateRoundTrip)
+{
+    constexpr auto order = boost::endian::order::big;
+
+    std::array<streaming_protocol::aggregate_entry, 3> entries {{
+        { 1, 2 },
+        { 0xFFFFF, 0 },
+        { 7, 3 },
+    }};
+
+    std::vector<std::uint8_t> payload(streaming_protocol::aggregate_table_size(entries.size()));
+    EXPECT_EQ(
+        streaming_protocol::generate_aggregate_table<order>(payload.data(), entries.data(), entries.size()),
+        payload.size());
+    payload.insert(payload.end(), { 10, 11, 20, 21, 22 });
+
+    std::vector<std::vector<std::uint8_t>> split;
+    std::vector<unsigned> signos;
+
+    auto handler = [&](unsigned signo, const std::uint8_t *data, std::size_t size)
+    {
+        signos.push_back(signo);
+        split.emplace_back(data, data + size);
+    };
+
+    ASSERT_TRUE(streaming_protocol::split_aggregate<order>(payload.data(), payload.size(), handler));
+
+    EXPECT_EQ(signos, (std::vector<unsigned>{ 1, 0xFFFFF, 7 }));
+    EXPECT_EQ(split, (std::vector<std::vector<std::uint8_t>>{ { 10, 11 }, { }, { 20, 21, 22 } }));
+
+    // Truncated or oversized payloads are rejected without invoking the handler.
+    signos.clear();
+    EXPECT_FALSE(streaming_protocol::split_aggregate<order>(payload.data(), payload.size() - 1, handler));
+    EXPECT_FALSE(streaming_protocol::split_aggregate<order>(payload.data(), 12, handler));
+    payload.push_back(0);
+    EXPECT_FALSE(streaming_protocol::split_aggregate<order>(payload.data(), payload.size(), handler));
+    EXPECT_TRUE(signos.empty());
+}
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+TEST(StreamingProtocolTest, JitteredDomainValuesAreCoalesced)
+{
+    constexpr std::size_t BLOCKS = 100;
+    constexpr std::size_t SAMPLES_PER_BLOCK = 10;
+    constexpr std::int64_t DELTA = 10;
+    constexpr std::int64_t JITTER[] = { 0, 3, -3, 1, -2, 2, -1 };
+
+    boost::asio::io_context ioc;
+    boost::asio::local::stream_protocol::socket server_socket{ioc};
+    boost::asio::local::stream_protocol::socket client_socket{ioc};
+    boost::asio::local::connect_pair(server_socket, client_socket);
+
+    wss::local_signal time{"/Time", wss::metadata_builder{"Time"}
+        .data_type(wss::data_types::int64_t)
+        .linear_rule(0, DELTA)
+        .table("/Time")
+        .build()};
+    wss::local_signal value{"/Value", wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::real64_t)
+        .table("/Time")
+        .build()};
+
+    // The tolerance equals the peak-to-peak jitter.
+    value.set_domain_tolerance(6);
+
+    auto connection = std::make_shared<wss::connection>(std::move(server_socket), false, true);
+    connection->add_local_signal(time);
+    connection->add_local_signal(value);
+    connection->run();
+
+    raw_peer client{std::move(client_socket)};
+    std::string stream_id = client.greet(ioc, nlohmann::json::array());
+    ASSERT_FALSE(stream_id.empty());
+
+    auto signos = client.subscribe(ioc, stream_id, { "/Time", "/Value" });
+    ASSERT_EQ(signos.size(), 2u);
+
+    client.packets.clear();
+
+    // Publish blocks with jittered domain values and one step change halfway through.
+    std::array<double, SAMPLES_PER_BLOCK> samples;
+
+    for (std::size_t block = 0; block < BLOCKS; ++block)
+    {
+        std::int64_t domain_value = static_cast<std::int64_t>(block * SAMPLES_PER_BLOCK) * DELTA
+            + JITTER[block % std::size(JITTER)]
+            + (block >= BLOCKS / 2 ? 1000 : 0);
+
+        samples.fill(static_cast<double>(block));
+        value.publish_data(domain_value, samples.size(), samples.data(), sizeof(samples));
+    }
+
+    ASSERT_TRUE(client.run_until(ioc, [&]
+    {
+        return std::count_if(client.packets.begin(), client.packets.end(),
+            [&](const auto& packet) { return packet.signo == signos["/Value"]; }) == BLOCKS;
+    }));
+
+    // Every block arrives, in order, and the domain is only resynchronized a bounded number of
+    // times, each time immediately before the block to which the new value applies.
+    std::size_t blocks = 0;
+    std::size_t resyncs = 0;
+
+    for (std::size_t i = 0; i < client.packets.size(); ++i)
+    {
+        const auto& packet = client.packets[i];
+        ASSERT_EQ(packet.type, streaming_protocol::packet_type::DATA);
+
+        if (packet.signo == signos["/Value"])
+        {
+            ASSERT_EQ(packet.payload.size(), sizeof(samples));
+            double first;
+            std::memcpy(&first, packet.payload.data(), sizeof(first));
+            EXPECT_EQ(first, static_cast<double>(blocks++));
+        }
+
+        else
+        {
+            ASSERT_EQ(packet.signo, signos["/Time"]);
+            ASSERT_EQ(packet.payload.size(), sizeof(streaming_protocol::linear_payload));
+            ASSERT_LT(i + 1, client.packets.size());
+            EXPECT_EQ(client.packets[i + 1].signo, signos["/Value"]);
+
+            streaming_protocol::linear_payload payload;
+            std::memcpy(&payload, packet.payload.data(), sizeof(payload));
+            EXPECT_EQ(payload.sample_index, static_cast<std::int64_t>(blocks * SAMPLES_PER_BLOCK));
+            ++resyncs;
+        }
+    }
+
+    EXPECT_EQ(blocks, BLOCKS);
+    EXPECT_GE(resyncs, 1u);
+    EXPECT_LE(resyncs, 2u);
+    EXPECT_EQ(value.domain_statistics().resyncs, resyncs);
+
+    connection->close();
+    ioc.run_for(std::chrono::milliseconds(10));
+}
+
+TEST(StreamingProtocolTest, DeadbandGapsResynchronizeDomain)
+{
+    constexpr std::int64_t DELTA = 10;
+
+    boost::asio::io_context ioc;
+    boost::asio::local::stream_protocol::socket server_socket{ioc};
+    boost::asio::local::stream_protocol::socket client_socket{ioc};
+    boost::asio::local::connect_pair(server_socket, client_socket);
+
+    wss::local_signal time{"/Time", wss::metadata_builder{"Time"}
+        .data_type(wss::data_types::int64_t)
+        .linear_rule(0, DELTA)
+        .table("/Time")
+        .build()};
+    wss::local_signal value{"/Value", wss::metadata_builder{"Value"}
+        .data_type(wss::data_types::real64_t)
+        .table("/Time")
+        .build()};
+
+    // The tolerance would hide a gap of two suppressed samples if it applied.
+    value.set_domain_tolerance(3 * DELTA);
+    value.set_deadband(0.5);
+
+    auto connection = std::make_shared<wss::connection>(std::move(server_socket), false, true);
+    connection->add_local_signal(time);
+    connection->add_local_signal(value);
+    connection->run();
+
+    raw_peer client{std::move(client_socket)};
+    std::string stream_id = client.greet(ioc, nlohmann::json::array());
+    ASSERT_FALSE(stream_id.empty());
+
+    auto signos = client.subscribe(ioc, stream_id, { "/Time", "/Value" });
+    ASSERT_EQ(signos.size(), 2u);
+
+    client.packets.clear();
+
+    // The second and third samples are suppressed.
+    double samples[] = { 0, 0, 0, 5 };
+    for (std::size_t i = 0; i < std::size(samples); ++i)
+        value.publish_data(static_cast<std::int64_t>(i) * DELTA, 1, &samples[i], sizeof(double));
+
+    ASSERT_TRUE(client.run_until(ioc, [&]
+    {
+        return std::count_if(client.packets.begin(), client.packets.end(),
+            [&](const auto& packet) { return packet.signo == signos["/Value"]; }) == 2;
+    }));
+
+    // The peer has received one sample, so the block after the gap is its second sample, and
+    // the domain is resynchronized to that block's domain value.
+    ASSERT_EQ(client.packets.size(), 3u);
+    EXPECT_EQ(client.packets[0].signo, signos["/Value"]);
+    ASSERT_EQ(client.packets[1].signo, signos["/Time"]);
+    EXPECT_EQ(client.packets[2].signo, signos["/Value"]);
+
+    streaming_protocol::linear_payload payload;
+    ASSERT_EQ(client.packets[1].payload.size(), sizeof(payload));
+    std::memcpy(&payload, client.packets[1].payload.data(), sizeof(payload));
+    EXPECT_EQ(payload.sample_index, 1);
+    EXPECT_EQ(payload.value, 3 * DELTA);
+
+    connection->close();
+    ioc.run_for(std::chrono::milliseconds(10));
+}
+
+class DomainLinkTest : public Test
+{
+    protected:
+
+        static constexpr std::int64_t DELTA = 10;
+
+        DomainLinkTest()
+            : time{"/Time", linear_time()}
+            , value{"/Value", wss::metadata_builder{"Value"}
+                .data_type(wss::data_types::real64_t)
+                .table("/Time")
+                .build()}
+        {
+            boost::asio::local::stream_protocol::socket server_socket{ioc};
+            boost::asio::local::stream_protocol::socket client_socket{ioc};
+            boost::asio::local::connect_pair(server_socket, client_socket);
+
+            connection = std::make_shared<wss::connection>(std::move(server_socket), false, true);
+            client = std::make_unique<raw_peer>(std::move(client_socket));
+        }
+
+        void TearDown() override
+        {
+            connection->close();
+            ioc.run_for(std::chrono::milliseconds(10));
+        }
+
+        static wss::metadata linear_time()
+        {
+            return wss::metadata_builder{"Time"}
+                .data_type(wss::data_types::int64_t)
+                .linear_rule(0, DELTA)
+                .table("/Time")
+                .build();
+        }
+
+        void start()
+        {
+            connection->run();
+
+            std::string stream_id = client->greet(ioc, nlohmann::json::array());
+            ASSERT_FALSE(stream_id.empty());
+
+            signos = client->subscribe(ioc, stream_id, { "/Time", "/Value" });
+            ASSERT_EQ(signos.size(), 2u);
+        }
+
+        /**
+         * Publishes a single sample of the value signal and waits until it arrives.
+         *
+         * @return The domain resynchronizations the peer received before it, if any.
+         */
+        std::vector<streaming_protocol::linear_payload> publish(std::int64_t domain_value)
+        {
+            client->packets.clear();
+
+            double sample = 0;
+            value.publish_data(domain_value, 1, &sample, sizeof(sample));
+
+            std::vector<streaming_protocol::linear_payload> resyncs;
+
+            bool received = client->run_until(ioc, [&]
+            {
+                return std::any_of(client->packets.begin(), client->packets.end(),
+                    [&](const auto& packet) { return packet.signo == signos["/Value"]; });
+            });
+            EXPECT_TRUE(received);
+
+            for (const auto& packet : client->packets)
+            {
+                if (packet.signo == signos["/Time"]
+                        && packet.type == streaming_protocol::packet_type::DATA
+                        && packet.payload.size() == sizeof(streaming_protocol::linear_payload))
+                {
+                    streaming_protocol::linear_payload payload;
+                    std::memcpy(&payload, packet.payload.data(), sizeof(payload));
+                    resyncs.push_back(payload);
+                }
+            }
+
+            return resyncs;
+        }
+
+        boost::asio::io_context ioc;
+        wss::local_signal time;
+        wss::local_signal value;
+        std::shared_ptr<wss::connection> connection;
+        std::unique_ptr<raw_peer> client;
+        std::map<std::string, unsigned> signos;
+};
+
+TEST_F(DomainLinkTest, RemovedDomainIsUnlinked)
+{
+    connection->add_local_signal(time);
+    connection->add_local_signal(value);
+    start();
+
+    EXPECT_TRUE(publish(0).empty());
+    EXPECT_EQ(publish(1000).size(), 1u);
+
+    // The value signal keeps publishing after its domain signal is gone, without referring to
+    // the removed domain signal's linear table.
+    connection->remove_local_signal(time);
+
+    EXPECT_TRUE(publish(5000).empty());
+    EXPECT_TRUE(publish(9000).empty());
+}
+
+TEST_F(DomainLinkTest, DomainRegisteredAfterValue)
+{
+    connection->add_local_signal(value);
+    connection->add_local_signal(time);
+    start();
+
+    EXPECT_TRUE(publish(0).empty());
+
+    auto resyncs = publish(1000);
+    ASSERT_EQ(resyncs.size(), 1u);
+    EXPECT_EQ(resyncs[0].sample_index, 1);
+    EXPECT_EQ(resyncs[0].value, 1000);
+}
+
+TEST_F(DomainLinkTest, DomainRuleChangedThroughMetadata)
+{
+    connection->add_local_signal(time);
+    connection->add_local_signal(value);
+    start();
+
+    EXPECT_TRUE(publish(0).empty());
+
+    // Without a linear rule the domain signal has no table to resynchronize.
+    time.set_metadata(wss::metadata_builder{"Time"}
+        .data_type(wss::data_types::int64_t)
+        .table("/Time")
+        .build());
+    EXPECT_TRUE(publish(1000).empty());
+
+    // A linear rule added again gets a new table, which the value signal uses at once.
+    time.set_metadata(linear_time());
+
+    auto resyncs = publish(5000);
+    ASSERT_EQ(resyncs.size(), 1u);
+    EXPECT_EQ(resyncs[0].sample_index, 2);
+    EXPECT_EQ(resyncs[0].value, 5000);
+
+    EXPECT_TRUE(publish(5000 + DELTA).empty());
+}
+
+#endif
@@ -0,0 +1,96 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/metadata.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/sample_traits.hpp>
+#include <ws-streaming/struct_layout.hpp>
+#include <ws-streaming/typed_local_signal.hpp>
+
+using namespace testing;
+
+#pragma pack(push, 1)
+struct layout_sample
+{
+    std::uint8_t flags;
+    std::uint32_t id;
+    std::array<std::int16_t, 3> values;
+    double value;
+};
+#pragma pack(pop)
+
+template <>
+struct wss::sample_traits<layout_sample>
+{
+    static constexpr auto fields = std::make_tuple(
+        wss::field("Flags", &layout_sample::flags),
+        wss::field("Id", &layout_sample::id),
+        wss::field("Values", &layout_sample::values),
+        wss::field("Value", &layout_sample::value));
+};
+
+TEST(StructLayoutTest, Fields)
+{
+    wss::typed_local_signal<layout_sample> signal{"/Struct", wss::metadata_builder{"Struct"}};
+    wss::struct_layout layout{signal.metadata()};
+
+    EXPECT_EQ(layout.sample_size(), sizeof(layout_sample));
+    ASSERT_EQ(layout.fields().size(), 4);
+
+    EXPECT_EQ(layout.fields()[1].name, "Id");
+    EXPECT_EQ(layout.fields()[1].data_type, wss::data_types::uint32_t);
+    EXPECT_EQ(layout.fields()[1].offset, offsetof(layout_sample, id));
+    EXPECT_EQ(layout.fields()[1].size, 4);
+
+    EXPECT_EQ(layout.fields()[2].element_size, 2);
+    EXPECT_EQ(layout.fields()[2].count, 3);
+    EXPECT_EQ(layout.fields()[2].offset, offsetof(layout_sample, values));
+    EXPECT_EQ(layout.fields()[3].offset, offsetof(layout_sample, value));
+
+    EXPECT_EQ(layout.find("Value"), 3);
+    EXPECT_EQ(layout.find("Missing"), std::nullopt);
+
+    EXPECT_EQ(wss::struct_layout{}.sample_size(), 0);
+    EXPECT_TRUE(wss::struct_layout{wss::metadata{wss::metadata_builder{"Value"}.build()}}.fields().empty());
+}
+
+TEST(StructLayoutTest, ExtractColumns)
+{
+    wss::typed_local_signal<layout_sample> signal{"/Struct", wss::metadata_builder{"Struct"}};
+    wss::struct_layout layout{signal.metadata()};
+
+    // Use enough samples to span several of extract_columns()' internal blocks.
+    std::vector<layout_sample> samples(5000);
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i].flags = static_cast<std::uint8_t>(i);
+        samples[i].id = static_cast<std::uint32_t>(i * 7);
+        samples[i].values = { std::int16_t(i), std::int16_t(-i), std::int16_t(i * 3) };
+        samples[i].value = i * 0.5;
+    }
+
+    std::vector<std::uint8_t> flags(samples.size());
+    std::vector<std::array<std::int16_t, 3>> values(samples.size());
+    std::vector<double> value(samples.size());
+    void *columns[] = { flags.data(), nullptr, values.data(), value.data() };
+
+    layout.extract_columns(samples.data(), samples.size(), columns);
+
+    std::vector<std::uint32_t> ids(samples.size());
+    layout.extract(1, samples.data(), samples.size(), ids.data());
+
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+        ASSERT_EQ(flags[i], samples[i].flags);
+        ASSERT_EQ(ids[i], samples[i].id);
+        ASSERT_EQ(values[i], samples[i].values);
+        ASSERT_EQ(value[i], samples[i].value);
+    }
+}
@@ -0,0 +1,93 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/detail/transmit_arena.hpp>
+
+using namespace testing;
+using namespace wss::detail;
+
+TEST(TransmitArenaTest, AllocationsAreAlignedAndDisjoint)
+{
+    transmit_arena arena{1024};
+
+    auto a = arena.allocate(10);
+    auto b = arena.allocate(100);
+
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.get()) % transmit_arena::ALIGNMENT, 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b.get()) % transmit_arena::ALIGNMENT, 0);
+    EXPECT_GE(b.get(), a.get() + 10);
+}
+
+TEST(TransmitArenaTest, SlabsAreReusedWhenReleased)
+{
+    transmit_arena arena{1024};
+
+    auto a = arena.allocate(1000);
+    const std::uint8_t *first_slab = a.get();
+
+    // The first slab is still referenced, so a second one is needed.
+    auto b = arena.allocate(1000);
+    EXPECT_NE(b.get(), first_slab);
+
+    // Once released, the first slab is reused.
+    a.reset();
+    auto c = arena.allocate(1000);
+    EXPECT_EQ(c.get(), first_slab);
+}
+
+TEST(TransmitArenaTest, TrimReturnsUnusedMemory)
+{
+    transmit_arena arena{1024};
+
+    auto a = arena.allocate(512);
+    arena.trim(a.get(), 512, 16);
+
+    auto b = arena.allocate(16);
+    EXPECT_EQ(b.get(), a.get() + 16);
+
+    // Trimming an allocation that is no longer the most recent has no effect.
+    arena.trim(a.get(), 16, 0);
+    auto c = arena.allocate(16);
+    EXPECT_EQ(c.get(), b.get() + 16);
+}
+
+TEST(TransmitArenaTest, LargeAllocations)
+{
+    transmit_arena arena{1024};
+
+    auto a = arena.allocate(4096);
+    ASSERT_TRUE(a);
+    a.get()[4095] = 1;
+}
+
+TEST(TransmitArenaTest, SlabsReleasedOnOtherThreadsAreReused)
+{
+    transmit_arena arena{1024};
+
+    auto a = arena.allocate(1000);
+    const std::uint8_t *first_slab = a.get();
+    auto b = arena.allocate(1000);
+
+    std::thread{[a = std::move(a)]() mutable { a.reset(); }}.join();
+
+    auto c = arena.allocate(1000);
+    EXPECT_EQ(c.get(), first_slab);
+}
+
+TEST(TransmitArenaTest, AllocationsOutliveArena)
+{
+    std::shared_ptr<std::uint8_t> a;
+
+    {
+        transmit_arena arena{1024};
+        a = arena.allocate(1000);
+        arena.allocate(1000);
+    }
+
+    a.get()[999] = 1;
+    EXPECT_EQ(a.get()[999], 1);
+}
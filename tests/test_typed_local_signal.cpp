@@ -0,0 +1,138 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/data_types.hpp>
+#include <ws-streaming/metadata_builder.hpp>
+#include <ws-streaming/sample_traits.hpp>
+#include <ws-streaming/typed_local_signal.hpp>
+
+using namespace testing;
+
+#pragma pack(push, 1)
+struct test_sample
+{
+    std::int32_t id;
+    std::array<float, 3> values;
+    std::uint8_t flags;
+};
+#pragma pack(pop)
+
+template <>
+struct wss::sample_traits<test_sample>
+{
+    static constexpr auto fields = std::make_tuple(
+        wss::field("Id", &test_sample::id),
+        wss::field("Values", &test_sample::values),
+        wss::field("Flags", &test_sample::flags));
+};
+
+struct misordered_sample
+{
+    std::int32_t first;
+    std::int32_t second;
+};
+
+template <>
+struct wss::sample_traits<misordered_sample>
+{
+    static constexpr auto fields = std::make_tuple(
+        wss::field("Second", &misordered_sample::second),
+        wss::field("First", &misordered_sample::first));
+};
+
+struct duplicated_sample
+{
+    std::int32_t first;
+    std::int32_t second;
+};
+
+template <>
+struct wss::sample_traits<duplicated_sample>
+{
+    static constexpr auto fields = std::make_tuple(
+        wss::field("First", &duplicated_sample::first),
+        wss::field("First", &duplicated_sample::first));
+};
+
+TEST(TypedLocalSignalTest, ArithmeticMetadata)
+{
+    wss::typed_local_signal<double> signal{"/Value", wss::metadata_builder{"Value"}};
+
+    EXPECT_EQ(signal.metadata().data_type(), wss::data_types::real64_t);
+    EXPECT_EQ(signal.metadata().sample_size(), sizeof(double));
+
+    EXPECT_STREQ(wss::sample_traits<std::int8_t>::data_type, wss::data_types::int8_t);
+    EXPECT_STREQ(wss::sample_traits<std::uint16_t>::data_type, wss::data_types::uint16_t);
+    EXPECT_STREQ(wss::sample_traits<std::int64_t>::data_type, wss::data_types::int64_t);
+    EXPECT_STREQ(wss::sample_traits<float>::data_type, wss::data_types::real32_t);
+}
+
+TEST(TypedLocalSignalTest, StructMetadata)
+{
+    wss::typed_local_signal<test_sample> signal{"/Struct", wss::metadata_builder{"Struct"}};
+
+    EXPECT_EQ(signal.metadata().data_type(), wss::data_types::struct_t);
+    EXPECT_EQ(signal.metadata().sample_size(), sizeof(test_sample));
+
+    const auto& fields = signal.metadata().json()["definition"]["struct"];
+    ASSERT_EQ(fields.size(), 3);
+    EXPECT_EQ(fields[0]["name"], "Id");
+    EXPECT_EQ(fields[0]["dataType"], wss::data_types::int32_t);
+    EXPECT_EQ(fields[1]["name"], "Values");
+    EXPECT_EQ(fields[1]["dataType"], wss::data_types::real32_t);
+    EXPECT_EQ(fields[2]["name"], "Flags");
+    EXPECT_EQ(fields[2]["dataType"], wss::data_types::uint8_t);
+}
+
+TEST(TypedLocalSignalTest, RejectsMisorderedFields)
+{
+    // Both structures have the right total size, so only the field offsets reveal the mistake.
+    EXPECT_THROW(
+        (wss::typed_local_signal<misordered_sample>{"/Struct", wss::metadata_builder{"Struct"}}),
+        std::invalid_argument);
+
+    EXPECT_THROW(
+        (wss::typed_local_signal<duplicated_sample>{"/Struct", wss::metadata_builder{"Struct"}}),
+        std::invalid_argument);
+}
+
+TEST(TypedLocalSignalTest, PublishSamples)
+{
+    wss::typed_local_signal<std::int16_t> signal{"/Value", wss::metadata_builder{"Value"}};
+
+    std::vector<std::tuple<std::int64_t, std::size_t, const void *, std::size_t>> published;
+    signal.on_data_published.connect(
+        [&](
+            std::int64_t domain_value,
+            std::size_t sample_count,
+            const boost::asio::const_buffer *buffers,
+            std::size_t buffer_count,
+            const std::shared_ptr<const void>& owner)
+        {
+            ASSERT_EQ(buffer_count, 1);
+            published.emplace_back(domain_value, sample_count, buffers->data(), buffers->size());
+        });
+
+    std::vector<std::int16_t> samples(10);
+    std::array<std::int16_t, 4> more { };
+
+    signal.publish_data(samples[0]);
+    signal.publish_data(samples.data(), 5);
+    signal.publish_data(samples);
+    signal.publish_data(1000, more);
+
+    ASSERT_EQ(published.size(), 4);
+    EXPECT_EQ(published[0], std::make_tuple(0, 0, &samples[0], 2));
+    EXPECT_EQ(published[1], std::make_tuple(0, 0, samples.data(), 10));
+    EXPECT_EQ(published[2], std::make_tuple(0, 0, samples.data(), 20));
+    EXPECT_EQ(published[3], std::make_tuple(1000, 4, more.data(), 8));
+}
@@ -0,0 +1,280 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <gtest/gtest.h>
+
+#include <ws-streaming/detail/deflate_pool.hpp>
+#include <ws-streaming/detail/peer.hpp>
+#include <ws-streaming/detail/websocket_extensions.hpp>
+#include <ws-streaming/detail/websocket_protocol.hpp>
+
+using namespace testing;
+using namespace wss::detail;
+
+TEST(WebSocketExtensionsTest, Offer)
+{
+    EXPECT_EQ(websocket_extensions{}.offer(), "");
+    EXPECT_EQ(websocket_extensions{true}.offer(), "x-wss-lz4");
+}
+
+TEST(WebSocketExtensionsTest, Negotiate)
+{
+    std::string response;
+
+    auto agreed = websocket_extensions::negotiate("permessage-deflate, x-wss-lz4", websocket_extensions{true}, response);
+    EXPECT_TRUE(agreed.block_compression);
+    EXPECT_EQ(response, "x-wss-lz4");
+
+    agreed = websocket_extensions::negotiate("x-wss-lz4", websocket_extensions{false}, response);
+    EXPECT_FALSE(agreed.block_compression);
+    EXPECT_EQ(response, "");
+
+    agreed = websocket_extensions::negotiate("x-wss-lz4; level=9", websocket_extensions{true}, response);
+    EXPECT_FALSE(agreed.block_compression);
+    EXPECT_EQ(response, "");
+}
+
+TEST(WebSocketExtensionsTest, Accept)
+{
+    auto agreed = websocket_extensions::accept("x-wss-lz4", websocket_extensions{true});
+    ASSERT_TRUE(agreed.has_value());
+    EXPECT_TRUE(agreed->block_compression);
+
+    agreed = websocket_extensions::accept("", websocket_extensions{true});
+    ASSERT_TRUE(agreed.has_value());
+    EXPECT_FALSE(agreed->block_compression);
+
+    // The server must not accept extensions that were not offered.
+    EXPECT_FALSE(websocket_extensions::accept("x-wss-lz4", websocket_extensions{false}).has_value());
+    EXPECT_FALSE(websocket_extensions::accept("permessage-deflate", websocket_extensions{true}).has_value());
+}
+
+TEST(WebSocketExtensionsTest, OfferDeflate)
+{
+    websocket_extensions offered;
+    offered.block_compression = true;
+    offered.permessage_deflate = true;
+    EXPECT_EQ(offered.offer(), "x-wss-lz4, permessage-deflate; client_max_window_bits");
+
+    offered.block_compression = false;
+    offered.server_no_context_takeover = true;
+    offered.client_max_window_bits = 10;
+    EXPECT_EQ(offered.offer(), "permessage-deflate; server_no_context_takeover; client_max_window_bits=10");
+}
+
+TEST(WebSocketExtensionsTest, NegotiateDeflate)
+{
+    websocket_extensions supported;
+    supported.permessage_deflate = true;
+    std::string response;
+
+    // The offer made by common browsers.
+    auto agreed = websocket_extensions::negotiate("permessage-deflate; client_max_window_bits", supported, response);
+    EXPECT_TRUE(agreed.permessage_deflate);
+    EXPECT_FALSE(agreed.server_no_context_takeover);
+    EXPECT_FALSE(agreed.client_no_context_takeover);
+    EXPECT_EQ(agreed.server_max_window_bits, 15u);
+    EXPECT_EQ(agreed.client_max_window_bits, 15u);
+    EXPECT_EQ(response, "permessage-deflate");
+
+    // Servers may disable context takeover for themselves, and must acknowledge window limits.
+    supported.server_no_context_takeover = true;
+    agreed = websocket_extensions::negotiate("permessage-deflate; server_max_window_bits=\"10\"", supported, response);
+    EXPECT_TRUE(agreed.permessage_deflate);
+    EXPECT_TRUE(agreed.server_no_context_takeover);
+    EXPECT_EQ(agreed.server_max_window_bits, 10u);
+    EXPECT_EQ(response, "permessage-deflate; server_no_context_takeover; server_max_window_bits=10");
+
+    // Offers we cannot satisfy or do not understand are declined in favor of later ones.
+    agreed = websocket_extensions::negotiate(
+        "permessage-deflate; server_max_window_bits=8, "
+            "permessage-deflate; server_max_window_bits=16, "
+            "permessage-deflate; client_no_context_takeover; client_no_context_takeover, "
+            "permessage-deflate; mystery, "
+            "permessage-deflate; client_no_context_takeover",
+        supported,
+        response);
+    EXPECT_TRUE(agreed.permessage_deflate);
+    EXPECT_TRUE(agreed.client_no_context_takeover);
+    EXPECT_EQ(response, "permessage-deflate; server_no_context_takeover; client_no_context_takeover");
+
+    agreed = websocket_extensions::negotiate("permessage-deflate; server_max_window_bits=8", supported, response);
+    EXPECT_FALSE(agreed.permessage_deflate);
+    EXPECT_EQ(response, "");
+}
+
+TEST(WebSocketExtensionsTest, AcceptDeflate)
+{
+    websocket_extensions offered;
+    offered.permessage_deflate = true;
+    offered.client_no_context_takeover = true;
+
+    auto agreed = websocket_extensions::accept("permessage-deflate; server_no_context_takeover; client_max_window_bits=9", offered);
+    ASSERT_TRUE(agreed.has_value());
+    EXPECT_TRUE(agreed->permessage_deflate);
+    EXPECT_TRUE(agreed->server_no_context_takeover);
+    EXPECT_TRUE(agreed->client_no_context_takeover);
+    EXPECT_EQ(agreed->client_max_window_bits, 9u);
+
+    // The server must not exceed a window limit we asked for, or accept twice.
+    offered.server_max_window_bits = 10;
+    EXPECT_FALSE(websocket_extensions::accept("permessage-deflate; server_max_window_bits=12", offered).has_value());
+    EXPECT_FALSE(websocket_extensions::accept("permessage-deflate, permessage-deflate", offered).has_value());
+    EXPECT_FALSE(websocket_extensions::accept("permessage-deflate; mystery", offered).has_value());
+}
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+// A server peer transmits through a raw socket, so that each frame can be inspected before it is
+// forwarded to a client peer through another.
+class PermessageDeflateTest : public Test
+{
+    protected:
+
+        static constexpr std::size_t RX_BUFFER_SIZE = 64 * 1024;
+
+        PermessageDeflateTest()
+        {
+            boost::asio::local::stream_protocol::socket server_socket{ioc};
+            boost::asio::local::stream_protocol::socket client_socket{ioc};
+            boost::asio::local::connect_pair(server_socket, server_raw);
+            boost::asio::local::connect_pair(client_raw, client_socket);
+
+            auto pool = std::make_shared<deflate_pool>(2);
+
+            server = std::make_shared<peer>(std::move(server_socket), false, false, RX_BUFFER_SIZE);
+            client = std::make_shared<peer>(std::move(client_socket), true, false, RX_BUFFER_SIZE);
+            server->enable_permessage_deflate(websocket_extensions::MAX_WINDOW_BITS, true, pool);
+            client->enable_permessage_deflate(websocket_extensions::MAX_WINDOW_BITS, true, pool);
+
+            client->on_data_received.connect([this](unsigned signo, const std::uint8_t *data, std::size_t size)
+            {
+                EXPECT_EQ(signo, 1);
+                received.assign(data, data + size);
+            });
+
+            client->on_closed.connect([this](const boost::system::error_code& ec)
+            {
+                closed = true;
+                close_ec = ec;
+            });
+
+            server->run();
+            client->run();
+        }
+
+        ~PermessageDeflateTest()
+        {
+            server->stop();
+            client->stop();
+            ioc.run_for(std::chrono::milliseconds(10));
+        }
+
+        static std::vector<std::uint8_t> compressible(std::size_t size)
+        {
+            std::vector<std::uint8_t> data(size);
+            for (std::size_t i = 0; i < size; ++i)
+                data[i] = static_cast<std::uint8_t>(i % 251);
+            return data;
+        }
+
+        // Reads the first complete frame the server transmits.
+        std::vector<std::uint8_t> capture_frame()
+        {
+            std::vector<std::uint8_t> frame;
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+            while (std::chrono::steady_clock::now() < deadline)
+            {
+                ioc.run_for(std::chrono::milliseconds(1));
+
+                if (std::size_t available = server_raw.available())
+                {
+                    std::size_t old_size = frame.size();
+                    frame.resize(old_size + available);
+                    server_raw.read_some(boost::asio::buffer(frame.data() + old_size, available));
+                }
+
+                auto header = websocket_protocol::decode_header(frame.data(), frame.size());
+                if (header.header_size)
+                {
+                    frame.resize(header.header_size + header.payload_size);
+                    return frame;
+                }
+            }
+
+            return {};
+        }
+
+        template <typename Predicate>
+        bool run_until(Predicate&& predicate)
+        {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+            while (!predicate())
+                if (!ioc.run_one_until(deadline))
+                    return false;
+
+            return true;
+        }
+
+        boost::asio::io_context ioc;
+        boost::asio::local::stream_protocol::socket server_raw{ioc};
+        boost::asio::local::stream_protocol::socket client_raw{ioc};
+        std::shared_ptr<peer> server;
+        std::shared_ptr<peer> client;
+        std::vector<std::uint8_t> received;
+        bool closed = false;
+        boost::system::error_code close_ec;
+};
+
+TEST_F(PermessageDeflateTest, RoundTrip)
+{
+    auto message = compressible(RX_BUFFER_SIZE / 2);
+    server->send_data(1, boost::asio::buffer(message));
+
+    auto frame = capture_frame();
+    auto header = websocket_protocol::decode_header(frame.data(), frame.size());
+    ASSERT_NE(header.header_size, 0);
+    EXPECT_EQ(header.opcode, websocket_protocol::opcodes::BINARY);
+    EXPECT_TRUE(header.flags & websocket_protocol::flags::RSV1);
+    EXPECT_LT(header.payload_size, message.size() / 10);
+
+    boost::asio::write(client_raw, boost::asio::buffer(frame));
+
+    ASSERT_TRUE(run_until([&] { return !received.empty() || closed; }));
+    EXPECT_EQ(received, message);
+    EXPECT_FALSE(closed);
+}
+
+TEST_F(PermessageDeflateTest, RejectsMessageInflatingBeyondReceiveBuffer)
+{
+    // The compressed frame fits in the receive buffer, but the message it inflates to does not.
+    auto message = compressible(4 * RX_BUFFER_SIZE);
+    server->send_data(1, boost::asio::buffer(message));
+
+    auto frame = capture_frame();
+    auto header = websocket_protocol::decode_header(frame.data(), frame.size());
+    ASSERT_NE(header.header_size, 0);
+    EXPECT_TRUE(header.flags & websocket_protocol::flags::RSV1);
+    EXPECT_LT(frame.size(), RX_BUFFER_SIZE);
+
+    boost::asio::write(client_raw, boost::asio::buffer(frame));
+
+    ASSERT_TRUE(run_until([&] { return closed; }));
+    EXPECT_EQ(close_ec, boost::asio::error::invalid_argument);
+    EXPECT_TRUE(received.empty());
+}
+
+#endif